@@ -0,0 +1,56 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+/**
+ * Allocator for the containers whose data is handed to SIMD or FFT code. The
+ * default alignment covers a cache line and the widest vector registers.
+ */
+template <typename T, std::size_t Alignment = 64U>
+class AlignedAllocator {
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {}  // NOLINT(google-explicit-constructor)
+
+  auto allocate(const std::size_t& n) -> T* {
+    return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T* p, [[maybe_unused]] const std::size_t& n) noexcept {
+    ::operator delete(p, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  auto operator==(const AlignedAllocator<U, Alignment>& /*other*/) const noexcept -> bool {
+    return true;
+  }
+};
@@ -0,0 +1,210 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "async_processor.hpp"
+#include <pthread.h>
+#include <sys/types.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include "util.hpp"
+
+void AsyncProcessor::BlockQueue::resize(const uint& block, const uint& n_blocks) {
+  block_size = block;
+  capacity = n_blocks;
+
+  left.assign(static_cast<size_t>(block_size) * capacity, 0.0F);
+  right.assign(static_cast<size_t>(block_size) * capacity, 0.0F);
+
+  read_count.store(0U);
+  write_count.store(0U);
+}
+
+auto AsyncProcessor::BlockQueue::available() const -> uint {
+  return static_cast<uint>(write_count.load(std::memory_order_acquire) - read_count.load(std::memory_order_acquire));
+}
+
+auto AsyncProcessor::BlockQueue::left_slot(const uint64_t& count) -> std::span<float> {
+  return std::span(left).subspan((count % capacity) * block_size, block_size);
+}
+
+auto AsyncProcessor::BlockQueue::right_slot(const uint64_t& count) -> std::span<float> {
+  return std::span(right).subspan((count % capacity) * block_size, block_size);
+}
+
+AsyncProcessor::AsyncProcessor(std::string name) : name(std::move(name)) {}
+
+AsyncProcessor::~AsyncProcessor() {
+  stop();
+}
+
+void AsyncProcessor::start(const uint& block_size, const uint& latency_blocks, Backend callback) {
+  stop();
+
+  this->block_size = block_size;
+
+  latency_n_blocks = std::max(latency_blocks, 1U);
+
+  missing_blocks = 0U;
+  dropped_blocks = 0U;
+
+  backend = std::move(callback);
+
+  /**
+   * When the backend is fast the next block to be played may already be
+   * followed by the one that was just queued. One more slot keeps the thread
+   * from stalling in that case.
+   */
+  input.resize(block_size, latency_n_blocks + 2U);
+  output.resize(block_size, latency_n_blocks + 2U);
+
+  // The silence played while the first blocks go through the backend.
+  output.write_count.store(latency_n_blocks);
+
+  quit.store(false);
+
+  thread = std::thread([this] { work(); });
+
+  const auto thread_name = name.substr(0U, 15U);
+
+  pthread_setname_np(thread.native_handle(), thread_name.c_str());
+
+  is_running.store(true);
+
+  util::debug(std::format("{}: processing in a separate thread with {} frames of added latency", name,
+                          latency_frames()));
+}
+
+void AsyncProcessor::stop() {
+  if (!thread.joinable()) {
+    return;
+  }
+
+  is_running.store(false);
+
+  quit.store(true);
+
+  wakeup.release();
+
+  thread.join();
+
+  util::debug(std::format("{}: separate processing thread stopped", name));
+}
+
+auto AsyncProcessor::running() const -> bool {
+  return is_running.load();
+}
+
+auto AsyncProcessor::latency_frames() const -> uint {
+  return running() ? block_size * latency_n_blocks : 0U;
+}
+
+auto AsyncProcessor::pause() -> std::unique_lock<std::mutex> {
+  return std::unique_lock<std::mutex>(backend_mutex);
+}
+
+auto AsyncProcessor::try_pause() -> std::unique_lock<std::mutex> {
+  return {backend_mutex, std::try_to_lock};
+}
+
+void AsyncProcessor::process(std::span<const float> left_in,
+                             std::span<const float> right_in,
+                             std::span<float> left_out,
+                             std::span<float> right_out) {
+  if (left_in.size() != block_size || right_in.size() != block_size) {
+    // The owner restarts us with the new quantum
+    std::ranges::fill(left_out, 0.0F);
+    std::ranges::fill(right_out, 0.0F);
+
+    return;
+  }
+
+  if (input.available() < input.capacity) {
+    const auto count = input.write_count.load(std::memory_order_relaxed);
+
+    std::ranges::copy(left_in, input.left_slot(count).begin());
+    std::ranges::copy(right_in, input.right_slot(count).begin());
+
+    input.write_count.store(count + 1U, std::memory_order_release);
+
+    wakeup.release();
+  } else {
+    // The output of this block will never arrive. Silence takes its place.
+    dropped_blocks++;
+  }
+
+  if (dropped_blocks > 0U) {
+    dropped_blocks--;
+
+    std::ranges::fill(left_out, 0.0F);
+    std::ranges::fill(right_out, 0.0F);
+
+    return;
+  }
+
+  // Blocks that arrived after their turn are discarded so the delay stays fixed.
+  while (missing_blocks > 0U && output.available() > 1U) {
+    output.read_count.store(output.read_count.load(std::memory_order_relaxed) + 1U, std::memory_order_release);
+
+    missing_blocks--;
+  }
+
+  if (output.available() == 0U) {
+    missing_blocks++;
+
+    std::ranges::fill(left_out, 0.0F);
+    std::ranges::fill(right_out, 0.0F);
+
+    return;
+  }
+
+  const auto count = output.read_count.load(std::memory_order_relaxed);
+
+  std::ranges::copy(output.left_slot(count), left_out.begin());
+  std::ranges::copy(output.right_slot(count), right_out.begin());
+
+  output.read_count.store(count + 1U, std::memory_order_release);
+}
+
+void AsyncProcessor::work() {
+  while (!quit.load()) {
+    static_cast<void>(wakeup.try_acquire_for(std::chrono::milliseconds(100)));
+
+    while (!quit.load() && input.available() > 0U && output.available() < output.capacity) {
+      const auto in_count = input.read_count.load(std::memory_order_relaxed);
+      const auto out_count = output.write_count.load(std::memory_order_relaxed);
+
+      {
+        std::scoped_lock<std::mutex> lock(backend_mutex);
+
+        backend(input.left_slot(in_count), input.right_slot(in_count), output.left_slot(out_count),
+                output.right_slot(out_count));
+      }
+
+      input.read_count.store(in_count + 1U, std::memory_order_release);
+      output.write_count.store(out_count + 1U, std::memory_order_release);
+    }
+  }
+}
@@ -0,0 +1,121 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <semaphore>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Runs an expensive stereo backend, like a neural network denoiser, in its own
+ * thread instead of the PipeWire realtime one. Each block given to process() is
+ * queued for the backend and the block it finished `latency_blocks` calls ago
+ * is returned. The realtime side never waits for the backend: when it falls
+ * behind silence is returned and a later block is dropped to bring the delay
+ * back to the reported value.
+ */
+class AsyncProcessor {
+ public:
+  using Backend = std::function<
+      void(std::span<float> left_in, std::span<float> right_in, std::span<float> left_out, std::span<float> right_out)>;
+
+  explicit AsyncProcessor(std::string name);
+  AsyncProcessor(const AsyncProcessor&) = delete;
+  auto operator=(const AsyncProcessor&) -> AsyncProcessor& = delete;
+  AsyncProcessor(const AsyncProcessor&&) = delete;
+  auto operator=(const AsyncProcessor&&) -> AsyncProcessor& = delete;
+  ~AsyncProcessor();
+
+  // Not realtime safe. Must not run concurrently with process().
+  void start(const uint& block_size, const uint& latency_blocks, Backend callback);
+
+  // Not realtime safe. Must not run concurrently with process().
+  void stop();
+
+  [[nodiscard]] auto running() const -> bool;
+
+  [[nodiscard]] auto latency_frames() const -> uint;
+
+  /**
+   * The backend is not called while the returned lock is held. Owners take it
+   * before changing the state the backend uses and when they call the backend
+   * themselves.
+   */
+  [[nodiscard]] auto pause() -> std::unique_lock<std::mutex>;
+
+  // Realtime safe version of pause(). The lock is not owned while someone else holds it.
+  [[nodiscard]] auto try_pause() -> std::unique_lock<std::mutex>;
+
+  // Realtime safe
+  void process(std::span<const float> left_in,
+               std::span<const float> right_in,
+               std::span<float> left_out,
+               std::span<float> right_out);
+
+ private:
+  // Single producer and single consumer queue of stereo blocks.
+  struct BlockQueue {
+    uint block_size = 0U;
+    uint capacity = 0U;
+
+    std::vector<float> left, right;
+
+    std::atomic<uint64_t> read_count = 0U, write_count = 0U;
+
+    void resize(const uint& block, const uint& n_blocks);
+
+    [[nodiscard]] auto available() const -> uint;
+
+    [[nodiscard]] auto left_slot(const uint64_t& count) -> std::span<float>;
+
+    [[nodiscard]] auto right_slot(const uint64_t& count) -> std::span<float>;
+  };
+
+  std::string name;
+
+  std::atomic<bool> is_running = false;
+  std::atomic<bool> quit = false;
+
+  uint block_size = 0U;
+  uint latency_n_blocks = 0U;
+
+  // Only used by the realtime thread
+  uint missing_blocks = 0U;
+  uint dropped_blocks = 0U;
+
+  BlockQueue input, output;
+
+  Backend backend;
+
+  std::mutex backend_mutex;
+
+  std::counting_semaphore<> wakeup{0};
+
+  std::thread thread;
+
+  void work();
+};
@@ -18,10 +18,11 @@
  */
 
 #include "autogain.hpp"
-#include <ebur128.h>
 #include <qnamespace.h>
 #include <qobjectdefs.h>
 #include <qtypes.h>
+#include <sys/types.h>
+#include <QString>
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
@@ -32,11 +33,13 @@
 #include <string>
 #include "db_manager.hpp"
 #include "easyeffects_db_autogain.h"
+#include "loudness_analyzer.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Autogain::Autogain(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -54,10 +57,14 @@ Autogain::Autogain(const std::string& tag, pw::Manager* pipe_manager, PipelineTy
 
   // specific plugin controls
 
-  connect(settings, &DbAutogain::maximumHistoryChanged, [&]() {
-    std::scoped_lock<std::mutex> lock(data_mutex);
+  connect(settings, &DbAutogain::maximumHistoryChanged, this, [&]() { reattach_analyzer(); });
+
+  // The signal measured after a non unitary input gain is not the one of the tap anymore
 
-    set_maximum_history(settings->maximumHistory());
+  connect(settings, &DbAutogain::inputGainChanged, this, [&]() {
+    if (measured_tap() != attached_tap) {
+      reattach_analyzer();
+    }
   });
 }
 
@@ -72,11 +79,7 @@ Autogain::~Autogain() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
-
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
-  }
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -89,35 +92,38 @@ void Autogain::clear_data() {
   setup();
 }
 
-auto Autogain::init_ebur128() -> bool {
-  if (n_samples == 0U || rate == 0U) {
-    return false;
+auto Autogain::measured_tap() const -> QString {
+  if (settings->inputGain() != 0.0) {
+    return {};
   }
 
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
-
-    ebur_state = nullptr;
-  }
+  return analysis_tap;
+}
 
-  ebur_state = ebur128_init(2U, rate, EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_SAMPLE_PEAK);
+void Autogain::reattach_analyzer() {
+  data_mutex.lock();
 
-  ebur128_set_channel(ebur_state, 0U, EBUR128_LEFT);
-  ebur128_set_channel(ebur_state, 1U, EBUR128_RIGHT);
+  ebur128_ready = false;
 
-  set_maximum_history(settings->maximumHistory());
+  data_mutex.unlock();
 
-  return ebur_state != nullptr;
+  setup();
 }
 
-void Autogain::set_maximum_history(const int& seconds) {
-  if (ebur_state == nullptr) {
+void Autogain::set_analysis_tap(const QString& tap) {
+  if (tap == analysis_tap) {
     return;
   }
 
-  // The value given to ebur128_set_max_history must be in milliseconds
+  data_mutex.lock();
+
+  analysis_tap = tap;
 
-  ebur128_set_max_history(ebur_state, static_cast<ulong>(seconds) * 1000UL);
+  data_mutex.unlock();
+
+  if (measured_tap() != attached_tap) {
+    reattach_analyzer();
+  }
 }
 
 void Autogain::setup() {
@@ -133,10 +139,6 @@ void Autogain::setup() {
   attack_coeff = std::exp(-block_time / attack_time);
   release_coeff = std::exp(-block_time / release_time);
 
-  if (2U * static_cast<size_t>(n_samples) != data.size()) {
-    data.resize(static_cast<size_t>(n_samples) * 2U);
-  }
-
   // There is no need to reset libebur128 when n_samples change.
   // Only rate changes matter for it.
 
@@ -146,26 +148,27 @@ void Autogain::setup() {
 
   ebur128_ready = false;
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
-      [this] {
+      [this, tap = measured_tap()] {
         if (ebur128_ready) {
           return;
         }
 
-        auto status = true;
-
         old_rate = rate;
 
-        status = init_ebur128();
+        // The value given to libebur128 must be in milliseconds
+
+        const auto status =
+            analyzer.attach(pipeline_type, tap, rate, static_cast<ulong>(settings->maximumHistory()) * 1000UL);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
+        attached_tap = tap;
+
         ebur128_ready = status;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Autogain::process(std::span<float>& left_in,
@@ -181,45 +184,30 @@ void Autogain::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   if (!ebur128_ready) {
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    const float final_gain = static_cast<float>(internal_output_gain) * output_gain;
-
-    if (final_gain != 1.0F) {
-      apply_gain(left_out, right_out, final_gain);
+    if (internal_output_gain != 1.0) {
+      apply_gain(left_out, right_out, static_cast<float>(internal_output_gain));
     }
 
-    return;
-  }
-
-  {
-    const float* __restrict__ l = left_in.data();
-    const float* __restrict__ r = right_in.data();
-    float* __restrict__ d = data.data();
-
-    for (size_t i = 0; i < n_samples; ++i) {
-      const size_t idx = i * 2;
+    apply_gain(left_out, right_out, output_gain);
 
-      d[idx] = l[i];
-      d[idx + 1] = r[i];
-    }
+    return;
   }
 
-  ebur128_add_frames_float(ebur_state, data.data(), n_samples);
+  const auto& measurements = analyzer.process(left_in.first(n_samples), right_in.first(n_samples), clock_position);
 
-  auto failed = false;
+  momentary = measurements.momentary;
+  shortterm = measurements.shortterm;
+  global = measurements.global;
+  relative = measurements.relative;
+  range = measurements.range;
 
-  failed = (EBUR128_SUCCESS != ebur128_loudness_momentary(ebur_state, &momentary)) ||
-           (EBUR128_SUCCESS != ebur128_loudness_shortterm(ebur_state, &shortterm)) ||
-           (EBUR128_SUCCESS != ebur128_loudness_global(ebur_state, &global)) ||
-           (EBUR128_SUCCESS != ebur128_relative_threshold(ebur_state, &relative)) ||
-           (EBUR128_SUCCESS != ebur128_loudness_range(ebur_state, &range));
+  auto failed = measurements.loudness_failed;
 
   if (std::isinf(momentary) || std::isnan(momentary)) {
     /**
@@ -256,18 +244,10 @@ void Autogain::process(std::span<float>& left_in,
   }
 
   if (momentary > settings->silenceThreshold() && !failed) {
-    double peak_L = 0.0;
-    double peak_R = 0.0;
-
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 0U, &peak_L)) {
-      failed = true;
-    }
-
-    if (EBUR128_SUCCESS != ebur128_prev_sample_peak(ebur_state, 1U, &peak_R)) {
-      failed = true;
-    }
+    const double peak_L = measurements.sample_peak[0];
+    const double peak_R = measurements.sample_peak[1];
 
-    if (!failed) {
+    if (!measurements.peak_failed) {
       switch (settings->reference()) {
         case 0:  // momentary
           loudness = momentary;
@@ -342,15 +322,11 @@ void Autogain::process(std::span<float>& left_in,
   std::ranges::copy(left_in, left_out.begin());
   std::ranges::copy(right_in, right_out.begin());
 
-  const float final_gain = static_cast<float>(internal_output_gain) * output_gain;
-
-  if (final_gain != 1.0F) {
-    apply_gain(left_out, right_out, final_gain);
+  if (internal_output_gain != 1.0) {
+    apply_gain(left_out, right_out, static_cast<float>(internal_output_gain));
   }
 
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void Autogain::process([[maybe_unused]] std::span<float>& left_in,
@@ -395,11 +371,9 @@ float Autogain::getOutputGainLevel() const {
 void Autogain::resetHistory() {
   internal_output_gain = 1.0;
 
-  data_mutex.lock();
-
-  ebur128_ready = false;
-
-  data_mutex.unlock();
+  WorkerPool::post(baseWorker, [this] {
+    std::scoped_lock<std::mutex> lock(data_mutex);
 
-  setup();
+    analyzer.reset_history();
+  });
 }
@@ -26,8 +26,8 @@
 #include <QString>
 #include <span>
 #include <string>
-#include <vector>
 #include "easyeffects_db_autogain.h"
+#include "loudness_analyzer.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
@@ -65,6 +65,8 @@ class Autogain : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  void set_analysis_tap(const QString& tap) override;
+
   Q_INVOKABLE [[nodiscard]] float getMomentaryLevel() const;
 
   Q_INVOKABLE [[nodiscard]] float getShorttermLevel() const;
@@ -100,13 +102,13 @@ class Autogain : public PluginBase {
   double attack_coeff = 1.0F;
   double release_coeff = 1.0F;
 
-  std::vector<float> data;
+  QString attached_tap;
 
-  ebur128_state* ebur_state = nullptr;
+  LoudnessAnalyzer analyzer{EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_SAMPLE_PEAK};
 
   DbAutogain* settings = nullptr;
 
-  auto init_ebur128() -> bool;
+  [[nodiscard]] auto measured_tap() const -> QString;
 
-  void set_maximum_history(const int& seconds);
+  void reattach_analyzer();
 };
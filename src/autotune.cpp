@@ -33,14 +33,17 @@
 #include <span>
 #include <string>
 #include "db_manager.hpp"
+#include "dsp_kernels.hpp"
 #include "easyeffects_db_autotune.h"
 #include "lv2_macros.hpp"
 #include "lv2_wrapper.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Autotune::Autotune(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -64,6 +67,8 @@ Autotune::Autotune(const std::string& tag, pw::Manager* pipe_manager, PipelineTy
 
   init_common_controls<DbAutotune>(settings);
 
+  mono_buffer.resize(max_quantum);
+
   for (const auto& port : lv2_wrapper->ports) {
     if (port.type == lv2::PortType::TYPE_ATOM && port.is_input) {
       atom_port_index = port.index;
@@ -79,7 +84,7 @@ Autotune::Autotune(const std::string& tag, pw::Manager* pipe_manager, PipelineTy
       const float lv2_mode = lv2_wrapper->get_control_port_value("mode");
       settings->setMode(lv2_mode >= 1.5F ? 1 : 0);
     });
-    connect(settings, &DbAutotune::modeChanged, [this]() {
+    connect(settings, &DbAutotune::modeChanged, this, [this]() {
       if (this == nullptr || settings == nullptr || lv2_wrapper == nullptr) {  // NOLINT
         return;
       }
@@ -116,7 +121,7 @@ Autotune::~Autotune() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -152,26 +157,22 @@ void Autotune::setup() {
 
   lv2_wrapper->set_n_samples(n_samples);
 
-  mono_buffer.resize(n_samples);
-
   if (lv2_wrapper->has_instance() && rate == lv2_wrapper->get_rate()) {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Autotune::process(std::span<float>& left_in,
@@ -191,23 +192,17 @@ void Autotune::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   // fat1 is mono — mix stereo to mono for processing
-  for (size_t i = 0; i < left_in.size(); i++) {
-    mono_buffer[i] = (left_in[i] + right_in[i]) * 0.5F;
-  }
+  auto mono_span = std::span<float>(mono_buffer).first(left_in.size());
 
-  auto mono_span = std::span<float>(mono_buffer);
+  dsp::downmix(left_in, right_in, mono_span);
 
   // fat1 requires its atom input port to be connected
   atom_in_buf.seq.atom.size = sizeof(LV2_Atom_Sequence_Body);
@@ -222,9 +217,7 @@ void Autotune::process(std::span<float>& left_in,
   // left_out now has the processed mono signal; copy to right_out
   std::ranges::copy(left_out, right_out.begin());
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   const auto lv = static_cast<uint>(lv2_wrapper->get_control_port_value("latency"));
 
@@ -233,7 +226,7 @@ void Autotune::process(std::span<float>& left_in,
 
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
   }
@@ -36,6 +36,7 @@
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 BassEnhancer::BassEnhancer(const std::string& tag,
                            pw::Manager* pipe_manager,
@@ -80,7 +81,7 @@ BassEnhancer::~BassEnhancer() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -121,20 +122,18 @@ void BassEnhancer::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void BassEnhancer::process(std::span<float>& left_in,
@@ -154,23 +153,17 @@ void BassEnhancer::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
@@ -190,6 +183,10 @@ auto BassEnhancer::get_latency_seconds() -> float {
   return 0.0F;
 }
 
+auto BassEnhancer::get_tail_seconds() -> float {
+  return filter_tail_seconds;
+}
+
 float BassEnhancer::getHarmonicsLevel() const {
   return harmonics_port_value;
 }
@@ -62,6 +62,8 @@ class BassEnhancer : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto get_tail_seconds() -> float override;
+
   Q_INVOKABLE [[nodiscard]] float getHarmonicsLevel() const;
 
  private:
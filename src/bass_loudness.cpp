@@ -36,6 +36,7 @@
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 BassLoudness::BassLoudness(const std::string& tag,
                            pw::Manager* pipe_manager,
@@ -74,7 +75,7 @@ BassLoudness::~BassLoudness() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -115,20 +116,18 @@ void BassLoudness::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void BassLoudness::process(std::span<float>& left_in,
@@ -148,27 +147,17 @@ void BassLoudness::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void BassLoudness::process([[maybe_unused]] std::span<float>& left_in,
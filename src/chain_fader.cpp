@@ -0,0 +1,247 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "chain_fader.hpp"
+#include <sys/types.h>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <span>
+#include <string>
+#include <vector>
+#include "pipeline_type.hpp"
+#include "plugin_base.hpp"
+#include "pw_manager.hpp"
+#include "tags_plugin_name.hpp"
+#include "util.hpp"
+
+ChainFader::ChainFader(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
+    : PluginBase(tag, "chain_fader", tags::plugin_package::Package::ee, instance_id, pipe_manager, pipe_type) {
+  delay_L.resize(max_delay_frames, 0.0F);
+  delay_R.resize(max_delay_frames, 0.0F);
+}
+
+ChainFader::~ChainFader() {
+  if (connected_to_pw) {
+    disconnect_from_pw();
+  }
+
+  util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
+}
+
+void ChainFader::reset() {}
+
+void ChainFader::clear_data() {}
+
+void ChainFader::setup() {}
+
+void ChainFader::process(std::span<float>& left_in,
+                         std::span<float>& right_in,
+                         std::span<float>& left_out,
+                         std::span<float>& right_out) {
+  const auto ramp = load_ramp();
+
+  const auto position = clock_position;
+  const auto n_frames = static_cast<uint64_t>(left_in.size());
+
+  std::span<float> left = left_in;
+  std::span<float> right = right_in;
+
+  if (apply_delay(left_in, right_in, left_out, right_out)) {
+    left = left_out;
+    right = right_out;
+  }
+
+  if (position + n_frames <= ramp.start || position >= ramp.start + ramp.n_frames) {
+    const auto gain = gain_at(ramp, position);
+
+    if (gain == 1.0F) {
+      if (left.data() != left_out.data()) {
+        std::ranges::copy(left, left_out.begin());
+        std::ranges::copy(right, right_out.begin());
+      }
+    } else if (gain == 0.0F) {
+      std::ranges::fill(left_out, 0.0F);
+      std::ranges::fill(right_out, 0.0F);
+    } else {
+      std::ranges::transform(left, left_out.begin(), [&](const auto& v) { return v * gain; });
+      std::ranges::transform(right, right_out.begin(), [&](const auto& v) { return v * gain; });
+    }
+  } else {
+    for (size_t n = 0U; n < left.size(); n++) {
+      const auto gain = gain_at(ramp, position + n);
+
+      left_out[n] = left[n] * gain;
+      right_out[n] = right[n] * gain;
+    }
+  }
+
+  processed_position.store(position + n_frames, std::memory_order_release);
+}
+
+void ChainFader::process([[maybe_unused]] std::span<float>& left_in,
+                         [[maybe_unused]] std::span<float>& right_in,
+                         [[maybe_unused]] std::span<float>& left_out,
+                         [[maybe_unused]] std::span<float>& right_out,
+                         [[maybe_unused]] std::span<float>& probe_left,
+                         [[maybe_unused]] std::span<float>& probe_right) {}
+
+auto ChainFader::get_latency_seconds() -> float {
+  return (rate != 0U) ? static_cast<float>(get_delay()) / static_cast<float>(rate) : 0.0F;
+}
+
+void ChainFader::set_gain(const float& value) {
+  publish(Ramp{.from = value, .to = value, .start = 0U, .n_frames = 0U});
+}
+
+void ChainFader::fade_to(const float& target, const uint64_t& start, const uint64_t& n_frames) {
+  const auto from = gain_at(load_ramp(), start);
+
+  publish(Ramp{.from = from, .to = target, .start = start, .n_frames = std::max<uint64_t>(n_frames, 1U)});
+}
+
+auto ChainFader::get_processed_position() const -> uint64_t {
+  return processed_position.load(std::memory_order_acquire);
+}
+
+auto ChainFader::fade_finished() const -> bool {
+  const auto ramp = load_ramp();
+
+  return get_processed_position() >= ramp.start + ramp.n_frames;
+}
+
+auto ChainFader::set_delay(const uint& frames) -> bool {
+  target_delay.store(std::min(frames, max_delay_frames - 1U), std::memory_order_relaxed);
+
+  return frames < max_delay_frames;
+}
+
+auto ChainFader::get_delay() const -> uint {
+  return target_delay.load(std::memory_order_relaxed);
+}
+
+auto ChainFader::apply_delay(const std::span<float>& left_in,
+                             const std::span<float>& right_in,
+                             std::span<float>& left_out,
+                             std::span<float>& right_out) -> bool {
+  constexpr auto mask = max_delay_frames - 1U;
+
+  if (const auto target = target_delay.load(std::memory_order_relaxed); !delay_fading && target != delay) {
+    previous_delay = delay;
+    delay = target;
+
+    delay_fade_position = 0U;
+    delay_fade_frames = std::max(1U, static_cast<uint>(delay_fade_seconds * static_cast<float>(rate)));
+
+    delay_fading = true;
+  }
+
+  // The input is always written, so a new delay finds the past samples it needs
+
+  if (delay == 0U && !delay_fading) {
+    for (size_t n = 0U; n < left_in.size(); n++) {
+      delay_L[delay_write_index] = left_in[n];
+      delay_R[delay_write_index] = right_in[n];
+
+      delay_write_index = (delay_write_index + 1U) & mask;
+    }
+
+    return false;
+  }
+
+  for (size_t n = 0U; n < left_in.size(); n++) {
+    delay_L[delay_write_index] = left_in[n];
+    delay_R[delay_write_index] = right_in[n];
+
+    auto left = delay_L[(delay_write_index - delay) & mask];
+    auto right = delay_R[(delay_write_index - delay) & mask];
+
+    if (delay_fading) {
+      const auto w = static_cast<float>(delay_fade_position) / static_cast<float>(delay_fade_frames);
+
+      left = (w * left) + ((1.0F - w) * delay_L[(delay_write_index - previous_delay) & mask]);
+      right = (w * right) + ((1.0F - w) * delay_R[(delay_write_index - previous_delay) & mask]);
+
+      delay_fade_position++;
+
+      delay_fading = delay_fade_position < delay_fade_frames;
+    }
+
+    left_out[n] = left;
+    right_out[n] = right;
+
+    delay_write_index = (delay_write_index + 1U) & mask;
+  }
+
+  return true;
+}
+
+void ChainFader::publish(const Ramp& ramp) {
+  // Only the main thread publishes ramps
+
+  const auto sequence = ramp_sequence.load(std::memory_order_relaxed);
+
+  ramp_sequence.store(sequence + 1U, std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_release);
+
+  shared_ramp.from.store(ramp.from, std::memory_order_relaxed);
+  shared_ramp.to.store(ramp.to, std::memory_order_relaxed);
+  shared_ramp.start.store(ramp.start, std::memory_order_relaxed);
+  shared_ramp.n_frames.store(ramp.n_frames, std::memory_order_relaxed);
+
+  ramp_sequence.store(sequence + 2U, std::memory_order_release);
+}
+
+auto ChainFader::load_ramp() const -> Ramp {
+  Ramp ramp;
+
+  uint sequence = 0U;
+
+  do {
+    sequence = ramp_sequence.load(std::memory_order_acquire);
+
+    ramp.from = shared_ramp.from.load(std::memory_order_relaxed);
+    ramp.to = shared_ramp.to.load(std::memory_order_relaxed);
+    ramp.start = shared_ramp.start.load(std::memory_order_relaxed);
+    ramp.n_frames = shared_ramp.n_frames.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } while ((sequence & 1U) != 0U || sequence != ramp_sequence.load(std::memory_order_relaxed));
+
+  return ramp;
+}
+
+auto ChainFader::gain_at(const Ramp& ramp, const uint64_t& position) -> float {
+  if (position < ramp.start) {
+    return ramp.from;
+  }
+
+  if (position >= ramp.start + ramp.n_frames) {
+    return ramp.to;
+  }
+
+  // Linear, so the sum of the two chains keeps the level of the signal they have in common.
+
+  const auto t = static_cast<float>(position - ramp.start) / static_cast<float>(ramp.n_frames);
+
+  return ramp.from + ((ramp.to - ramp.from) * t);
+}
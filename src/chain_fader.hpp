@@ -0,0 +1,145 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+#include "pipeline_type.hpp"
+#include "plugin_base.hpp"
+#include "pw_manager.hpp"
+
+/**
+ * Gain stage placed at the end of an effects chain. Two of them let a new
+ * chain be linked next to the running one and the pipeline switch between
+ * them with a crossfade. The gain changes are scheduled at graph clock
+ * positions, so the faders of both chains move in the same samples. A delay
+ * before the gain lines up paths that have different latencies.
+ */
+class ChainFader : public PluginBase {
+ public:
+  ChainFader(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id);
+  ChainFader(const ChainFader&) = delete;
+  auto operator=(const ChainFader&) -> ChainFader& = delete;
+  ChainFader(const ChainFader&&) = delete;
+  auto operator=(const ChainFader&&) -> ChainFader& = delete;
+  ~ChainFader() override;
+
+  void reset() override;
+
+  void clear_data() override;
+
+  void setup() override;
+
+  void process(std::span<float>& left_in,
+               std::span<float>& right_in,
+               std::span<float>& left_out,
+               std::span<float>& right_out) override;
+
+  void process(std::span<float>& left_in,
+               std::span<float>& right_in,
+               std::span<float>& left_out,
+               std::span<float>& right_out,
+               std::span<float>& probe_left,
+               std::span<float>& probe_right) override;
+
+  auto get_latency_seconds() -> float override;
+
+  // Sets the gain right away.
+  void set_gain(const float& value);
+
+  // Moves the gain linearly to the target value in the n_frames frames starting at the clock position start.
+  void fade_to(const float& target, const uint64_t& start, const uint64_t& n_frames);
+
+  // Clock position right after the last processed cycle.
+  [[nodiscard]] auto get_processed_position() const -> uint64_t;
+
+  // Whether the last scheduled fade has been processed until its end.
+  [[nodiscard]] auto fade_finished() const -> bool;
+
+  /**
+   * Delays the signal by the given number of frames. The new delay is faded
+   * in, so the signal does not jump. Returns false when the delay line is too
+   * short for it. The longest possible delay is used then.
+   */
+  auto set_delay(const uint& frames) -> bool;
+
+  [[nodiscard]] auto get_delay() const -> uint;
+
+ private:
+  struct Ramp {
+    float from = 1.0F;
+    float to = 1.0F;
+
+    uint64_t start = 0U;
+    uint64_t n_frames = 0U;
+  };
+
+  /**
+   * Written by the main thread and read by the realtime thread. The sequence
+   * is odd while a ramp is being written, so the realtime thread never mixes
+   * the fields of two ramps however quickly they are published.
+   */
+  struct SharedRamp {
+    std::atomic<float> from = 1.0F;
+    std::atomic<float> to = 1.0F;
+
+    std::atomic<uint64_t> start = 0U;
+    std::atomic<uint64_t> n_frames = 0U;
+  };
+
+  SharedRamp shared_ramp;
+
+  std::atomic<uint> ramp_sequence = 0U;
+
+  std::atomic<uint64_t> processed_position = 0U;
+
+  static constexpr uint max_delay_frames = 1U << 16U;  // a power of two
+
+  static constexpr float delay_fade_seconds = 0.01F;
+
+  std::vector<float> delay_L, delay_R;
+
+  std::atomic<uint> target_delay = 0U;
+
+  // Used only by the realtime thread
+  uint delay = 0U;
+  uint previous_delay = 0U;
+  uint delay_write_index = 0U;
+  uint delay_fade_position = 0U;
+  uint delay_fade_frames = 1U;
+
+  bool delay_fading = false;
+
+  void publish(const Ramp& ramp);
+
+  [[nodiscard]] auto load_ramp() const -> Ramp;
+
+  // Writes the delayed input to the output. Returns false when there is no delay and the output was not written.
+  auto apply_delay(const std::span<float>& left_in,
+                   const std::span<float>& right_in,
+                   std::span<float>& left_out,
+                   std::span<float>& right_out) -> bool;
+
+  [[nodiscard]] static auto gain_at(const Ramp& ramp, const uint64_t& position) -> float;
+};
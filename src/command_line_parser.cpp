@@ -23,10 +23,11 @@
 #include <qtmetamacros.h>
 #include <KAboutData>
 #include <KLocalizedString>
-#include <QApplication>
+#include <QCoreApplication>
 #include <QLoggingCategory>
 #include <QString>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -54,14 +55,55 @@ CommandLineParser::CommandLineParser(KAboutData& about, QObject* parent)
        {{"s", "last-loaded-presets"}, i18n("Get the last loaded input and output presets.")},
        {"gapplication-service", i18n("Deprecated. Use --service-mode instead.")},
        {"service-mode", i18n("Start the application with service mode turned on.")},
+       {"headless",
+        i18n("Run without the graphical interface. The effects are controlled through the command line options.")},
+       {"render",
+        i18n("Apply a preset to audio files and quit. The files are given in input/output pairs. Example: easyeffects "
+             "--render music in.flac out.flac"),
+        i18n("preset-name")},
        {"debug", i18n("Enable debug messages.")}});
+
+  parser->addPositionalArgument("files", i18n("Input and output files used by --render."), "[files...]");
 }
 
 void CommandLineParser::set_is_primary(const bool& state) {
   is_primary = state;
 }
 
-void CommandLineParser::process(KAboutData& about, QApplication* app) {
+auto CommandLineParser::headless_requested(int argc, char* argv[]) -> bool {
+  /**
+   * The application object has to be chosen before QCommandLineParser can run.
+   * So this option is looked for directly in argv.
+   */
+
+  for (int n = 1; n < argc; n++) {
+    if (std::strcmp(argv[n], "--headless") == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+auto CommandLineParser::render_requested(int argc, char* argv[]) -> bool {
+  for (int n = 1; n < argc; n++) {
+    if (std::strcmp(argv[n], "--render") == 0 || std::strncmp(argv[n], "--render=", 9) == 0) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+auto CommandLineParser::render_preset() const -> QString {
+  return parser->value("render");
+}
+
+auto CommandLineParser::render_files() const -> QStringList {
+  return parser->positionalArguments();
+}
+
+void CommandLineParser::process(KAboutData& about, QCoreApplication* app) {
   parser->process(*app);
 
   about.processCommandLine(parser.get());
@@ -74,7 +116,7 @@ void CommandLineParser::process_debug_option() {
 }
 
 void CommandLineParser::process_hide_window(bool& show_window) {
-  if (parser->isSet("hide-window")) {
+  if (parser->isSet("hide-window") || parser->isSet("headless")) {
     show_window = false;
   }
 }
@@ -252,7 +294,7 @@ void CommandLineParser::process_events() {
     QCoreApplication::exit(EXIT_SUCCESS);
   }
 
-  if (is_primary) {
+  if (is_primary && !parser->isSet("headless")) {
     Q_EMIT onInitQML();
   }
 }
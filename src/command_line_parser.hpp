@@ -20,9 +20,11 @@
 #pragma once
 
 #include <qtmetamacros.h>
-#include <QApplication>
 #include <QCommandLineParser>
+#include <QCoreApplication>
 #include <QObject>
+#include <QString>
+#include <QStringList>
 #include <memory>
 #include "pipeline_type.hpp"
 
@@ -34,7 +36,7 @@ class CommandLineParser : public QObject {
  public:
   explicit CommandLineParser(KAboutData& about, QObject* parent = nullptr);
 
-  void process(KAboutData& about, QApplication* app);
+  void process(KAboutData& about, QCoreApplication* app);
 
   void process_debug_option();
 
@@ -44,6 +46,14 @@ class CommandLineParser : public QObject {
 
   void set_is_primary(const bool& state);
 
+  static auto headless_requested(int argc, char* argv[]) -> bool;
+
+  static auto render_requested(int argc, char* argv[]) -> bool;
+
+  [[nodiscard]] auto render_preset() const -> QString;
+
+  [[nodiscard]] auto render_files() const -> QStringList;
+
  Q_SIGNALS:
   void onReset();
   void onQuit();
@@ -181,6 +181,52 @@ Kirigami.ScrollablePage {
                     }
                 }
             }
+
+            Kirigami.Card {
+                id: cardThread
+
+                leftPadding: 0
+                rightPadding: 0
+
+                header: Kirigami.Heading {
+                    text: i18n("Processing thread") // qmllint disable
+                    level: 2
+                    leftPadding: Kirigami.Units.largeSpacing + Kirigami.Units.smallSpacing
+                    rightPadding: Kirigami.Units.largeSpacing + Kirigami.Units.smallSpacing
+                }
+
+                contentItem: ColumnLayout {
+                    spacing: 0
+
+                    EeSwitch {
+                        id: asyncProcessing
+
+                        label: i18n("Run in a separate thread") // qmllint disable
+                        subtitle: i18n("Keeps the cost of the model out of the audio thread at the price of a fixed extra latency.") // qmllint disable
+                        isChecked: deepfilternetPage.pluginDB.asyncProcessing
+                        onCheckedChanged: {
+                            if (isChecked !== deepfilternetPage.pluginDB.asyncProcessing)
+                                deepfilternetPage.pluginDB.asyncProcessing = isChecked;
+                        }
+                    }
+
+                    EeSpinBox {
+                        id: asyncLatency
+
+                        label: i18n("Added latency in blocks") // qmllint disable
+                        spinboxMaximumWidth: Kirigami.Units.gridUnit * 8
+                        from: deepfilternetPage.pluginDB.getMinValue("asyncLatency")
+                        to: deepfilternetPage.pluginDB.getMaxValue("asyncLatency")
+                        value: deepfilternetPage.pluginDB.asyncLatency
+                        decimals: 0
+                        stepSize: 1
+                        enabled: deepfilternetPage.pluginDB.asyncProcessing
+                        onValueModified: v => {
+                            deepfilternetPage.pluginDB.asyncLatency = v;
+                        }
+                    }
+                }
+            }
         }
     }
 
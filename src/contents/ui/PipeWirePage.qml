@@ -442,6 +442,77 @@ Kirigami.Page {
                     }
                 }
             }
+
+            FormCard.FormHeader {
+                title: i18n("Output Pipeline Measurement") // qmllint disable
+            }
+
+            FormCard.FormCard {
+                Connections {
+                    function onLatencyMeasured() {
+                        measuredMagnitudeChart.updateData(StreamOutputEffects.measuredMagnitude);
+                        measuredPhaseChart.updateData(StreamOutputEffects.measuredPhase);
+                    }
+
+                    target: StreamOutputEffects
+                }
+
+                FormCard.FormButtonDelegate {
+                    text: i18n("Measure latency and frequency response") // qmllint disable
+                    description: i18n("A sweep is played through the effects and captured after each one of them.") // qmllint disable
+                    enabled: !StreamOutputEffects.measuringLatency
+                    onClicked: StreamOutputEffects.measureLatency()
+                }
+
+                FormCard.FormTextDelegate {
+                    text: i18n("Measured latency") // qmllint disable
+                    description: {
+                        if (StreamOutputEffects.measuringLatency)
+                            return i18n("Measuring…"); // qmllint disable
+
+                        const latency = StreamOutputEffects.measuredLatency;
+
+                        return latency < 0 ? "-" : `${latency.toLocaleString(Qt.locale(), 'f', 2)} ${Units.ms}`;
+                    }
+                }
+
+                Repeater {
+                    model: StreamOutputEffects.latencyReport
+
+                    delegate: FormCard.FormTextDelegate {
+                        required property string modelData
+
+                        text: modelData
+                    }
+                }
+
+                EeChart {
+                    id: measuredMagnitudeChart
+
+                    Layout.fillWidth: true
+                    implicitHeight: Kirigami.Units.gridUnit * 12
+                    visible: StreamOutputEffects.measuredMagnitude.length > 0
+                    seriesType: 1 // spline series
+                    colorScheme: DbGraph.colorScheme
+                    colorTheme: DbGraph.colorTheme
+                    xUnit: Units.hz
+                    yUnit: Units.dB
+                    yAxisDecimals: 1
+                }
+
+                EeChart {
+                    id: measuredPhaseChart
+
+                    Layout.fillWidth: true
+                    implicitHeight: Kirigami.Units.gridUnit * 12
+                    visible: StreamOutputEffects.measuredPhase.length > 0
+                    seriesType: 1 // spline series
+                    colorScheme: DbGraph.colorScheme
+                    colorTheme: DbGraph.colorTheme
+                    xUnit: Units.hz
+                    yUnit: Units.degrees
+                }
+            }
         }
     }
 
@@ -228,19 +228,6 @@ KirigamiSettings.ConfigurationView {
                     }
                 }
 
-                EeSwitch {
-                    id: processAllcopyFilterInputBuffersOutputs
-
-                    label: i18n("Copy the input audio buffer") // qmllint disable
-                    subtitle: i18n("Use a copy of the input audio buffer given by the sound server when processing audio inside Easy Effects plugins. This fixes audio glitches that can happen when external applications are recording from Easy Effects virtual devices monitors.") // qmllint disable
-                    maximumLineCount: -1
-                    isChecked: DbMain.copyFilterInputBuffers
-                    onCheckedChanged: {
-                        if (isChecked !== DbMain.copyFilterInputBuffers)
-                            DbMain.copyFilterInputBuffers = isChecked;
-                    }
-                }
-
                 EeSwitch {
                     id: linkDelayEnable
 
@@ -301,6 +288,48 @@ KirigamiSettings.ConfigurationView {
                     }
                 }
 
+                EeSpinBox {
+                    label: i18n("Standby plugins") // qmllint disable
+                    subtitle: i18n("Maximum number of removed effects kept ready to be reused when they are added back to the pipeline.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("pluginsPoolSize")
+                    to: DbMain.getMaxValue("pluginsPoolSize")
+                    value: DbMain.pluginsPoolSize
+                    decimals: 0
+                    stepSize: 1
+                    onValueModified: v => {
+                        DbMain.pluginsPoolSize = v;
+                    }
+                }
+
+                EeSwitch {
+                    id: chainCrossfade
+
+                    label: i18n("Crossfade effects chains") // qmllint disable
+                    subtitle: i18n("When the list of effects changes, the new chain is prepared while the current one keeps playing and then both are crossfaded.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbMain.chainCrossfade
+                    onCheckedChanged: {
+                        if (isChecked !== DbMain.chainCrossfade)
+                            DbMain.chainCrossfade = isChecked;
+                    }
+                }
+
+                EeSpinBox {
+                    label: i18n("Chains crossfade duration") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbMain.getMinValue("chainCrossfadeTime")
+                    to: DbMain.getMaxValue("chainCrossfadeTime")
+                    value: DbMain.chainCrossfadeTime
+                    decimals: 0
+                    stepSize: 1
+                    unit: Units.ms
+                    enabled: DbMain.chainCrossfade
+                    onValueModified: v => {
+                        DbMain.chainCrossfadeTime = v;
+                    }
+                }
+
                 EeSpinBox {
                     label: i18n("Level meters frame rate cap") // qmllint disable
                     subtitle: i18n("Maximum level meter update rate.") // qmllint disable
@@ -357,6 +386,100 @@ KirigamiSettings.ConfigurationView {
                     }
                 }
             }
+
+            FormCard.FormHeader {
+                title: i18n("Realtime Threads") // qmllint disable
+            }
+
+            FormCard.FormCard {
+                FormCard.FormTextDelegate {
+                    description: i18n("Input and output effects can run on separate threads pinned to different CPUs. It is necessary to restart the service for changes in these settings to take effect. PipeWire 1.2 or newer is required.") // qmllint disable
+                }
+
+                EeSwitch {
+                    id: outputDataLoop
+
+                    label: i18n("Dedicated output thread") // qmllint disable
+                    subtitle: i18n("Process the output effects on their own PipeWire realtime thread.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbStreamOutputs.dataLoop
+                    onCheckedChanged: {
+                        if (isChecked !== DbStreamOutputs.dataLoop)
+                            DbStreamOutputs.dataLoop = isChecked;
+                    }
+                }
+
+                FormCard.FormTextFieldDelegate {
+                    label: i18n("Output thread CPUs") // qmllint disable
+                    placeholderText: i18n("Any") // qmllint disable
+                    text: DbStreamOutputs.dataLoopCpus
+                    enabled: DbStreamOutputs.dataLoop
+                    validator: RegularExpressionValidator {
+                        regularExpression: /^[0-9,\- ]*$/
+                    }
+                    onEditingFinished: {
+                        if (text !== DbStreamOutputs.dataLoopCpus)
+                            DbStreamOutputs.dataLoopCpus = text;
+                    }
+                }
+
+                EeSpinBox {
+                    label: i18n("Output thread priority") // qmllint disable
+                    subtitle: i18n("The value -1 uses the PipeWire default.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbStreamOutputs.getMinValue("dataLoopPriority")
+                    to: DbStreamOutputs.getMaxValue("dataLoopPriority")
+                    value: DbStreamOutputs.dataLoopPriority
+                    decimals: 0
+                    stepSize: 1
+                    enabled: DbStreamOutputs.dataLoop
+                    onValueModified: v => {
+                        DbStreamOutputs.dataLoopPriority = v;
+                    }
+                }
+
+                EeSwitch {
+                    id: inputDataLoop
+
+                    label: i18n("Dedicated input thread") // qmllint disable
+                    subtitle: i18n("Process the input effects on their own PipeWire realtime thread.") // qmllint disable
+                    maximumLineCount: -1
+                    isChecked: DbStreamInputs.dataLoop
+                    onCheckedChanged: {
+                        if (isChecked !== DbStreamInputs.dataLoop)
+                            DbStreamInputs.dataLoop = isChecked;
+                    }
+                }
+
+                FormCard.FormTextFieldDelegate {
+                    label: i18n("Input thread CPUs") // qmllint disable
+                    placeholderText: i18n("Any") // qmllint disable
+                    text: DbStreamInputs.dataLoopCpus
+                    enabled: DbStreamInputs.dataLoop
+                    validator: RegularExpressionValidator {
+                        regularExpression: /^[0-9,\- ]*$/
+                    }
+                    onEditingFinished: {
+                        if (text !== DbStreamInputs.dataLoopCpus)
+                            DbStreamInputs.dataLoopCpus = text;
+                    }
+                }
+
+                EeSpinBox {
+                    label: i18n("Input thread priority") // qmllint disable
+                    subtitle: i18n("The value -1 uses the PipeWire default.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbStreamInputs.getMinValue("dataLoopPriority")
+                    to: DbStreamInputs.getMaxValue("dataLoopPriority")
+                    value: DbStreamInputs.dataLoopPriority
+                    decimals: 0
+                    stepSize: 1
+                    enabled: DbStreamInputs.dataLoop
+                    onValueModified: v => {
+                        DbStreamInputs.dataLoopPriority = v;
+                    }
+                }
+            }
         }
     }
 
@@ -523,6 +646,77 @@ KirigamiSettings.ConfigurationView {
                     }
                 }
             }
+
+            FormCard.FormHeader {
+                title: i18n("Analysis") // qmllint disable
+            }
+
+            FormCard.FormCard {
+                FormCard.FormComboBoxDelegate {
+                    id: fftSize
+
+                    readonly property var sizes: [1024, 2048, 4096, 8192, 16384, 32768]
+
+                    text: i18n("Resolution") // qmllint disable
+                    description: i18n("Number of samples in each analysis frame. Larger frames separate close frequencies better but react slower.") // qmllint disable
+                    displayMode: FormCard.FormComboBoxDelegate.ComboBox
+                    currentIndex: sizes.indexOf(DbSpectrum.fftSize)
+                    editable: false
+                    model: sizes
+                    onActivated: idx => {
+                        if (sizes[idx] !== DbSpectrum.fftSize)
+                            DbSpectrum.fftSize = sizes[idx];
+                    }
+                }
+
+                EeSpinBox {
+                    id: overlap
+
+                    label: i18n("Overlap") // qmllint disable
+                    subtitle: i18n("Higher values update the spectrum more often.") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbSpectrum.getMinValue("overlap")
+                    to: DbSpectrum.getMaxValue("overlap")
+                    value: DbSpectrum.overlap
+                    decimals: 0
+                    stepSize: 5
+                    unit: Units.percent
+                    onValueModified: v => {
+                        DbSpectrum.overlap = v;
+                    }
+                }
+
+                FormCard.FormComboBoxDelegate {
+                    id: averaging
+
+                    text: i18n("Averaging") // qmllint disable
+                    displayMode: FormCard.FormComboBoxDelegate.ComboBox
+                    currentIndex: DbSpectrum.averaging
+                    editable: false
+                    model: [i18n("None"), i18n("Exponential"), i18n("Peak hold"), i18n("Welch")] // qmllint disable
+                    onActivated: idx => {
+                        if (idx !== DbSpectrum.averaging)
+                            DbSpectrum.averaging = idx;
+                    }
+                }
+
+                EeSpinBox {
+                    id: averagingTime
+
+                    label: i18n("Averaging time") // qmllint disable
+                    maximumLineCount: -1
+                    from: DbSpectrum.getMinValue("averagingTime")
+                    to: DbSpectrum.getMaxValue("averagingTime")
+                    value: DbSpectrum.averagingTime
+                    decimals: 0
+                    stepSize: 10
+                    unit: Units.ms
+                    enabled: DbSpectrum.averaging === 1 || DbSpectrum.averaging === 2
+                    onValueModified: v => {
+                        DbSpectrum.averagingTime = v;
+                    }
+                }
+            }
         }
     }
 
@@ -281,6 +281,47 @@ Kirigami.ScrollablePage {
                     }
                 }
             }
+
+            Kirigami.Card {
+                id: cardThread
+
+                header: Kirigami.Heading {
+                    text: i18n("Processing thread") // qmllint disable
+                    level: 2
+                }
+
+                contentItem: ColumnLayout {
+                    anchors.fill: parent
+
+                    EeSwitch {
+                        id: asyncProcessing
+
+                        label: i18n("Run in a separate thread") // qmllint disable
+                        subtitle: i18n("Keeps the cost of the model out of the audio thread at the price of a fixed extra latency.") // qmllint disable
+                        isChecked: rnnoisePage.pluginDB.asyncProcessing
+                        onCheckedChanged: {
+                            if (isChecked !== rnnoisePage.pluginDB.asyncProcessing)
+                                rnnoisePage.pluginDB.asyncProcessing = isChecked;
+                        }
+                    }
+
+                    EeSpinBox {
+                        id: asyncLatency
+
+                        label: i18n("Added latency in blocks") // qmllint disable
+                        spinboxMaximumWidth: Kirigami.Units.gridUnit * 8
+                        from: rnnoisePage.pluginDB.getMinValue("asyncLatency")
+                        to: rnnoisePage.pluginDB.getMaxValue("asyncLatency")
+                        value: rnnoisePage.pluginDB.asyncLatency
+                        decimals: 0
+                        stepSize: 1
+                        enabled: rnnoisePage.pluginDB.asyncProcessing
+                        onValueModified: v => {
+                            rnnoisePage.pluginDB.asyncLatency = v;
+                        }
+                    }
+                }
+            }
         }
 
         Kirigami.CardsLayout {
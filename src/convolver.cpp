@@ -19,6 +19,8 @@
 
 #include "convolver.hpp"
 #include <fftw3.h>
+#include <pipewire/loop.h>
+#include <pipewire/thread-loop.h>
 #include <qlist.h>
 #include <qnamespace.h>
 #include <qobject.h>
@@ -30,15 +32,19 @@
 #include <qtypes.h>
 #include <sched.h>
 #include <sndfile.h>
+#include <spa/support/loop.h>
 #include <sys/types.h>
 #include <zita-convolver.h>
 #include <QString>
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <format>
 #include <mutex>
+#include <optional>
 #include <sndfile.hh>
 #include <span>
+#include <utility>
 #include <string>
 #include <vector>
 #include "convolver_kernel_fft.hpp"
@@ -48,8 +54,10 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -65,41 +73,65 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
       worker(new ConvolverWorker) {
   init_common_controls<DbConvolver>(settings);
 
-  dry = (settings->dry() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->dry()));
+  dry.reset((settings->dry() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->dry())));
 
-  wet = (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
+  wet.reset((settings->wet() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->wet())));
 
-  connect(settings, &DbConvolver::kernelNameChanged, [&]() { load_kernel_file(true, rate); });
+  ramped_values.push_back(&dry);
+  ramped_values.push_back(&wet);
 
-  connect(settings, &DbConvolver::irWidthChanged, [&]() {
-    std::scoped_lock<std::mutex> lock(data_mutex);
-    zita.update_ir_width_and_autogain(settings->irWidth(), settings->autogain(), true);
-  });
+  update_kernel_settings();
 
-  connect(settings, &DbConvolver::autogainChanged, [&]() {
-    std::scoped_lock<std::mutex> lock(data_mutex);
-    zita.update_ir_width_and_autogain(settings->irWidth(), settings->autogain(), true);
+  /**
+   * Zita and its fftw plans are created and destroyed only in the loader
+   * thread. Changes that touch them are sent there with a copy of the settings.
+   */
+
+  connect(settings, &DbConvolver::kernelNameChanged, this, [&]() {
+    WorkerPool::post(
+        worker, [this, ks = update_kernel_settings()] { load_kernel_file(ks, true, rate); },
+        WorkerPool::Priority::normal);
   });
 
-  connect(settings, &DbConvolver::dryChanged, [&]() {
-    dry =
-        (settings->dry() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->dry()));
+  auto update_ir = [&]() {
+    WorkerPool::post(
+        worker,
+        [this, ks = update_kernel_settings()] {
+          std::scoped_lock<std::mutex> lock(data_mutex);
+
+          zita->update_ir_width_and_autogain(ks.ir_width, ks.autogain, true);
+        },
+        WorkerPool::Priority::normal);
+  };
+
+  connect(settings, &DbConvolver::irWidthChanged, this, update_ir);
+
+  connect(settings, &DbConvolver::autogainChanged, this, update_ir);
+
+  connect(settings, &DbConvolver::dryChanged, this, [&]() {
+    dry.set((settings->dry() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->dry())));
   });
 
-  connect(settings, &DbConvolver::wetChanged, [&]() {
-    wet =
-        (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
+  connect(settings, &DbConvolver::wetChanged, this, [&]() {
+    wet.set((settings->wet() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->wet())));
   });
 
-  // Preparing the worker thread
+  /**
+   * Kernel files and SOFA databases can take a while to load. They are read in
+   * a loader thread so the setup of the other plugins does not wait for them.
+   */
 
-  worker->moveToThread(&workerThread);
+  loaderThread = WorkerPool::self().acquire_thread(WorkerPool::Load::long_jobs);
 
-  connect(&workerThread, &QThread::finished, worker, &QObject::deleteLater);
+  worker->moveToThread(loaderThread);
 
   connect(
       worker, &ConvolverWorker::onNewKernel, this,
-      [this](ConvolverKernelManager::KernelData data, bool init_zita) {
+      [this](const ConvolverKernelManager::KernelData& data) {
         kernel_is_initialized = data.isValid();
 
         if (kernel_is_initialized) {
@@ -146,17 +178,7 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
             Q_EMIT sofaMaxRadiusChanged();
           }
 
-          if (init_zita) {
-            std::scoped_lock<std::mutex> lock(data_mutex);
-
-            auto success = zita.init(data, blocksize, settings->irWidth(), settings->autogain());
-
-            if (!success) {
-              util::warning(std::format("{} Zita init failed", log_tag));
-            }
-
-            ready = success;
-          }
+          tail_seconds = static_cast<float>(data.duration());
         }
       },
       Qt::QueuedConnection);
@@ -199,9 +221,9 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
       },
       Qt::QueuedConnection);
 
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       worker,
-      [this] {
+      [this, ks = get_kernel_settings()] {
         if (ready || destructor_called) {
           return;
         }
@@ -215,26 +237,45 @@ Convolver::Convolver(const std::string& tag, pw::Manager* pipe_manager, Pipeline
 
         util::str_to_num(pw::Manager::self().defaultClockRate.toStdString(), r);
 
-        load_kernel_file(false, r);
+        load_kernel_file(ks, false, r);
       },
-      Qt::QueuedConnection);
+      WorkerPool::Priority::normal);
 }
 
 Convolver::~Convolver() {
-  stop_worker();
-
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
 
-  destructor_called = true;
-  ready = false;
+    destructor_called = true;
+    ready = false;
 
-  if (connected_to_pw) {
-    disconnect_from_pw();
+    if (connected_to_pw) {
+      disconnect_from_pw();
+    }
   }
 
-  zita.stop();
+  // The pending jobs return early now. The zita states are destroyed in the thread that created them.
+
+  WorkerPool::post(
+      worker,
+      [this] {
+        for (auto& state : zita_states) {
+          state.release();
+        }
+      },
+      WorkerPool::Priority::high);
+
+  WorkerPool::wait_for_pending_jobs(worker);
+
+  WorkerPool::destroy_context(worker);
+
+  worker = nullptr;
 
-  settings->disconnect();
+  WorkerPool::self().release_thread(loaderThread);
+
+  stop_worker();
+
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -264,18 +305,18 @@ void Convolver::setup() {
    * initializing in the plugin realtime thread we send it to the worker thread
    */
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       worker,
       [this] {
         if (destructor_called) {
           return;
         }
 
+        const auto ks = get_kernel_settings();
+
         blocksize = n_samples;
 
-        n_samples_is_power_of_2 = (n_samples & (n_samples - 1U)) == 0U && n_samples != 0U;
+        const auto n_samples_is_power_of_2 = (n_samples & (n_samples - 1U)) == 0U && n_samples != 0U;
 
         if (!n_samples_is_power_of_2) {
           while ((blocksize & (blocksize - 1)) != 0 && blocksize > 2) {
@@ -290,18 +331,35 @@ void Convolver::setup() {
         buf_out_L.clear();
         buf_out_R.clear();
 
+        // Enough for any quantum so the realtime thread does not allocate after a quantum change
+
+        buf_in_L.reserve(max_quantum + blocksize);
+        buf_in_R.reserve(max_quantum + blocksize);
+        buf_out_L.reserve(max_quantum + blocksize);
+        buf_out_R.reserve(max_quantum + blocksize);
+
         data_L.resize(blocksize);
         data_R.resize(blocksize);
 
+        fade_L.resize(blocksize);
+        fade_R.resize(blocksize);
+
+        crossfade_frames = std::max(1U, static_cast<uint>(crossfade_time * static_cast<float>(rate)));
+
         notify_latency = true;
 
         latency_n_frames = 0U;
 
-        load_kernel_file(true, rate);
+        load_kernel_file(ks, true, rate);
       },
-      Qt::QueuedConnection);
+      WorkerPool::Priority::high);
+}
 
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+void Convolver::quantum_changed() {
+  /**
+   * Zita keeps the block size it was set up for. Other quanta go through the
+   * buffers in process() and the latency they add is reported from there.
+   */
 }
 
 void Convolver::process(std::span<float>& left_in,
@@ -321,22 +379,30 @@ void Convolver::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
+
+  if (n_samples == blocksize) {
+    if (latency_n_frames != 0U) {
+      // Back to the quantum zita was set up for. What is still buffered is dropped.
+      buf_in_L.clear();
+      buf_in_R.clear();
+      buf_out_L.clear();
+      buf_out_R.clear();
+
+      latency_n_frames = 0U;
+
+      notify_latency = true;
+    }
 
-  if (n_samples_is_power_of_2) {
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    zita.process(left_out, right_out);
+    process_zita(left_out, right_out);
   } else {
     buf_in_L.insert(buf_in_L.end(), left_in.begin(), left_in.end());
     buf_in_R.insert(buf_in_R.end(), right_in.begin(), right_in.end());
@@ -345,7 +411,7 @@ void Convolver::process(std::span<float>& left_in,
       util::copy_bulk(buf_in_L, data_L);
       util::copy_bulk(buf_in_R, data_R);
 
-      zita.process(data_L, data_R);
+      process_zita(data_L, data_R);
 
       buf_out_L.insert(buf_out_L.end(), data_L.begin(), data_L.end());
       buf_out_R.insert(buf_out_R.end(), data_R.begin(), data_R.end());
@@ -377,26 +443,27 @@ void Convolver::process(std::span<float>& left_in,
     }
   }
 
-  for (size_t n = 0; n < left_out.size(); n++) {
-    left_out[n] = (wet * left_out[n]) + (dry * left_in[n]);
-
-    right_out[n] = (wet * right_out[n]) + (dry * right_in[n]);
-  }
+  RampedValue::mix(left_out, right_out, left_in, right_in, wet, dry);
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
 
     notify_latency = false;
   }
 
+  if (notify_crossfade_end) {
+    // A kernel may be waiting for this fade in the loader thread
+    pw_loop_invoke(pw_thread_loop_get_loop(pm->thread_loop), on_crossfade_end, 1, nullptr, 0, false, this);  // NOLINT
+
+    notify_crossfade_end = false;
+  }
+
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
   }
@@ -409,14 +476,35 @@ void Convolver::process([[maybe_unused]] std::span<float>& left_in,
                         [[maybe_unused]] std::span<float>& probe_left,
                         [[maybe_unused]] std::span<float>& probe_right) {}
 
-void Convolver::load_kernel_file(const bool& init_zita, const uint& server_sampling_rate) {
+auto Convolver::update_kernel_settings() -> KernelSettings {
+  std::scoped_lock<std::mutex> lock(kernel_settings_mutex);
+
+  kernel_settings.name = settings->kernelName();
+  kernel_settings.ir_width = settings->irWidth();
+  kernel_settings.autogain = settings->autogain();
+
+  return kernel_settings;
+}
+
+auto Convolver::get_kernel_settings() -> KernelSettings {
+  std::scoped_lock<std::mutex> lock(kernel_settings_mutex);
+
+  return kernel_settings;
+}
+
+void Convolver::load_kernel_file(const KernelSettings& ks,
+                                 const bool& init_zita,
+                                 const uint& server_sampling_rate,
+                                 const bool& crossfade) {
   if (destructor_called) {
     return;
   }
 
-  const auto name = settings->kernelName();
+  const auto& name = ks.name;
+
+  // The kernel is resampled to the server rate. The other instances using the same file share its samples.
 
-  auto kernel_data = kernel_manager.loadKernel(name.toStdString());
+  const auto kernel_data = kernel_manager.loadKernel(name.toStdString(), server_sampling_rate);
 
   if (!kernel_data.isValid()) {
     Q_EMIT worker->onInvalidKernel(name);
@@ -424,60 +512,108 @@ void Convolver::load_kernel_file(const bool& init_zita, const uint& server_sampl
     return;
   }
 
-  if (server_sampling_rate != 0 && kernel_data.rate != server_sampling_rate) {
-    util::debug(std::format("{}{} kernel has {} rate. Resampling it to {}", log_tag, name.toStdString(),
-                            kernel_data.rate, server_sampling_rate));
+  util::debug(std::format("{}{}: kernel correctly loaded", log_tag, name.toStdString()));
 
-    kernel_data = ConvolverKernelManager::resampleKernel(kernel_data, server_sampling_rate);
+  if (init_zita && crossfade) {
+    crossfade_to(kernel_data, ks);
+  } else if (init_zita) {
+    init_zita_state(kernel_data, ks);
   }
 
-  const auto dt = 1.0 / kernel_data.rate;
+  /**
+   * The charts are computed on this worker without holding data_mutex so a
+   * long kernel never blocks the audio thread. Other instances using the same
+   * kernel reuse them.
+   */
 
-  std::vector<double> time_axis(kernel_data.sampleCount());
+  auto& charts = *kernel_data.charts;
 
-  for (size_t n = 0U; n < time_axis.size(); n++) {
-    time_axis[n] = static_cast<double>(n) * dt;
-  }
+  std::scoped_lock<std::mutex> lock(charts.mutex);
 
-  auto x_linear = util::linspace(time_axis.front(), time_axis.back(), interpPoints);
+  if (charts.interp_points != interpPoints) {
+    const auto dt = 1.0 / kernel_data.rate;
 
-  std::vector<double> copy_helper(kernel_data.sampleCount());
+    std::vector<double> time_axis(kernel_data.sampleCount());
 
-  std::ranges::copy(kernel_data.channel_L, copy_helper.begin());
+    for (size_t n = 0U; n < time_axis.size(); n++) {
+      time_axis[n] = static_cast<double>(n) * dt;
+    }
 
-  auto magL = util::interpolate(time_axis, copy_helper, x_linear);
+    auto x_linear = util::linspace(time_axis.front(), time_axis.back(), interpPoints);
 
-  std::ranges::copy(kernel_data.channel_R, copy_helper.begin());
+    std::vector<double> copy_helper(kernel_data.sampleCount());
 
-  auto magR = util::interpolate(time_axis, copy_helper, x_linear);
+    std::ranges::copy(kernel_data.channel_L, copy_helper.begin());
 
-  QList<QPointF> chart_mag_L(interpPoints);
-  QList<QPointF> chart_mag_R(interpPoints);
+    auto magL = util::interpolate(time_axis, copy_helper, x_linear);
 
-  for (qsizetype n = 0; n < interpPoints; n++) {
-    chart_mag_L[n] = QPointF(x_linear[n], magL[n]);
-    chart_mag_R[n] = QPointF(x_linear[n], magR[n]);
+    std::ranges::copy(kernel_data.channel_R, copy_helper.begin());
+
+    auto magR = util::interpolate(time_axis, copy_helper, x_linear);
+
+    charts.mag_L.resize(interpPoints);
+    charts.mag_R.resize(interpPoints);
+
+    for (qsizetype n = 0; n < interpPoints; n++) {
+      charts.mag_L[n] = QPointF(x_linear[n], magL[n]);
+      charts.mag_R[n] = QPointF(x_linear[n], magR[n]);
+    }
+
+    ConvolverKernelFFT kernel_fft;
+
+    kernel_fft.calculate_fft(kernel_data.channel_L, kernel_data.channel_R, kernel_data.rate, interpPoints);
+
+    charts.linear_L = kernel_fft.linear_L;
+    charts.linear_R = kernel_fft.linear_R;
+    charts.log_L = kernel_fft.log_L;
+    charts.log_R = kernel_fft.log_R;
+
+    charts.interp_points = interpPoints;
   }
 
-  util::debug(std::format("{}{}: kernel correctly loaded", log_tag, name.toStdString()));
+  Q_EMIT worker->onNewChartMag(charts.mag_L, charts.mag_R);
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  Q_EMIT worker->onNewSpectrum(charts.linear_L, charts.linear_R, charts.log_L, charts.log_R);
 
-  ConvolverKernelFFT kernel_fft;
+  Q_EMIT worker->onNewKernel(kernel_data);
+}
+
+void Convolver::init_zita_state(const ConvolverKernelManager::KernelData& data, const KernelSettings& ks) {
+  // A full initialization replaces any fade that was waiting
+
+  queued_crossfade.reset();
 
-  kernel_fft.calculate_fft(kernel_data.channel_L, kernel_data.channel_R, kernel_data.original_rate, interpPoints);
+  std::scoped_lock<std::mutex> lock(data_mutex);
 
-  Q_EMIT worker->onNewChartMag(chart_mag_L, chart_mag_R);
+  crossfading = false;
 
-  Q_EMIT worker->onNewSpectrum(kernel_fft.linear_L, kernel_fft.linear_R, kernel_fft.log_L, kernel_fft.log_R);
+  ready = zita->init(data, blocksize, ks.ir_width, ks.autogain);
 
-  Q_EMIT worker->onNewKernel(kernel_data, init_zita);
+  if (!ready) {
+    util::warning(std::format("{} Zita init failed", log_tag));
+  }
 }
 
 auto Convolver::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+void Convolver::wait_for_pending_jobs() {
+  PluginBase::wait_for_pending_jobs();
+
+  WorkerPool::wait_for_pending_jobs(worker);
+}
+
+auto Convolver::is_ready() -> bool {
+  if (!PluginBase::is_ready() || worker->has_pending_jobs()) {
+    return false;
+  }
+
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  return ready;
+}
+
 void Convolver::combine_kernels(const std::string& kernel_1_name,
                                 const std::string& kernel_2_name,
                                 const std::string& output_file_name) {
@@ -487,12 +623,12 @@ void Convolver::combine_kernels(const std::string& kernel_1_name,
 }
 
 void Convolver::combineKernels(const QString& kernel1, const QString& kernel2, const QString& outputName) {
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       worker,
       [this, kernel1, kernel2, outputName] {
         combine_kernels(kernel1.toStdString(), kernel2.toStdString(), outputName.toStdString());
       },
-      Qt::QueuedConnection);
+      WorkerPool::Priority::normal);
 }
 
 void Convolver::clear_chart_data() {
@@ -504,6 +640,130 @@ void Convolver::clear_chart_data() {
   chartMagRfftLog.clear();
 }
 
+void Convolver::process_zita(std::span<float> left, std::span<float> right) {
+  if (!crossfading || left.size() > fade_L.size()) {
+    zita->process(left, right);
+
+    return;
+  }
+
+  // The previous state keeps running on a copy of the input until the new one fully replaces it
+
+  auto previous_L = std::span(fade_L).first(left.size());
+  auto previous_R = std::span(fade_R).first(right.size());
+
+  std::ranges::copy(left, previous_L.begin());
+  std::ranges::copy(right, previous_R.begin());
+
+  zita->process(left, right);
+  zita_previous->process(previous_L, previous_R);
+
+  for (size_t n = 0U; n < left.size(); n++) {
+    const auto w = std::min(1.0F, static_cast<float>(crossfade_position + n) / static_cast<float>(crossfade_frames));
+
+    left[n] = (w * left[n]) + ((1.0F - w) * previous_L[n]);
+    right[n] = (w * right[n]) + ((1.0F - w) * previous_R[n]);
+  }
+
+  crossfade_position += left.size();
+
+  if (crossfade_position >= crossfade_frames) {
+    crossfading = false;
+
+    notify_crossfade_end = true;
+  }
+}
+
+void Convolver::crossfade_to(const ConvolverKernelManager::KernelData& data, const KernelSettings& ks) {
+  /**
+   * This runs in the loader thread. The state that fades out is used by the
+   * realtime thread until the current fade ends. The new kernel waits for that
+   * instead of cutting it short. Only the latest one is kept.
+   */
+
+  if (crossfading) {
+    queued_crossfade.emplace(data, ks);
+
+    return;
+  }
+
+  // The realtime thread does not use zita_previous now. It can be initialized without stopping the audio.
+
+  if (!zita_previous->init(data, blocksize, ks.ir_width, ks.autogain)) {
+    util::warning(std::format("{} Zita init failed", log_tag));
+
+    return;
+  }
+
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  std::swap(zita, zita_previous);
+
+  crossfade_position = 0U;
+
+  crossfading = ready;
+}
+
+void Convolver::start_queued_crossfade() {
+  if (destructor_called || !queued_crossfade.has_value()) {
+    return;
+  }
+
+  auto [data, ks] = std::move(*queued_crossfade);
+
+  queued_crossfade.reset();
+
+  crossfade_to(data, ks);
+}
+
+auto Convolver::on_crossfade_end([[maybe_unused]] spa_loop* loop,
+                                 [[maybe_unused]] bool async,
+                                 [[maybe_unused]] uint32_t seq,
+                                 [[maybe_unused]] const void* data,
+                                 [[maybe_unused]] size_t size,
+                                 void* user_data) -> int {
+  auto* self = static_cast<Convolver*>(user_data);
+
+  WorkerPool::post(self->worker, [self] { self->start_queued_crossfade(); }, WorkerPool::Priority::normal);
+
+  return 0;
+}
+
 void Convolver::applySofaOrientation() {
-  setup();
+  bool running = false;
+
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    running = ready && kernelIsSofa;
+  }
+
+  if (!running) {
+    setup();
+
+    return;
+  }
+
+  /**
+   * Only the nearest measurement is looked up and the new filters are faded
+   * in. While a job is pending new requests are dropped because it reads the
+   * latest target orientation when it runs.
+   */
+
+  if (sofa_update_pending.exchange(true)) {
+    return;
+  }
+
+  WorkerPool::post(
+      worker,
+      [this, ks = get_kernel_settings()] {
+        sofa_update_pending = false;
+
+        if (destructor_called) {
+          return;
+        }
+
+        load_kernel_file(ks, true, rate, true);
+      },
+      WorkerPool::Priority::normal);
 }
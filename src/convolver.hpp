@@ -24,26 +24,35 @@
 #include <qpoint.h>
 #include <qqmlintegration.h>
 #include <qtmetamacros.h>
+#include <spa/support/loop.h>
 #include <sys/types.h>
 #include <zita-convolver.h>
 #include <QString>
 #include <QThread>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
 #include <span>
 #include <string>
+#include <utility>
 #include <vector>
-#include "convolver_kernel_fft.hpp"
 #include "convolver_kernel_manager.hpp"
 #include "convolver_zita.hpp"
 #include "easyeffects_db_convolver.h"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "ramped_value.hpp"
+#include "worker_pool.hpp"
 
-class ConvolverWorker : public QObject {
+class ConvolverWorker : public WorkerContext {
   Q_OBJECT
 
  Q_SIGNALS:
-  void onNewKernel(ConvolverKernelManager::KernelData data, bool init_zita);
+  void onNewKernel(const ConvolverKernelManager::KernelData& data);
 
   void onNewChartMag(QList<QPointF> mag_L, QList<QPointF> mag_R);
 
@@ -102,6 +111,8 @@ class Convolver : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
@@ -116,6 +127,10 @@ class Convolver : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  void wait_for_pending_jobs() override;
+
+  auto is_ready() -> bool override;
+
   Q_INVOKABLE void combineKernels(const QString& kernel1, const QString& kernel2, const QString& outputName);
 
   Q_INVOKABLE void applySofaOrientation();
@@ -160,17 +175,24 @@ class Convolver : public PluginBase {
 
   bool kernel_is_initialized = false;
   bool kernelIsSofa = false;
-  bool n_samples_is_power_of_2 = true;
   bool ready = false;
   bool destructor_called = false;
   bool notify_latency = false;
+  bool notify_crossfade_end = false;
+
+  std::atomic<bool> crossfading = false;
+  std::atomic<bool> sofa_update_pending = false;
 
   uint blocksize = 512U;
   uint latency_n_frames = 0U;
+  uint crossfade_frames = 1U;
+  uint crossfade_position = 0U;
+
+  static constexpr float crossfade_time = 0.02F;  // seconds
 
   int interpPoints = 1000;
 
-  float dry = 0.0F, wet = 1.0F;
+  RampedValue dry{0.0F}, wet{1.0F};
 
   QString sofaDatabase;
   int sofaMeasurements = 1;
@@ -193,18 +215,65 @@ class Convolver : public PluginBase {
   std::vector<float> data_L, data_R;
   std::vector<float> buf_in_L, buf_in_R;
   std::vector<float> buf_out_L, buf_out_R;
+  std::vector<float> fade_L, fade_R;
 
   QList<QPointF> chartMagL, chartMagR, chartMagLfftLinear, chartMagRfftLinear, chartMagLfftLog, chartMagRfftLog;
 
   ConvolverKernelManager kernel_manager;
 
-  ConvolverKernelFFT kernel_fft;
+  /**
+   * A new SOFA orientation is loaded in the state that is not in use and then
+   * faded in while the previous one fades out.
+   */
+  std::array<ConvolverZita, 2> zita_states;
 
-  ConvolverZita zita;
+  ConvolverZita* zita = &zita_states[0];
+  ConvolverZita* zita_previous = &zita_states[1];
 
   ConvolverWorker* worker;
 
-  void load_kernel_file(const bool& init_zita, const uint& server_sampling_rate);
+  QThread* loaderThread = nullptr;
+
+  // The settings the loader thread needs. They are copied in the main thread and passed to its jobs.
+  struct KernelSettings {
+    QString name;
+    int ir_width = 100;
+    bool autogain = false;
+  };
+
+  KernelSettings kernel_settings;
+
+  std::mutex kernel_settings_mutex;
+
+  /**
+   * Only used in the loader thread. A kernel that arrives while a fade is
+   * running waits here until the realtime thread reports the end of that fade.
+   */
+  std::optional<std::pair<ConvolverKernelManager::KernelData, KernelSettings>> queued_crossfade;
+
+  auto update_kernel_settings() -> KernelSettings;
+
+  auto get_kernel_settings() -> KernelSettings;
+
+  void load_kernel_file(const KernelSettings& ks,
+                        const bool& init_zita,
+                        const uint& server_sampling_rate,
+                        const bool& crossfade = false);
+
+  void init_zita_state(const ConvolverKernelManager::KernelData& data, const KernelSettings& ks);
+
+  void process_zita(std::span<float> left, std::span<float> right);
+
+  void crossfade_to(const ConvolverKernelManager::KernelData& data, const KernelSettings& ks);
+
+  void start_queued_crossfade();
+
+  static auto on_crossfade_end(spa_loop* loop,
+                               bool async,
+                               uint32_t seq,
+                               const void* data,
+                               size_t size,
+                               void* user_data) -> int;
 
   void combine_kernels(const std::string& kernel_1_name,
                        const std::string& kernel_2_name,
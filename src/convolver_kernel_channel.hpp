@@ -0,0 +1,79 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include "aligned_allocator.hpp"
+
+/**
+ * One channel of an impulse response. The samples are immutable and reference
+ * counted, so copying a kernel between threads, signals and convolver
+ * instances does not copy them. Whoever has to change them (stereo width,
+ * autogain, normalization) calls mutable_span() and gets a private copy if the
+ * samples are still shared.
+ */
+class KernelChannel {
+ public:
+  using Samples = std::vector<float, AlignedAllocator<float>>;
+
+  KernelChannel() = default;
+
+  explicit KernelChannel(std::span<const float> values)
+      : samples(std::make_shared<Samples>(values.begin(), values.end())) {}
+
+  explicit KernelChannel(Samples&& values) : samples(std::make_shared<Samples>(std::move(values))) {}
+
+  [[nodiscard]] auto size() const -> size_t { return samples ? samples->size() : 0U; }
+
+  [[nodiscard]] auto empty() const -> bool { return size() == 0U; }
+
+  [[nodiscard]] auto data() const -> const float* { return samples ? samples->data() : nullptr; }
+
+  [[nodiscard]] auto begin() const -> const float* { return data(); }
+
+  [[nodiscard]] auto end() const -> const float* { return data() + size(); }
+
+  auto operator[](const size_t& n) const -> const float& { return (*samples)[n]; }
+
+  operator std::span<const float>() const { return {data(), size()}; }  // NOLINT(google-explicit-constructor)
+
+  auto mutable_span() -> std::span<float> {
+    if (!samples) {
+      return {};
+    }
+
+    if (samples.use_count() > 1) {
+      samples = std::make_shared<Samples>(*samples);
+    }
+
+    return *samples;
+  }
+
+  [[nodiscard]] auto use_count() const -> long { return samples.use_count(); }
+
+  [[nodiscard]] auto shares_samples_with(const KernelChannel& other) const -> bool { return samples == other.samples; }
+
+ private:
+  std::shared_ptr<Samples> samples;
+};
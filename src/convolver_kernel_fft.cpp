@@ -23,11 +23,12 @@
 #include <qpoint.h>
 #include <qtypes.h>
 #include <algorithm>
+#include <bit>
+#include <cstddef>
 #include <cmath>
-#include <cstring>
 #include <format>
 #include <mutex>
-#include <numbers>
+#include <span>
 #include <vector>
 #include "util.hpp"
 
@@ -37,8 +38,8 @@ ConvolverKernelFFT::~ConvolverKernelFFT() {
   clear_data();
 }
 
-auto ConvolverKernelFFT::calculate_fft(std::vector<float> kernel_L,
-                                       std::vector<float> kernel_R,
+auto ConvolverKernelFFT::calculate_fft(std::span<const float> kernel_L,
+                                       std::span<const float> kernel_R,
                                        float kernel_rate,
                                        int interp_points) -> void {
   if (kernel_L.empty() || kernel_R.empty() || kernel_L.size() != kernel_R.size()) {
@@ -52,10 +53,17 @@ auto ConvolverKernelFFT::calculate_fft(std::vector<float> kernel_L,
   auto spectrum_L = compute_fft_magnitude(kernel_L);
   auto spectrum_R = compute_fft_magnitude(kernel_R);
 
+  if (spectrum_L.size() < 3U || spectrum_L.size() != spectrum_R.size()) {
+    util::debug("Aborting the impulse fft calculation...");
+    return;
+  }
+
   // Initialize frequency axis
   std::vector<double> freq_axis(spectrum_L.size());
 
-  double bin_hz = static_cast<double>(kernel_rate) / static_cast<double>(kernel_L.size());
+  // The transform size is a power of two that may differ from the kernel length
+
+  const double bin_hz = static_cast<double>(kernel_rate) / static_cast<double>(2U * (spectrum_L.size() - 1U));
 
   for (uint n = 0U; n < freq_axis.size(); n++) {
     freq_axis[n] = static_cast<double>(n) * bin_hz;
@@ -109,80 +117,81 @@ auto ConvolverKernelFFT::clear_data() -> void {
   log_R.clear();
 }
 
-auto ConvolverKernelFFT::apply_hanning_window(std::vector<float>& signal) -> void {
-  for (uint n = 0U; n < signal.size(); n++) {
-    const float w = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
-                                            static_cast<float>(signal.size() - 1U)));
-    signal[n] *= w;
+auto ConvolverKernelFFT::compute_fft_magnitude(std::span<const float> kernel) -> std::vector<double> {
+  if (kernel.size() < 2U) {
+    return {};
   }
-}
 
-auto ConvolverKernelFFT::compute_fft_magnitude(std::vector<float>& kernel) -> std::vector<double> {
-  std::scoped_lock<std::mutex> lock(util::fftw_lock());
+  /**
+   * Kernels that fit in max_fft_size are zero padded to the next power of two.
+   * Longer ones are folded into max_fft_size samples by adding the samples that
+   * are fft_size apart. The DFT of the folded kernel is exactly the frequency
+   * response of the whole kernel sampled at the fft_size bins. Nothing is
+   * windowed and both cases have the same scaling.
+   */
 
-  if (kernel.empty() || kernel.size() < 2) {
-    return {};
-  }
+  const auto fft_size = std::min(std::bit_ceil(kernel.size()), max_fft_size);
 
-  apply_hanning_window(kernel);
+  std::vector<double> spectrum((fft_size / 2U) + 1U, 0.0);
 
-  std::vector<double> spectrum((kernel.size() / 2U) + 1U);
+  auto* real_input = fftwf_alloc_real(fft_size);
+  auto* complex_output = fftwf_alloc_complex(spectrum.size());
 
-  auto* complex_output = fftw_alloc_complex(spectrum.size());
+  if (real_input == nullptr || complex_output == nullptr) {
+    util::debug("FFTW buffer allocation failed!");
 
-  if (complex_output == nullptr) {
-    util::debug("FFTW complex_output allocation failed!");
+    fftwf_free(real_input);
+    fftwf_free(complex_output);
 
     return {};
   }
 
-  auto* real_input = static_cast<double*>(fftw_malloc(sizeof(double) * kernel.size()));
+  fftwf_plan plan = nullptr;
 
-  if (real_input == nullptr) {
-    util::debug("FFTW real_input allocation failed!");
+  {
+    // Only the planner is not thread safe. The transform is executed without the lock.
 
-    return {};
-  }
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
-  for (size_t n = 0; n < kernel.size(); n++) {
-    real_input[n] = static_cast<double>(kernel[n]);
+    plan = fftwf_plan_dft_r2c_1d(static_cast<int>(fft_size), real_input, complex_output, FFTW_ESTIMATE);
   }
 
-  auto* plan = fftw_plan_dft_r2c_1d(static_cast<int>(kernel.size()), real_input, complex_output, FFTW_ESTIMATE);
-
   if (plan == nullptr) {
     util::debug("FFTW plan creation failed!");
 
-    fftw_free(complex_output);
-    fftw_free(real_input);
+    fftwf_free(real_input);
+    fftwf_free(complex_output);
 
     return {};
   }
 
-  fftw_execute(plan);
+  // The kernel samples are shared and must not be changed. They are folded while copying.
+
+  std::vector<double> folded(fft_size, 0.0);
 
-  for (uint i = 0U; i < spectrum.size(); i++) {
-    float real = complex_output[i][0];
-    float img = complex_output[i][1];
+  for (size_t n = 0U; n < kernel.size(); n++) {
+    folded[n % fft_size] += static_cast<double>(kernel[n]);
+  }
 
-    float mag = std::sqrt((real * real) + (img * img));
+  std::ranges::transform(folded, real_input, [](const auto& v) { return static_cast<float>(v); });
 
-    mag /= static_cast<float>(kernel.size());
+  fftwf_execute(plan);
 
-    // Compensate Hann window
-    mag *= 2.0F;
+  for (size_t i = 0U; i < spectrum.size(); i++) {
+    const auto real = static_cast<double>(complex_output[i][0]);
+    const auto img = static_cast<double>(complex_output[i][1]);
 
-    // Single-sided correction
-    if (i == 0 || i == kernel.size() / 2) {
-      mag *= 0.5F;
-    }
+    spectrum[i] = static_cast<double>(util::linear_to_db(static_cast<float>(std::sqrt((real * real) + (img * img)))));
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
-    spectrum[i] = static_cast<double>(util::linear_to_db(mag));
+    fftwf_destroy_plan(plan);
   }
 
-  fftw_destroy_plan(plan);
-  fftw_free(complex_output);
-  fftw_free(real_input);
+  fftwf_free(real_input);
+  fftwf_free(complex_output);
 
   return spectrum;
 }
@@ -23,6 +23,8 @@
 #include <qlist.h>
 #include <qpoint.h>
 #include <qtmetamacros.h>
+#include <cstddef>
+#include <span>
 #include <vector>
 
 class ConvolverKernelFFT {
@@ -30,8 +32,8 @@ class ConvolverKernelFFT {
   ConvolverKernelFFT();
   ~ConvolverKernelFFT();
 
-  auto calculate_fft(std::vector<float> kernel_L,
-                     std::vector<float> kernel_R,
+  auto calculate_fft(std::span<const float> kernel_L,
+                     std::span<const float> kernel_R,
                      float kernel_rate,
                      int interp_points = 1000) -> void;
 
@@ -43,9 +45,9 @@ class ConvolverKernelFFT {
   QList<QPointF> log_R;
 
  private:
-  static auto apply_hanning_window(std::vector<float>& signal) -> void;
+  static constexpr size_t max_fft_size = 32768U;
 
-  static auto compute_fft_magnitude(std::vector<float>& kernel) -> std::vector<double>;
+  static auto compute_fft_magnitude(std::span<const float> kernel) -> std::vector<double>;
 
   static auto normalize_spectrum(std::vector<double>& spectrum) -> void;
 };
@@ -18,7 +18,6 @@
  */
 
 #include "convolver_kernel_manager.hpp"
-#include <mysofa.h>
 #include <qstandardpaths.h>
 #include <qtypes.h>
 #include <sndfile.h>
@@ -31,11 +30,16 @@
 #include <filesystem>
 #include <format>
 #include <memory>
+#include <mutex>
 #include <numeric>
 #include <sndfile.hh>
+#include <span>
 #include <string>
+#include <system_error>
 #include <utility>
 #include <vector>
+#include "convolver_kernel_channel.hpp"
+#include "convolver_sofa_database.hpp"
 #include "db_manager.hpp"
 #include "easyeffects_db_convolver.h"
 #include "pipeline_type.hpp"
@@ -80,7 +84,7 @@ auto ConvolverKernelManager::KernelData::sampleCount() const -> size_t {
   return channel_L.size();
 }
 
-auto ConvolverKernelManager::loadKernel(const std::string& name) -> KernelData {
+auto ConvolverKernelManager::loadKernel(const std::string& name, const uint& target_rate) -> KernelData {
   if (name.empty()) {
     util::warning("Kernel name is empty");
 
@@ -94,10 +98,29 @@ auto ConvolverKernelManager::loadKernel(const std::string& name) -> KernelData {
     return KernelData{};
   }
 
-  KernelData kernel_data;
-
   const auto extension = getFileExtension(file_path);
 
+  /**
+   * The SOFA kernels depend on the orientation chosen in each instance. Only
+   * the impulse files are shared.
+   */
+
+  const auto can_share = (extension != sofa_ext);
+
+  std::error_code ec;
+
+  const auto last_write_time = std::filesystem::last_write_time(file_path, ec);
+
+  if (can_share) {
+    if (auto cached = kernel_cache.find(file_path, last_write_time, target_rate); cached.isValid()) {
+      util::debug(std::format("Kernel '{}' is already in memory", name));
+
+      return cached;
+    }
+  }
+
+  KernelData kernel_data;
+
   if (extension == sofa_ext) {
     kernel_data = readSofaKernelFile(file_path);
   } else {
@@ -115,9 +138,56 @@ auto ConvolverKernelManager::loadKernel(const std::string& name) -> KernelData {
   util::debug(std::format("Loaded kernel '{}': {} Hz, {} samples, {:.3f}s", name, kernel_data.rate,
                           kernel_data.sampleCount(), kernel_data.duration()));
 
+  if (target_rate != 0U && kernel_data.rate != target_rate) {
+    kernel_data = resampleKernel(kernel_data, target_rate);
+  }
+
+  if (can_share) {
+    kernel_cache.insert(file_path, last_write_time, target_rate, kernel_data);
+  }
+
   return kernel_data;
 }
 
+auto ConvolverKernelManager::KernelCache::find(const std::string& file_path,
+                                               const std::filesystem::file_time_type& last_write_time,
+                                               const uint& rate) -> KernelData {
+  std::scoped_lock<std::mutex> lock(mutex);
+
+  remove_unused();
+
+  for (const auto& entry : entries) {
+    if (entry.file_path == file_path && entry.last_write_time == last_write_time && entry.rate == rate) {
+      return entry.kernel;
+    }
+  }
+
+  return KernelData{};
+}
+
+void ConvolverKernelManager::KernelCache::insert(const std::string& file_path,
+                                                 const std::filesystem::file_time_type& last_write_time,
+                                                 const uint& rate,
+                                                 const KernelData& kernel) {
+  std::scoped_lock<std::mutex> lock(mutex);
+
+  remove_unused();
+
+  std::erase_if(entries, [&](const auto& entry) { return entry.file_path == file_path && entry.rate == rate; });
+
+  entries.push_back({.file_path = file_path, .last_write_time = last_write_time, .rate = rate, .kernel = kernel});
+}
+
+void ConvolverKernelManager::KernelCache::remove_unused() {
+  // Nobody else references these samples anymore. The right channel of a mono kernel is a second reference.
+
+  std::erase_if(entries, [](const auto& entry) {
+    const auto& kernel = entry.kernel;
+
+    return kernel.channel_L.use_count() <= (kernel.channel_R.shares_samples_with(kernel.channel_L) ? 2 : 1);
+  });
+}
+
 auto ConvolverKernelManager::combineKernels(const std::string& kernel1_name,
                                             const std::string& kernel2_name,
                                             const std::string& output_name) -> bool {
@@ -143,15 +213,12 @@ auto ConvolverKernelManager::combineKernels(const std::string& kernel1_name,
   const auto resampled_kernel1 = (kernel1.rate != target_rate) ? resampleKernel(kernel1, target_rate) : kernel1;
   const auto resampled_kernel2 = (kernel2.rate != target_rate) ? resampleKernel(kernel2, target_rate) : kernel2;
 
-  auto combined_kernel_L = directConvolution(resampled_kernel1.channel_L, resampled_kernel2.channel_L);
-  auto combined_kernel_R = directConvolution(resampled_kernel1.channel_R, resampled_kernel2.channel_R);
-
   KernelData combined_kernel;
 
   combined_kernel.rate = target_rate;
   combined_kernel.channels = resampled_kernel1.channels;
-  combined_kernel.channel_L = std::move(combined_kernel_L);
-  combined_kernel.channel_R = std::move(combined_kernel_R);
+  combined_kernel.channel_L = directConvolution(resampled_kernel1.channel_L, resampled_kernel2.channel_L);
+  combined_kernel.channel_R = directConvolution(resampled_kernel1.channel_R, resampled_kernel2.channel_R);
 
   if (combined_kernel.channels == 4) {
     combined_kernel.channel_LR = directConvolution(resampled_kernel1.channel_LR, resampled_kernel2.channel_LR);
@@ -238,6 +305,8 @@ auto ConvolverKernelManager::resampleKernel(const KernelData& kernel, const uint
 
   resampled_kernel.rate = target_rate;
 
+  resampled_kernel.charts = std::make_shared<KernelData::Charts>();
+
   util::debug(
       std::format("Resampling kernel '{}' from {} Hz to {} Hz", kernel.name.toStdString(), kernel.rate, target_rate));
 
@@ -245,26 +314,26 @@ auto ConvolverKernelManager::resampleKernel(const KernelData& kernel, const uint
 
   auto resampler = std::make_unique<Resampler>(kernel.rate, target_rate);
 
-  resampled_kernel.channel_L = resampler->process(kernel.channel_L);
+  resampled_kernel.channel_L = KernelChannel(resampler->process(kernel.channel_L));
 
   // Resample right channel
 
   resampler = std::make_unique<Resampler>(kernel.rate, target_rate);
 
-  resampled_kernel.channel_R = resampler->process(kernel.channel_R);
+  resampled_kernel.channel_R = KernelChannel(resampler->process(kernel.channel_R));
 
   if (kernel.channels == 4) {
     // Resample LR channel
 
     resampler = std::make_unique<Resampler>(kernel.rate, target_rate);
 
-    resampled_kernel.channel_LR = resampler->process(kernel.channel_LR);
+    resampled_kernel.channel_LR = KernelChannel(resampler->process(kernel.channel_LR));
 
     // Resample right channel
 
     resampler = std::make_unique<Resampler>(kernel.rate, target_rate);
 
-    resampled_kernel.channel_RL = resampler->process(kernel.channel_RL);
+    resampled_kernel.channel_RL = KernelChannel(resampler->process(kernel.channel_RL));
   }
 
   return resampled_kernel;
@@ -302,12 +371,12 @@ void ConvolverKernelManager::normalizeKernel(KernelData& kernel) {
   // Normalize both channels
   const auto normalize_lambda = [peak](auto& sample) { sample /= peak; };
 
-  std::ranges::for_each(kernel.channel_L, normalize_lambda);
-  std::ranges::for_each(kernel.channel_R, normalize_lambda);
+  std::ranges::for_each(kernel.channel_L.mutable_span(), normalize_lambda);
+  std::ranges::for_each(kernel.channel_R.mutable_span(), normalize_lambda);
 
   if (kernel.channels == 4) {
-    std::ranges::for_each(kernel.channel_LR, normalize_lambda);
-    std::ranges::for_each(kernel.channel_RL, normalize_lambda);
+    std::ranges::for_each(kernel.channel_LR.mutable_span(), normalize_lambda);
+    std::ranges::for_each(kernel.channel_RL.mutable_span(), normalize_lambda);
   }
 }
 
@@ -398,29 +467,45 @@ auto ConvolverKernelManager::readKernelFile(const std::string& file_path) -> Ker
     kernel_data.rate = sndfile.samplerate();
     kernel_data.original_rate = sndfile.samplerate();
     kernel_data.channels = sndfile.channels() == 1 ? 2 : sndfile.channels();
-    kernel_data.channel_L.resize(sndfile.frames());
-    kernel_data.channel_R.resize(sndfile.frames());
+
+    const auto frames = static_cast<size_t>(sndfile.frames());
+
+    KernelChannel::Samples left(frames), right, left_right, right_left;
+
+    if (sndfile.channels() != 1) {
+      right.resize(frames);
+    }
 
     if (kernel_data.channels == 4) {
-      kernel_data.channel_LR.resize(sndfile.frames());
-      kernel_data.channel_RL.resize(sndfile.frames());
+      left_right.resize(frames);
+      right_left.resize(frames);
     }
 
-    for (size_t i = 0; i < static_cast<size_t>(sndfile.frames()); ++i) {
+    for (size_t i = 0; i < frames; ++i) {
       if (sndfile.channels() == 1) {
-        kernel_data.channel_L[i] = buffer[i];
-        kernel_data.channel_R[i] = buffer[i];
+        left[i] = buffer[i];
       } else if (sndfile.channels() == 2) {
-        kernel_data.channel_L[i] = buffer[2 * i];
-        kernel_data.channel_R[i] = buffer[(2 * i) + 1];
+        left[i] = buffer[2 * i];
+        right[i] = buffer[(2 * i) + 1];
       } else if (sndfile.channels() == 4) {
-        kernel_data.channel_L[i] = buffer[4 * i];
-        kernel_data.channel_LR[i] = buffer[(4 * i) + 1];
-        kernel_data.channel_RL[i] = buffer[(4 * i) + 2];
-        kernel_data.channel_R[i] = buffer[(4 * i) + 3];
+        left[i] = buffer[4 * i];
+        left_right[i] = buffer[(4 * i) + 1];
+        right_left[i] = buffer[(4 * i) + 2];
+        right[i] = buffer[(4 * i) + 3];
       }
     }
 
+    kernel_data.channel_L = KernelChannel(std::move(left));
+
+    // Mono files use the same samples in both channels
+
+    kernel_data.channel_R = (sndfile.channels() == 1) ? kernel_data.channel_L : KernelChannel(std::move(right));
+
+    if (kernel_data.channels == 4) {
+      kernel_data.channel_LR = KernelChannel(std::move(left_right));
+      kernel_data.channel_RL = KernelChannel(std::move(right_left));
+    }
+
   } catch (const std::exception& e) {
     util::warning(std::format("Exception while reading kernel file {}: {}", file_path, e.what()));
   }
@@ -454,7 +539,7 @@ auto ConvolverKernelManager::validateKernel(const KernelData& kernel) -> bool {
     return false;
   }
 
-  const auto has_invalid_values = [](const std::vector<float>& channel) {
+  const auto has_invalid_values = [](std::span<const float> channel) {
     return std::ranges::any_of(channel, [](const auto& value) { return std::isnan(value) || std::isinf(value); });
   };
 
@@ -492,15 +577,14 @@ auto ConvolverKernelManager::findKernelInDirectory(const std::filesystem::path&
   return "";
 }
 
-auto ConvolverKernelManager::directConvolution(const std::vector<float>& a, const std::vector<float>& b)
-    -> std::vector<float> {
+auto ConvolverKernelManager::directConvolution(std::span<const float> a, std::span<const float> b) -> KernelChannel {
   if (a.empty() || b.empty()) {
     return {};
   }
 
   const auto output_size = a.size() + b.size() - 1;
 
-  std::vector<float> result(output_size, 0.0F);
+  KernelChannel::Samples result(output_size, 0.0F);
 
   std::vector<size_t> indices(output_size);
 
@@ -526,7 +610,7 @@ auto ConvolverKernelManager::directConvolution(const std::vector<float>& a, cons
   std::for_each(std::execution::par_unseq, indices.begin(), indices.end(), each);
 #endif
 
-  return result;
+  return KernelChannel(std::move(result));
 }
 
 auto ConvolverKernelManager::getFileExtension(const std::string& file_path) -> std::string {
@@ -539,175 +623,36 @@ auto ConvolverKernelManager::getFileExtension(const std::string& file_path) -> s
   return ext;
 }
 
-// https://www.sofaconventions.org/mediawiki/index.php/SOFA_specifications
-
 auto ConvolverKernelManager::readSofaKernelFile(const std::string& file_path) -> KernelData {
-  KernelData kernel_data;
-
   try {
-    int error = 0;
-
-    struct MYSOFA_HRTF* hrtf = mysofa_load(file_path.c_str(), &error);
+    // Holding the database keeps it in memory so a new orientation does not read the file again.
 
-    if (error != MYSOFA_OK) {
-      util::warning(std::format("Error while trying to load the sofa file: {}", util::mysofa_error_to_string(error)));
-    }
-
-    if (!hrtf) {
-      util::warning(std::format("Failed to load SOFA file: {} - Error: {}", file_path, error));
-      return kernel_data;
-    }
-
-    // Validate the HRTF structure
-    if (mysofa_check(hrtf) != MYSOFA_OK) {
-      util::warning(std::format("SOFA file validation failed: {}", file_path));
-    }
-
-    kernel_data.rate = 48000;  // Default fallback
-    kernel_data.original_rate = kernel_data.rate;
-
-    if (hrtf->DataSamplingRate.elements > 0 && hrtf->DataSamplingRate.values) {
-      kernel_data.rate = static_cast<uint>(hrtf->DataSamplingRate.values[0]);
-      kernel_data.original_rate = kernel_data.rate;
-
-      util::debug(std::format("Found SOFA sampling rate: {} Hz", kernel_data.rate));
-    }
-
-    // Get dimensions
-    int M = hrtf->M;  // Number of measurements (source positions)
-    int R = hrtf->R;  // Number of receivers (ears, usually 2)
-    int N = hrtf->N;  // Filter length (samples per IR)
-    int E = hrtf->E;  // Number of emitters
-
-    util::debug(std::format("SOFA file measurements: {}", M));
-    util::debug(std::format("SOFA file receivers: {}", R));
-    util::debug(std::format("SOFA file filter length: {}", N));
-    util::debug(std::format("SOFA file emitters: {}", E));
-
-    // Set SOFA metadata
-    kernel_data.is_sofa = true;
-    kernel_data.sofaMetadata.measurements = M;
-    kernel_data.sofaMetadata.database = mysofa_getAttribute(hrtf->attributes, const_cast<char*>("DatabaseName"));
-
-    util::debug(std::format("Database: {}", kernel_data.sofaMetadata.database.toStdString()));
-
-    if (M <= 0 || R < 1 || N <= 0) {
-      util::warning(std::format("Invalid SOFA file structure: M={}, R={}, N={}", M, R, N));
-
-      mysofa_free(hrtf);
-
-      return kernel_data;
-    }
-
-    int m = 0;
-
-    mysofa_tocartesian(hrtf);
-
-    struct MYSOFA_LOOKUP* lookup = mysofa_lookup_init(hrtf);
-
-    if (!lookup) {
-      util::warning("Failed to create SOFA lookup structure.");
-    } else {
-      util::debug(std::format("Theta min: {}, max: {}", lookup->theta_min, lookup->theta_max));
-      util::debug(std::format("Phi min: {}, max: {}", lookup->phi_min, lookup->phi_max));
-      util::debug(std::format("Radius min: {}, max: {}", lookup->radius_min, lookup->radius_max));
-
-      kernel_data.sofaMetadata.min_azimuth = lookup->phi_min;
-      kernel_data.sofaMetadata.max_azimuth = lookup->phi_max;
-      kernel_data.sofaMetadata.min_elevation = lookup->theta_min;
-      kernel_data.sofaMetadata.max_elevation = lookup->theta_max;
-      kernel_data.sofaMetadata.min_radius = lookup->radius_min;
-      kernel_data.sofaMetadata.max_radius = lookup->radius_max;
-
-      float coords[3] = {static_cast<float>(settings->targetSofaAzimuth()),
-                         static_cast<float>(settings->targetSofaElevation()),
-                         static_cast<float>(settings->targetSofaRadius())};
+    sofa_database = ConvolverSofaDatabase::open(file_path);
 
-      mysofa_s2c(coords);
-
-      m = mysofa_lookup(lookup, coords);
-
-      kernel_data.sofaMetadata.index = m;
-
-      util::debug(std::format(
-          "For the desired azimuth = {}, elevation = {} and radius = {} the nearest SOFA measurement index is {}",
-          settings->targetSofaAzimuth(), settings->targetSofaElevation(), settings->targetSofaRadius(), m));
-
-      mysofa_lookup_free(lookup);
-
-      mysofa_tospherical(hrtf);
-
-      float selected_azimuth = hrtf->SourcePosition.values[(m * 3) + 0];
-      float selected_elevation = hrtf->SourcePosition.values[(m * 3) + 1];
-      float selected_radius = hrtf->SourcePosition.values[(m * 3) + 2];
-
-      kernel_data.sofaMetadata.azimuth = selected_azimuth;
-      kernel_data.sofaMetadata.elevation = selected_elevation;
-      kernel_data.sofaMetadata.radius = selected_radius;
-
-      util::debug(std::format("For measurement {} we have azimuth = {}, elevation = {} and radius = {}", m,
-                              selected_azimuth, selected_elevation, selected_radius));
+    if (sofa_database == nullptr) {
+      return KernelData{};
     }
 
-    const int RxE_times_N = R * E * N;
-
-    if (E == 1) {
-      kernel_data.channel_L.resize(N);
-      kernel_data.channel_R.resize(N);
-      kernel_data.channels = 2;
+    const auto azimuth = static_cast<float>(settings->targetSofaAzimuth());
+    const auto elevation = static_cast<float>(settings->targetSofaElevation());
+    const auto radius = static_cast<float>(settings->targetSofaRadius());
 
-      // Left ear (receiver 0)
-      for (int n = 0; n < N; n++) {
-        kernel_data.channel_L[n] = hrtf->DataIR.values[(m * RxE_times_N) + (0 * N) + n];
-      }
+    const auto m = sofa_database->nearest(azimuth, elevation, radius);
 
-      // Right ear (receiver 1)
-      if (R > 1) {
-        for (int n = 0; n < N; n++) {
-          kernel_data.channel_R[n] = hrtf->DataIR.values[(m * RxE_times_N) + (1 * N) + n];
-        }
-      } else {
-        kernel_data.channel_R = kernel_data.channel_L;
-      }
-    }
+    util::debug(std::format(
+        "For the desired azimuth = {}, elevation = {} and radius = {} the nearest SOFA measurement index is {}",
+        azimuth, elevation, radius, m));
 
-    if (R == 2 && E == 2) {
-      // Assuming it is True Stereo HRTF: 4 channels
+    auto kernel_data = sofa_database->measurement(m);
 
-      kernel_data.channels = 4;
-      kernel_data.channel_L.resize(N);   // LL
-      kernel_data.channel_LR.resize(N);  // LR
-      kernel_data.channel_RL.resize(N);  // RL
-      kernel_data.channel_R.resize(N);   // RR
-
-      // Left Channel (LL: Emitter 0 to Receiver 0)
-      for (int n = 0; n < N; n++) {
-        kernel_data.channel_L[n] = hrtf->DataIR.values[(m * RxE_times_N) + (0 * E * N) + (0 * N) + n];
-      }
-
-      // Left-to-Right Crosstalk (LR: Emitter 0 to Receiver 1)
-      for (int n = 0; n < N; n++) {
-        kernel_data.channel_LR[n] = hrtf->DataIR.values[(m * RxE_times_N) + (1 * E * N) + (0 * N) + n];
-      }
-
-      // Right-to-Left Crosstalk (RL: Emitter 1 to Receiver 0)
-      for (int n = 0; n < N; n++) {
-        kernel_data.channel_RL[n] = hrtf->DataIR.values[(m * RxE_times_N) + (0 * E * N) + (1 * N) + n];
-      }
-
-      // Right Channel (RR: Emitter 1 to Receiver 1)
-      for (int n = 0; n < N; n++) {
-        kernel_data.channel_R[n] = hrtf->DataIR.values[(m * RxE_times_N) + (1 * E * N) + (1 * N) + n];
-      }
-    }
-
-    mysofa_free(hrtf);
-
-    util::debug(std::format("Successfully loaded SOFA file '{}': {} Hz, {} samples", file_path, kernel_data.rate, N));
+    util::debug(std::format("For measurement {} we have azimuth = {}, elevation = {} and radius = {}", m,
+                            kernel_data.sofaMetadata.azimuth, kernel_data.sofaMetadata.elevation,
+                            kernel_data.sofaMetadata.radius));
 
+    return kernel_data;
   } catch (const std::exception& e) {
     util::warning(std::format("Exception while reading SOFA file {}: {}", file_path, e.what()));
   }
 
-  return kernel_data;
+  return KernelData{};
 }
@@ -19,15 +19,23 @@
 
 #pragma once
 
+#include <qlist.h>
+#include <qpoint.h>
 #include <qtypes.h>
 #include <QString>
 #include <cstddef>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <string>
 #include <vector>
+#include "convolver_kernel_channel.hpp"
 #include "easyeffects_db_convolver.h"
 #include "pipeline_type.hpp"
 
+class ConvolverSofaDatabase;
+
 class ConvolverKernelManager {
  public:
   static constexpr std::string irs_ext = ".irs";
@@ -43,10 +51,10 @@ class ConvolverKernelManager {
     QString name;
     QString file_path;
 
-    std::vector<float> channel_L;
-    std::vector<float> channel_LR;
-    std::vector<float> channel_RL;
-    std::vector<float> channel_R;
+    KernelChannel channel_L;
+    KernelChannel channel_LR;
+    KernelChannel channel_RL;
+    KernelChannel channel_R;
 
     struct SofaMetadata {
       QString database;
@@ -67,6 +75,22 @@ class ConvolverKernelManager {
 
     } sofaMetadata;
 
+    /**
+     * Chart series computed from the samples as they were loaded. They are
+     * shared by the copies of this kernel so they are computed only once.
+     */
+    struct Charts {
+      std::mutex mutex;
+
+      int interp_points = 0;
+
+      QList<QPointF> mag_L, mag_R;
+
+      QList<QPointF> linear_L, linear_R, log_L, log_R;
+    };
+
+    std::shared_ptr<Charts> charts = std::make_shared<Charts>();
+
     [[nodiscard]] auto isValid() const -> bool;
 
     [[nodiscard]] auto duration() const -> double;
@@ -76,7 +100,12 @@ class ConvolverKernelManager {
 
   ConvolverKernelManager(DbConvolver* settings, const PipelineType& pipeline_type);
 
-  auto loadKernel(const std::string& name) -> KernelData;
+  /**
+   * When target_rate is not zero the kernel is resampled to it. Kernels that
+   * are still in use by another instance are returned without being read again
+   * and share the same samples.
+   */
+  auto loadKernel(const std::string& name, const uint& target_rate = 0U) -> KernelData;
 
   auto combineKernels(const std::string& kernel1_name, const std::string& kernel2_name, const std::string& output_name)
       -> bool;
@@ -92,6 +121,40 @@ class ConvolverKernelManager {
   auto readSofaKernelFile(const std::string& file_path) -> KernelData;
 
  private:
+  /**
+   * Kernels in use by the convolver instances. An entry is dropped once the
+   * cache holds the only reference to its samples.
+   */
+  class KernelCache {
+   public:
+    auto find(const std::string& file_path, const std::filesystem::file_time_type& last_write_time, const uint& rate)
+        -> KernelData;
+
+    void insert(const std::string& file_path,
+                const std::filesystem::file_time_type& last_write_time,
+                const uint& rate,
+                const KernelData& kernel);
+
+   private:
+    struct Entry {
+      std::string file_path;
+
+      std::filesystem::file_time_type last_write_time;
+
+      uint rate = 0U;
+
+      KernelData kernel;
+    };
+
+    std::mutex mutex;
+
+    std::vector<Entry> entries;
+
+    void remove_unused();
+  };
+
+  inline static KernelCache kernel_cache;
+
   DbConvolver* settings = nullptr;
 
   PipelineType pipeline_type;
@@ -101,6 +164,8 @@ class ConvolverKernelManager {
 
   std::vector<std::string> system_data_dir_irs;
 
+  std::shared_ptr<ConvolverSofaDatabase> sofa_database;
+
   static auto readKernelFile(const std::string& file_path) -> KernelData;
 
   static auto validateKernel(const KernelData& kernel) -> bool;
@@ -108,7 +173,7 @@ class ConvolverKernelManager {
   static auto findKernelInDirectory(const std::filesystem::path& directory, const std::string& kernel_name)
       -> std::string;
 
-  static auto directConvolution(const std::vector<float>& a, const std::vector<float>& b) -> std::vector<float>;
+  static auto directConvolution(std::span<const float> a, std::span<const float> b) -> KernelChannel;
 
   static auto getFileExtension(const std::string& file_path) -> std::string;
 };
@@ -0,0 +1,217 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "convolver_sofa_database.hpp"
+#include <mysofa.h>
+#include <qtypes.h>
+#include <QString>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "convolver_kernel_channel.hpp"
+#include "convolver_kernel_manager.hpp"
+#include "util.hpp"
+
+ConvolverSofaDatabase::ConvolverSofaDatabase(MYSOFA_HRTF* hrtf, MYSOFA_LOOKUP* lookup) : hrtf(hrtf), lookup(lookup) {
+  if (hrtf->DataSamplingRate.elements > 0 && hrtf->DataSamplingRate.values) {
+    rate = static_cast<uint>(hrtf->DataSamplingRate.values[0]);
+  }
+
+  database_name = mysofa_getAttribute(hrtf->attributes, const_cast<char*>("DatabaseName"));
+
+  // The lookup needs cartesian positions. The spherical ones are kept to describe the selected measurement.
+
+  spherical_positions.assign(hrtf->SourcePosition.values, hrtf->SourcePosition.values + (hrtf->M * 3));
+
+  for (size_t n = 0U; n < spherical_positions.size(); n += 3U) {
+    mysofa_c2s(&spherical_positions[n]);
+  }
+}
+
+ConvolverSofaDatabase::~ConvolverSofaDatabase() {
+  if (lookup != nullptr) {
+    mysofa_lookup_free(lookup);
+  }
+
+  mysofa_free(hrtf);
+}
+
+auto ConvolverSofaDatabase::open(const std::string& file_path) -> std::shared_ptr<ConvolverSofaDatabase> {
+  std::error_code ec;
+
+  const auto last_write_time = std::filesystem::last_write_time(file_path, ec);
+
+  std::scoped_lock<std::mutex> lock(cache_mutex);
+
+  std::erase_if(cache, [](const auto& entry) { return entry.database.expired(); });
+
+  for (const auto& entry : cache) {
+    if (entry.file_path == file_path && entry.last_write_time == last_write_time) {
+      if (auto database = entry.database.lock()) {
+        util::debug(std::format("SOFA file '{}' is already in memory", file_path));
+
+        return database;
+      }
+    }
+  }
+
+  auto database = load(file_path);
+
+  if (database != nullptr) {
+    std::erase_if(cache, [&](const auto& entry) { return entry.file_path == file_path; });
+
+    cache.push_back({.file_path = file_path, .last_write_time = last_write_time, .database = database});
+  }
+
+  return database;
+}
+
+// https://www.sofaconventions.org/mediawiki/index.php/SOFA_specifications
+
+auto ConvolverSofaDatabase::load(const std::string& file_path) -> std::shared_ptr<ConvolverSofaDatabase> {
+  int error = 0;
+
+  struct MYSOFA_HRTF* hrtf = mysofa_load(file_path.c_str(), &error);
+
+  if (error != MYSOFA_OK) {
+    util::warning(std::format("Error while trying to load the sofa file: {}", util::mysofa_error_to_string(error)));
+  }
+
+  if (!hrtf) {
+    util::warning(std::format("Failed to load SOFA file: {} - Error: {}", file_path, error));
+    return nullptr;
+  }
+
+  // Validate the HRTF structure
+  if (mysofa_check(hrtf) != MYSOFA_OK) {
+    util::warning(std::format("SOFA file validation failed: {}", file_path));
+  }
+
+  util::debug(std::format("SOFA file measurements: {}", hrtf->M));
+  util::debug(std::format("SOFA file receivers: {}", hrtf->R));
+  util::debug(std::format("SOFA file filter length: {}", hrtf->N));
+  util::debug(std::format("SOFA file emitters: {}", hrtf->E));
+
+  if (hrtf->M <= 0 || hrtf->R < 1 || hrtf->N <= 0) {
+    util::warning(std::format("Invalid SOFA file structure: M={}, R={}, N={}", hrtf->M, hrtf->R, hrtf->N));
+
+    mysofa_free(hrtf);
+
+    return nullptr;
+  }
+
+  mysofa_tocartesian(hrtf);
+
+  struct MYSOFA_LOOKUP* lookup = mysofa_lookup_init(hrtf);
+
+  if (!lookup) {
+    util::warning("Failed to create SOFA lookup structure.");
+  } else {
+    util::debug(std::format("Theta min: {}, max: {}", lookup->theta_min, lookup->theta_max));
+    util::debug(std::format("Phi min: {}, max: {}", lookup->phi_min, lookup->phi_max));
+    util::debug(std::format("Radius min: {}, max: {}", lookup->radius_min, lookup->radius_max));
+  }
+
+  return std::shared_ptr<ConvolverSofaDatabase>(new ConvolverSofaDatabase(hrtf, lookup));
+}
+
+auto ConvolverSofaDatabase::nearest(const float& azimuth, const float& elevation, const float& radius) -> int {
+  if (lookup == nullptr) {
+    return 0;
+  }
+
+  float coords[3] = {azimuth, elevation, radius};
+
+  mysofa_s2c(coords);
+
+  std::scoped_lock<std::mutex> lock(lookup_mutex);
+
+  const auto m = mysofa_lookup(lookup, coords);
+
+  return (m >= 0 && m < static_cast<int>(hrtf->M)) ? m : 0;
+}
+
+auto ConvolverSofaDatabase::measurement(const int& m) const -> ConvolverKernelManager::KernelData {
+  ConvolverKernelManager::KernelData kernel_data;
+
+  const int R = static_cast<int>(hrtf->R);  // Number of receivers (ears, usually 2)
+  const int N = static_cast<int>(hrtf->N);  // Filter length (samples per IR)
+  const int E = static_cast<int>(hrtf->E);  // Number of emitters
+
+  kernel_data.rate = rate;
+  kernel_data.original_rate = rate;
+
+  kernel_data.is_sofa = true;
+  kernel_data.sofaMetadata.database = database_name;
+  kernel_data.sofaMetadata.measurements = static_cast<int>(hrtf->M);
+  kernel_data.sofaMetadata.index = m;
+
+  kernel_data.sofaMetadata.azimuth = spherical_positions[(m * 3) + 0];
+  kernel_data.sofaMetadata.elevation = spherical_positions[(m * 3) + 1];
+  kernel_data.sofaMetadata.radius = spherical_positions[(m * 3) + 2];
+
+  if (lookup != nullptr) {
+    kernel_data.sofaMetadata.min_azimuth = lookup->phi_min;
+    kernel_data.sofaMetadata.max_azimuth = lookup->phi_max;
+    kernel_data.sofaMetadata.min_elevation = lookup->theta_min;
+    kernel_data.sofaMetadata.max_elevation = lookup->theta_max;
+    kernel_data.sofaMetadata.min_radius = lookup->radius_min;
+    kernel_data.sofaMetadata.max_radius = lookup->radius_max;
+  }
+
+  const int RxE_times_N = R * E * N;
+
+  const auto* values = hrtf->DataIR.values;
+
+  // The impulse response of the measurement m from the emitter e to the receiver r.
+  auto ir = [&](const int& r, const int& e) {
+    const auto* first = values + (m * RxE_times_N) + (r * E * N) + (e * N);
+
+    return KernelChannel(std::span<const float>(first, static_cast<size_t>(N)));
+  };
+
+  if (E == 1) {
+    kernel_data.channels = 2;
+
+    // Left ear (receiver 0)
+    kernel_data.channel_L = ir(0, 0);
+
+    // Right ear (receiver 1)
+    kernel_data.channel_R = (R > 1) ? ir(1, 0) : kernel_data.channel_L;
+  }
+
+  if (R == 2 && E == 2) {
+    // Assuming it is True Stereo HRTF: 4 channels
+
+    kernel_data.channels = 4;
+
+    kernel_data.channel_L = ir(0, 0);   // LL: Emitter 0 to Receiver 0
+    kernel_data.channel_LR = ir(1, 0);  // LR: Emitter 0 to Receiver 1
+    kernel_data.channel_RL = ir(0, 1);  // RL: Emitter 1 to Receiver 0
+    kernel_data.channel_R = ir(1, 1);   // RR: Emitter 1 to Receiver 1
+  }
+
+  return kernel_data;
+}
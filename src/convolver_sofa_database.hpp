@@ -0,0 +1,88 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <mysofa.h>
+#include <qtypes.h>
+#include <QString>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "convolver_kernel_manager.hpp"
+
+/**
+ * A SOFA file kept in memory together with the spatial index libmysofa builds
+ * over its measurement positions. Changing the orientation only needs a
+ * nearest neighbour search and a copy of the selected impulse responses, so
+ * the file is not read again.
+ */
+class ConvolverSofaDatabase {
+ public:
+  ConvolverSofaDatabase(const ConvolverSofaDatabase&) = delete;
+  auto operator=(const ConvolverSofaDatabase&) -> ConvolverSofaDatabase& = delete;
+  ConvolverSofaDatabase(const ConvolverSofaDatabase&&) = delete;
+  auto operator=(const ConvolverSofaDatabase&&) -> ConvolverSofaDatabase& = delete;
+  ~ConvolverSofaDatabase();
+
+  /**
+   * Returns the database already opened by another instance when the file did
+   * not change since then. Returns nullptr if the file can not be used.
+   */
+  static auto open(const std::string& file_path) -> std::shared_ptr<ConvolverSofaDatabase>;
+
+  /**
+   * Index of the measurement closest to the given position. Azimuth and
+   * elevation are in degrees and the radius in meters.
+   */
+  auto nearest(const float& azimuth, const float& elevation, const float& radius) -> int;
+
+  [[nodiscard]] auto measurement(const int& m) const -> ConvolverKernelManager::KernelData;
+
+ private:
+  ConvolverSofaDatabase(MYSOFA_HRTF* hrtf, MYSOFA_LOOKUP* lookup);
+
+  struct CacheEntry {
+    std::string file_path;
+
+    std::filesystem::file_time_type last_write_time;
+
+    std::weak_ptr<ConvolverSofaDatabase> database;
+  };
+
+  inline static std::mutex cache_mutex;
+
+  inline static std::vector<CacheEntry> cache;
+
+  std::mutex lookup_mutex;
+
+  MYSOFA_HRTF* hrtf = nullptr;  // Positions in cartesian coordinates as required by the lookup
+
+  MYSOFA_LOOKUP* lookup = nullptr;
+
+  uint rate = 48000U;
+
+  QString database_name;
+
+  std::vector<float> spherical_positions;  // azimuth, elevation and radius of each measurement
+
+  static auto load(const std::string& file_path) -> std::shared_ptr<ConvolverSofaDatabase>;
+};
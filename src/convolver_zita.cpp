@@ -28,7 +28,9 @@
 #include <mutex>
 #include <span>
 #include <thread>
+#include "convolver_kernel_channel.hpp"
 #include "convolver_kernel_manager.hpp"
+#include "rt_log.hpp"
 #include "util.hpp"
 
 namespace {
@@ -36,16 +38,17 @@ namespace {
 constexpr auto ZITA_SCHED_PRIORITY = 0;
 constexpr auto ZITA_SCHED_CLASS = SCHED_FIFO;
 
+// Zita only reads the impulse response but its api takes non-const pointers.
+auto zita_data(const KernelChannel& channel) -> float* {
+  return const_cast<float*>(channel.data());
+}
+
 }  // namespace
 
 ConvolverZita::ConvolverZita() = default;
 
 ConvolverZita::~ConvolverZita() {
-  stop();
-
-  delete conv;
-
-  conv = nullptr;
+  release();
 }
 
 void ConvolverZita::stop() {
@@ -62,21 +65,38 @@ void ConvolverZita::stop() {
   }
 }
 
-auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
+void ConvolverZita::release() {
+  stop();
+
+  std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+  delete conv;
+
+  conv = nullptr;
+}
+
+auto ConvolverZita::init(const ConvolverKernelManager::KernelData& data,
                          uint bufferSize,
                          const int& ir_width,
                          const bool& apply_autogain) -> bool {
-  std::scoped_lock<std::mutex> lock(util::fftw_lock());
-
   ready = false;
 
+  /**
+   * Waiting for the zita threads to stop does not need the fftw lock. Holding
+   * it would block the other convolvers in the realtime thread meanwhile.
+   */
+
   if (conv != nullptr) {
     conv->stop_process();
 
     while (!conv->check_stop()) {
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+  }
 
+  std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+  if (conv != nullptr) {
     delete conv;
 
     conv = nullptr;
@@ -91,8 +111,7 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
 
   conv->set_options(0);
 
-  kernel = data;
-  original_kernel = kernel;
+  original_kernel = data;
 
   this->bufferSize = bufferSize;
 
@@ -107,7 +126,7 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
     return false;
   }
 
-  if (auto ret = conv->impdata_create(0, 0, 1, kernel.channel_L.data(), 0, static_cast<int>(kernel.sampleCount()));
+  if (auto ret = conv->impdata_create(0, 0, 1, zita_data(kernel.channel_L), 0, static_cast<int>(kernel.sampleCount()));
       ret != 0) {
     util::warning(std::format("Zita: left impdata_create failed: {}", ret));
 
@@ -117,7 +136,7 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
     return false;
   }
 
-  if (auto ret = conv->impdata_create(1, 1, 1, kernel.channel_R.data(), 0, static_cast<int>(kernel.sampleCount()));
+  if (auto ret = conv->impdata_create(1, 1, 1, zita_data(kernel.channel_R), 0, static_cast<int>(kernel.sampleCount()));
       ret != 0) {
     util::warning(std::format("Zita: right impdata_create failed: {}", ret));
 
@@ -128,7 +147,8 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
   }
 
   if (kernel.channels == 4) {
-    if (auto ret = conv->impdata_create(0, 1, 1, kernel.channel_LR.data(), 0, static_cast<int>(kernel.sampleCount()));
+    if (auto ret = conv->impdata_create(0, 1, 1, zita_data(kernel.channel_LR), 0,
+                                        static_cast<int>(kernel.sampleCount()));
         ret != 0) {
       util::warning(std::format("Zita: LR impdata_create failed: {}", ret));
 
@@ -138,7 +158,8 @@ auto ConvolverZita::init(ConvolverKernelManager::KernelData data,
       return false;
     }
 
-    if (auto ret = conv->impdata_create(1, 0, 1, kernel.channel_RL.data(), 0, static_cast<int>(kernel.sampleCount()));
+    if (auto ret = conv->impdata_create(1, 0, 1, zita_data(kernel.channel_RL), 0,
+                                        static_cast<int>(kernel.sampleCount()));
         ret != 0) {
       util::warning(std::format("Zita: RL impdata_create failed: {}", ret));
 
@@ -171,9 +192,8 @@ auto ConvolverZita::process(std::span<float> left, std::span<float> right) -> bo
   }
 
   if (left.size() != bufferSize || right.size() != bufferSize) {
-    util::warning(
-        std::format("Mismatch in buffer sizes! Zita wants {} but Pipewire is using {}. Aborting zita process!",
-                    bufferSize, left.size()));
+    util::rt_warning("Mismatch in buffer sizes! Zita wants {} but Pipewire is using {}. Aborting zita process!",
+                     bufferSize, left.size());
 
     ready = false;
 
@@ -188,10 +208,14 @@ auto ConvolverZita::process(std::span<float> left, std::span<float> right) -> bo
   std::ranges::copy(left, convLeftIn.begin());
   std::ranges::copy(right, convRightIn.begin());
 
-  std::scoped_lock<std::mutex> lock(util::fftw_lock());
+  /**
+   * Executing plans that already exist is thread safe in fftw. Only creating
+   * and destroying them needs the fftw lock, so the realtime thread never waits
+   * for a convolver that is being initialized in another thread.
+   */
 
   if (auto ret = conv->process(true); ret != 0) {
-    util::warning(std::format("Zita: process failed: {}", ret));
+    util::rt_warning("Zita: process failed: {}", ret);
 
     ready = false;
 
@@ -238,14 +262,14 @@ void ConvolverZita::apply_kernel_autogain() {
 
   util::debug(std::format("autogain factor: {}", autogain));
 
-  for (uint i = 0; i < kernel.sampleCount(); i++) {
-    kernel.channel_L[i] *= autogain;
-    kernel.channel_R[i] *= autogain;
+  const auto scale = [autogain](auto& sample) { sample *= autogain; };
 
-    if (kernel.channels == 4) {
-      kernel.channel_LR[i] *= autogain;
-      kernel.channel_RL[i] *= autogain;
-    }
+  std::ranges::for_each(kernel.channel_L.mutable_span(), scale);
+  std::ranges::for_each(kernel.channel_R.mutable_span(), scale);
+
+  if (kernel.channels == 4) {
+    std::ranges::for_each(kernel.channel_LR.mutable_span(), scale);
+    std::ranges::for_each(kernel.channel_RL.mutable_span(), scale);
   }
 }
 
@@ -258,19 +282,33 @@ void ConvolverZita::set_kernel_stereo_width(const int& ir_width) {
     return;
   }
 
+  if (ir_width == 100) {
+    return;  // x is zero and the kernel does not change
+  }
+
   const float w = static_cast<float>(ir_width) * 0.01F;
   const float x = (1.0F - w) / (1.0F + w);  // M-S coeff.; L_out = L + x*R; R_out = R + x*L
 
+  auto channel_L = kernel.channel_L.mutable_span();
+  auto channel_R = kernel.channel_R.mutable_span();
+
+  std::span<float> channel_LR, channel_RL;
+
+  if (kernel.channels == 4) {
+    channel_LR = kernel.channel_LR.mutable_span();
+    channel_RL = kernel.channel_RL.mutable_span();
+  }
+
   for (uint i = 0; i < kernel.sampleCount(); i++) {
-    const float LL = kernel.channel_L[i];
-    const float RR = kernel.channel_R[i];
+    const float LL = channel_L[i];
+    const float RR = channel_R[i];
 
     float LR = 0.0F;
     float RL = 0.0F;
 
     if (kernel.channels == 4) {
-      LR = kernel.channel_LR[i];
-      RL = kernel.channel_RL[i];
+      LR = channel_LR[i];
+      RL = channel_RL[i];
     }
 
     // Apply width to direct paths
@@ -281,12 +319,12 @@ void ConvolverZita::set_kernel_stereo_width(const int& ir_width) {
     float new_LR = LR - (x * RL);
     float new_RL = RL - (x * LR);
 
-    kernel.channel_L[i] = new_LL;
-    kernel.channel_R[i] = new_RR;
+    channel_L[i] = new_LL;
+    channel_R[i] = new_RR;
 
     if (kernel.channels == 4) {
-      kernel.channel_LR[i] = new_LR;
-      kernel.channel_RL[i] = new_RL;
+      channel_LR[i] = new_LR;
+      channel_RL[i] = new_RL;
     }
   }
 }
@@ -306,15 +344,15 @@ void ConvolverZita::update_ir_width_and_autogain(const int& ir_width,
     conv->impdata_clear(0, 0);
     conv->impdata_clear(1, 1);
 
-    conv->impdata_update(0, 0, 1, kernel.channel_L.data(), 0, static_cast<int>(kernel.sampleCount()));
-    conv->impdata_update(1, 1, 1, kernel.channel_R.data(), 0, static_cast<int>(kernel.sampleCount()));
+    conv->impdata_update(0, 0, 1, zita_data(kernel.channel_L), 0, static_cast<int>(kernel.sampleCount()));
+    conv->impdata_update(1, 1, 1, zita_data(kernel.channel_R), 0, static_cast<int>(kernel.sampleCount()));
 
     if (kernel.channels == 4) {
       conv->impdata_clear(0, 1);
       conv->impdata_clear(1, 0);
 
-      conv->impdata_update(0, 1, 1, kernel.channel_LR.data(), 0, static_cast<int>(kernel.sampleCount()));
-      conv->impdata_update(1, 0, 1, kernel.channel_RL.data(), 0, static_cast<int>(kernel.sampleCount()));
+      conv->impdata_update(0, 1, 1, zita_data(kernel.channel_LR), 0, static_cast<int>(kernel.sampleCount()));
+      conv->impdata_update(1, 0, 1, zita_data(kernel.channel_RL), 0, static_cast<int>(kernel.sampleCount()));
     }
   }
 }
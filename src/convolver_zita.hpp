@@ -36,13 +36,18 @@ class ConvolverZita {
   ConvolverZita(ConvolverZita&&) noexcept = default;
   auto operator=(ConvolverZita&&) noexcept -> ConvolverZita& = default;
 
-  auto init(ConvolverKernelManager::KernelData data, uint bufferSize, const int& ir_width, const bool& apply_autogain)
-      -> bool;
+  auto init(const ConvolverKernelManager::KernelData& data,
+            uint bufferSize,
+            const int& ir_width,
+            const bool& apply_autogain) -> bool;
 
   auto process(std::span<float> dataLeft, std::span<float> dataRight) -> bool;
 
   void stop();
 
+  // Stops zita and frees its plans. It has to be called in the thread that called init.
+  void release();
+
   void reset_kernel_to_original();
 
   void update_ir_width_and_autogain(const int& ir_width, const bool& apply_autogain, const bool& clear_zita);
@@ -52,6 +57,10 @@ class ConvolverZita {
 
   uint bufferSize = 0;
 
+  /**
+   * Both share the loaded samples. The kernel only gets its own copy when the
+   * stereo width or the autogain have to change it.
+   */
   ConvolverKernelManager::KernelData kernel, original_kernel;
 
   Convproc* conv = nullptr;
@@ -46,15 +46,17 @@ Crossfeed::Crossfeed(const std::string& tag, pw::Manager* pipe_manager, Pipeline
 
   init_common_controls<DbCrossfeed>(settings);
 
+  data.resize(2U * static_cast<size_t>(max_quantum));
+
   // specific plugin controls
 
-  connect(settings, &DbCrossfeed::fcutChanged, [&]() {
+  connect(settings, &DbCrossfeed::fcutChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(data_mutex);
 
     bs2b.set_level_feed(settings->fcut());
   });
 
-  connect(settings, &DbCrossfeed::feedChanged, [&]() {
+  connect(settings, &DbCrossfeed::feedChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(data_mutex);
 
     bs2b.set_level_feed(10 * static_cast<int>(settings->feed()));
@@ -66,7 +68,7 @@ Crossfeed::~Crossfeed() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -87,8 +89,6 @@ void Crossfeed::setup() {
 
   std::scoped_lock<std::mutex> lock(data_mutex);
 
-  data.resize(2U * static_cast<size_t>(n_samples));
-
   if (rate != bs2b.get_srate()) {
     bs2b.set_srate(rate);
   }
@@ -107,9 +107,7 @@ void Crossfeed::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   for (size_t n = 0U; n < left_in.size(); n++) {
     data[n * 2U] = left_in[n];
@@ -123,13 +121,7 @@ void Crossfeed::process(std::span<float>& left_in,
     right_out[n] = data[(n * 2U) + 1U];
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void Crossfeed::process([[maybe_unused]] std::span<float>& left_in,
@@ -142,3 +134,7 @@ void Crossfeed::process([[maybe_unused]] std::span<float>& left_in,
 auto Crossfeed::get_latency_seconds() -> float {
   return 0.0F;
 }
+
+auto Crossfeed::get_tail_seconds() -> float {
+  return filter_tail_seconds;
+}
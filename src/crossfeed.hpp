@@ -64,6 +64,8 @@ class Crossfeed : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto get_tail_seconds() -> float override;
+
  private:
   std::vector<float> data;
 
@@ -52,7 +52,7 @@ CrosstalkCanceller::CrosstalkCanceller(const std::string& tag,
 
   // specific plugin controls
 
-  connect(settings, &DbCrosstalkCanceller::delayUsChanged, [&]() {
+  connect(settings, &DbCrosstalkCanceller::delayUsChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(data_mutex);
 
     a.configure(settings->delayUs(), rate);
@@ -65,7 +65,7 @@ CrosstalkCanceller::~CrosstalkCanceller() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -105,9 +105,7 @@ void CrosstalkCanceller::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   const auto decay_gain = static_cast<float>(std::pow(10, settings->decayDb() / 20));
 
@@ -133,13 +131,7 @@ void CrosstalkCanceller::process(std::span<float>& left_in,
     }
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void CrosstalkCanceller::process([[maybe_unused]] std::span<float>& left_in,
@@ -36,6 +36,7 @@
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Crusher::Crusher(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -78,7 +79,7 @@ Crusher::~Crusher() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -109,32 +110,36 @@ void Crusher::setup() {
 
   std::scoped_lock<std::mutex> lock(data_mutex);
 
-  ready = false;
-
   if (!lv2_wrapper->found_plugin) {
     return;
   }
 
   lv2_wrapper->set_n_samples(n_samples);
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  if (lv2_wrapper->has_instance() && rate == lv2_wrapper->get_rate()) {
+    return;
+  }
+
+  ready = lv2_wrapper->has_instance();
+
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Crusher::process(std::span<float>& left_in,
                       std::span<float>& right_in,
                       std::span<float>& left_out,
                       std::span<float>& right_out) {
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
   if (bypass) {
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
@@ -146,9 +151,7 @@ void Crusher::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
@@ -156,13 +159,7 @@ void Crusher::process(std::span<float>& left_in,
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void Crusher::process([[maybe_unused]] std::span<float>& left_in,
@@ -39,8 +39,10 @@
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "resampler.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 // NOLINTNEXTLINE
 #define BIND_BAND(index)                                                                                    \
@@ -48,11 +50,11 @@
     band_intensity.at(index) = util::db_to_linear(settings->intensityBand##index());                        \
     band_mute.at(index) = settings->muteBand##index();                                                      \
     band_bypass.at(index) = settings->bypassBand##index();                                                  \
-    connect(settings, &DbCrystalizer::intensityBand##index##Changed,                                        \
+    connect(settings, &DbCrystalizer::intensityBand##index##Changed, this,                                  \
             [this]() { band_intensity.at(index) = util::db_to_linear(settings->intensityBand##index()); }); \
-    connect(settings, &DbCrystalizer::muteBand##index##Changed,                                             \
+    connect(settings, &DbCrystalizer::muteBand##index##Changed, this,                                       \
             [this]() { band_mute.at(index) = settings->muteBand##index(); });                               \
-    connect(settings, &DbCrystalizer::bypassBand##index##Changed,                                           \
+    connect(settings, &DbCrystalizer::bypassBand##index##Changed, this,                                     \
             [this]() { band_bypass.at(index) = settings->bypassBand##index(); });                           \
   }
 
@@ -107,13 +109,13 @@ Crystalizer::Crystalizer(const std::string& tag, pw::Manager* pipe_manager, Pipe
   BIND_BAND(11);
   BIND_BAND(12);
 
-  connect(settings, &DbCrystalizer::useFixedQuantumChanged, [&]() { setup(); });
+  connect(settings, &DbCrystalizer::useFixedQuantumChanged, this, [&]() { setup(); });
 
-  connect(settings, &DbCrystalizer::oversamplingChanged, [&]() { setup(); });
+  connect(settings, &DbCrystalizer::oversamplingChanged, this, [&]() { setup(); });
 
-  connect(settings, &DbCrystalizer::transitionBandChanged, [&]() { setup(); });
+  connect(settings, &DbCrystalizer::transitionBandChanged, this, [&]() { setup(); });
 
-  connect(settings, &DbCrystalizer::oversamplingQualityChanged, [&]() {
+  connect(settings, &DbCrystalizer::oversamplingQualityChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(data_mutex);
 
     if (resampler_inL) {
@@ -143,7 +145,7 @@ Crystalizer::~Crystalizer() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   filters_are_ready = false;
 
@@ -181,9 +183,7 @@ void Crystalizer::setup() {
    * initializing in the plugin realtime thread we send it to the main thread.
    */
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
         if (filters_are_ready) {
@@ -228,6 +228,13 @@ void Crystalizer::setup() {
         buf_out_L.clear();
         buf_out_R.clear();
 
+        // Enough for any quantum so the realtime thread does not allocate after a quantum change
+
+        buf_in_L.reserve(max_quantum + blocksize);
+        buf_in_R.reserve(max_quantum + blocksize);
+        buf_out_L.reserve(max_quantum + blocksize);
+        buf_out_R.reserve(max_quantum + blocksize);
+
         data_L.resize(blocksize);
         data_R.resize(blocksize);
 
@@ -284,9 +291,15 @@ void Crystalizer::setup() {
 
         filters_are_ready = true;
       },
-      Qt::QueuedConnection);
+      WorkerPool::Priority::high);
+}
 
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+void Crystalizer::quantum_changed() {
+  /**
+   * The filters keep the block size they were set up for. Other quanta go
+   * through the buffers in process() and the latency they add is reported
+   * from there.
+   */
 }
 
 void Crystalizer::process(std::span<float>& left_in,
@@ -302,22 +315,30 @@ void Crystalizer::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   if (!filters_are_ready) {
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
   if (n_samples_is_power_of_2 && blocksize == n_samples && !do_oversampling) {
+    if (latency_n_frames != 0U) {
+      // Back to the quantum the filters were set up for. What is still buffered is dropped.
+      buf_in_L.clear();
+      buf_in_R.clear();
+      buf_out_L.clear();
+      buf_out_R.clear();
+
+      latency_n_frames = 0U;
+
+      notify_latency = true;
+    }
+
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
@@ -380,14 +401,12 @@ void Crystalizer::process(std::span<float>& left_in,
     }
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
 
@@ -410,6 +429,10 @@ auto Crystalizer::get_latency_seconds() -> float {
   return this->latency_value;
 }
 
+auto Crystalizer::get_tail_seconds() -> float {
+  return filter_tail_seconds;
+}
+
 auto Crystalizer::compute_kurtosis(float* data) const -> float {
   float mean = 0.0F;
 
@@ -59,6 +59,8 @@ class Crystalizer : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
@@ -73,6 +75,8 @@ class Crystalizer : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto get_tail_seconds() -> float override;
+
   Q_INVOKABLE float getBandFrequency(const int& index);
 
   Q_INVOKABLE QList<float> getAdaptiveIntensities();
@@ -127,6 +127,10 @@ Manager::~Manager() {
 }
 
 void Manager::saveAll() const {
+  if (read_only) {
+    return;
+  }
+
   util::debug("Saving settings...");
 
   graph->save();
@@ -309,4 +313,12 @@ void Manager::enableAutosave(const bool& state) {
   }
 }
 
+void Manager::set_read_only(const bool& state) {
+  read_only = state;
+
+  if (read_only) {
+    timer->stop();
+  }
+}
+
 }  // namespace db
@@ -28,6 +28,7 @@
 #include <qtmetamacros.h>
 #include <qtpreprocessorsupport.h>
 #include <QTimer>
+#include <utility>
 #include "easyeffects_db.h"                // IWYU pragma: export
 #include "easyeffects_db_graph.h"          // IWYU pragma: export
 #include "easyeffects_db_spectrum.h"       // IWYU pragma: export
@@ -89,6 +90,9 @@ class Manager : public QObject {
 
   Q_INVOKABLE void enableAutosave(const bool& state);
 
+  // Settings changed while read only are kept in memory and never written to the disk.
+  void set_read_only(const bool& state);
+
   DbGraph* graph;
   DbMain* main;
   DbSpectrum* spectrum;
@@ -103,9 +107,9 @@ class Manager : public QObject {
   auto get_plugin_db(PipelineType pipeline_type, const QString& plugin_name) -> T* {
     switch (pipeline_type) {
       case PipelineType::input:
-        return siePluginsDB.contains(plugin_name) ? siePluginsDB[plugin_name].value<T*>() : nullptr;
+        return std::as_const(siePluginsDB).value(plugin_name).template value<T*>();
       case PipelineType::output:
-        return soePluginsDB.contains(plugin_name) ? soePluginsDB[plugin_name].value<T*>() : nullptr;
+        return std::as_const(soePluginsDB).value(plugin_name).template value<T*>();
     }
 
     return nullptr;
@@ -118,6 +122,8 @@ class Manager : public QObject {
  private:
   QTimer* timer = nullptr;
 
+  bool read_only = false;
+
   void create_plugin_db(const QString& parentGroup, const auto& plugins_list, QMap<QString, QVariant>& plugins_map);
 };
 
@@ -27,6 +27,7 @@
 #include <span>
 #include <string>
 #include <vector>
+#include "async_processor.hpp"
 #include "db_manager.hpp"
 #include "easyeffects_db_deepfilternet.h"
 #include "ladspa_macros.hpp"
@@ -37,6 +38,7 @@
 #include "resampler.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 DeepFilterNet::DeepFilterNet(const std::string& tag,
                              pw::Manager* pipe_manager,
@@ -74,16 +76,32 @@ DeepFilterNet::DeepFilterNet(const std::string& tag,
                                   false);
   BIND_LADSPA_PORT_DB_EXPONENTIAL("Max DF processing threshold (dB)", maxDfProcessingThreshold,
                                   setMaxDfProcessingThreshold, DbDeepFilterNet::maxDfProcessingThresholdChanged, false);
+
+  async_enabled = settings->asyncProcessing();
+  async_latency_blocks = static_cast<uint>(settings->asyncLatency());
+
+  auto restart_async = [&]() {
+    async_enabled = settings->asyncProcessing();
+    async_latency_blocks = static_cast<uint>(settings->asyncLatency());
+
+    WorkerPool::post(baseWorker, [this] { update_async(); });
+  };
+
+  connect(settings, &DbDeepFilterNet::asyncProcessingChanged, this, restart_async);
+
+  connect(settings, &DbDeepFilterNet::asyncLatencyChanged, this, restart_async);
 }
 
 DeepFilterNet::~DeepFilterNet() {
+  async.stop();
+
   stop_worker();
 
   if (connected_to_pw) {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -132,48 +150,58 @@ void DeepFilterNet::setup() {
   resample = rate != 48000;
   resampler_ready = !resample;
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        ladspa_wrapper->n_samples = n_samples;
-        ladspa_wrapper->create_instance(48000);
+        {
+          // The separate thread may still be running the model with the old instance
+          const auto paused = async.pause();
+
+          ladspa_wrapper->n_samples = n_samples;
+          ladspa_wrapper->create_instance(48000);
 
-        if (resample && !resampler_ready) {
-          resampler_inL = std::make_unique<Resampler>(rate, 48000);
-          resampler_inR = std::make_unique<Resampler>(rate, 48000);
-          resampler_outL = std::make_unique<Resampler>(48000, rate);
-          resampler_outR = std::make_unique<Resampler>(48000, rate);
+          if (resample && !resampler_ready) {
+            resampler_inL = std::make_unique<Resampler>(rate, 48000);
+            resampler_inR = std::make_unique<Resampler>(rate, 48000);
+            resampler_outL = std::make_unique<Resampler>(48000, rate);
+            resampler_outR = std::make_unique<Resampler>(48000, rate);
 
-          std::vector<float> dummy(n_samples);
+            std::vector<float> dummy(n_samples);
 
-          const auto resampled_inL = resampler_inL->process(dummy);
-          const auto resampled_inR = resampler_inR->process(dummy);
+            const auto resampled_inL = resampler_inL->process(dummy);
+            const auto resampled_inR = resampler_inR->process(dummy);
 
-          resampled_outL.resize(resampled_inL.size());
-          resampled_outR.resize(resampled_inR.size());
+            resampled_outL.resize(resampled_inL.size());
+            resampled_outR.resize(resampled_inR.size());
 
-          resampler_outL->process(resampled_inL);
-          resampler_outR->process(resampled_inR);
+            resampler_outL->process(resampled_inL);
+            resampler_outR->process(resampled_inR);
 
-          carryover_l.clear();
-          carryover_r.clear();
-          carryover_l.reserve(4);  // chosen by fair dice roll.
-          carryover_r.reserve(4);  // guaranteed to be random.
-          carryover_l.push_back(0.0F);
-          carryover_r.push_back(0.0F);
+            carryover_l.clear();
+            carryover_r.clear();
+            carryover_l.reserve(4);  // chosen by fair dice roll.
+            carryover_r.reserve(4);  // guaranteed to be random.
+            carryover_l.push_back(0.0F);
+            carryover_r.push_back(0.0F);
 
-          resampler_ready = true;
+            resampler_ready = true;
+          }
         }
 
+        update_async();
+
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
+      WorkerPool::Priority::high);
+}
 
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+void DeepFilterNet::quantum_changed() {
+  // The resamplers and the model take any number of frames. Only the separate thread works on fixed blocks.
+  if (async_enabled || async.running()) {
+    WorkerPool::post(baseWorker, [this] { update_async(); }, WorkerPool::Priority::high);
+  }
 }
 
 void DeepFilterNet::process(std::span<float>& left_in,
@@ -189,10 +217,28 @@ void DeepFilterNet::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
+  apply_input_gain(left_in, right_in);
+
+  if (async_restarting) {
+    std::ranges::copy(left_in, left_out.begin());
+    std::ranges::copy(right_in, right_out.begin());
+  } else if (async.running()) {
+    async.process(left_in, right_in, left_out, right_out);
+  } else if (const auto paused = async.try_pause(); paused.owns_lock()) {
+    run_model(left_in, right_in, left_out, right_out);
+  } else {
+    // The model state is being replaced. We do not wait for it in the realtime thread.
+    std::ranges::copy(left_in, left_out.begin());
+    std::ranges::copy(right_in, right_out.begin());
   }
 
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
+}
+
+void DeepFilterNet::run_model(std::span<float> left_in,
+                              std::span<float> right_in,
+                              std::span<float> left_out,
+                              std::span<float> right_out) {
   if (resample) {
     const auto& resampled_inL = resampler_inL->process(left_in);
     const auto& resampled_inR = resampler_inR->process(right_in);
@@ -203,7 +249,7 @@ void DeepFilterNet::process(std::span<float>& left_in,
     ladspa_wrapper->n_samples = resampled_inL.size();
     ladspa_wrapper->connect_data_ports(resampled_inL, resampled_inR, resampled_outL, resampled_outR);
   } else {
-    ladspa_wrapper->n_samples = n_samples;
+    ladspa_wrapper->n_samples = left_in.size();
     ladspa_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   }
 
@@ -242,14 +288,6 @@ void DeepFilterNet::process(std::span<float>& left_in,
     std::fill(left_out.begin() + left_offset + left_count, left_out.end(), 0);
     std::fill(right_out.begin() + right_offset + right_count, right_out.end(), 0);
   }
-
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
 }
 
 void DeepFilterNet::process([[maybe_unused]] std::span<float>& left_in,
@@ -260,7 +298,42 @@ void DeepFilterNet::process([[maybe_unused]] std::span<float>& left_in,
                             [[maybe_unused]] std::span<float>& probe_right) {}
 
 auto DeepFilterNet::get_latency_seconds() -> float {
-  return 0.02F + (1.0F / rate);
+  return 0.02F + (1.0F / rate) + (static_cast<float>(async.latency_frames()) / static_cast<float>(rate));
+}
+
+void DeepFilterNet::update_async() {
+  if (rate == 0 || n_samples == 0) {
+    return;
+  }
+
+  // The realtime thread sees the flag in its next cycle. Locking data_mutex waits for the cycle being processed.
+
+  async_restarting = true;
+
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+  }
+
+  async.stop();
+
+  // The offline renderer calls process() faster than realtime. The backend would not keep up.
+  if (async_enabled && !pw::Manager::offline) {
+    async.start(n_samples, async_latency_blocks,
+                [this](std::span<float> left_in, std::span<float> right_in, std::span<float> left_out,
+                       std::span<float> right_out) { run_model(left_in, right_in, left_out, right_out); });
+  }
+
+  async_restarting = false;
+
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    latency_value = get_latency_seconds();
+  }
+
+  util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+
+  update_filter_params();
 }
 
 void DeepFilterNet::resetHistory() {
@@ -273,6 +346,8 @@ void DeepFilterNet::resetHistory() {
 
     std::scoped_lock<std::mutex> lock(data_mutex);
 
+    const auto paused = async.pause();
+
     if (ready && ladspa_wrapper->has_instance()) {
       ready = false;
 
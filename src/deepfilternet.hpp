@@ -22,10 +22,12 @@
 #include <qobject.h>
 #include <qqmlintegration.h>
 #include <qtmetamacros.h>
+#include <atomic>
 #include <memory>
 #include <span>
 #include <string>
 #include <vector>
+#include "async_processor.hpp"
 #include "easyeffects_db_deepfilternet.h"
 #include "ladspa_wrapper.hpp"
 #include "pipeline_type.hpp"
@@ -52,6 +54,8 @@ class DeepFilterNet : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
@@ -82,4 +86,24 @@ class DeepFilterNet : public PluginBase {
 
   std::vector<float> resampled_outL, resampled_outR;
   std::vector<float> carryover_l, carryover_r;
+
+  AsyncProcessor async{"deepfilternet"};
+
+  // Copies of the settings for the worker and the realtime threads
+  std::atomic<bool> async_enabled = false;
+  std::atomic<uint> async_latency_blocks = 0U;
+
+  std::atomic<bool> async_restarting = false;
+
+  void run_model(std::span<float> left_in,
+                 std::span<float> right_in,
+                 std::span<float> left_out,
+                 std::span<float> right_out);
+
+  /**
+   * Restarts the separate thread with the current block size. The realtime
+   * thread passes the audio through while it happens, so data_mutex is not
+   * held while the backend finishes its last block.
+   */
+  void update_async();
 };
@@ -0,0 +1,521 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "dsp_kernels.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EE_DSP_X86
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define EE_DSP_NEON
+#endif
+
+#define EE_DSP_INLINE __attribute__((always_inline)) inline
+
+namespace {
+
+constexpr float int16_scale = 32768.0F;
+constexpr float inv_int16_scale = 1.0F / int16_scale;
+
+struct Kernels {
+  std::string_view name;
+
+  float (*peak)(const float*, size_t);
+  float (*gain_peak)(float*, size_t, float);
+  void (*gain)(float*, size_t, float);
+  void (*interleave)(const float*, const float*, float*, size_t);
+  void (*deinterleave)(const float*, float*, float*, size_t);
+  void (*downmix)(const float*, const float*, float*, size_t);
+  void (*to_int16)(const float*, int16_t*, size_t);
+  void (*from_int16)(const int16_t*, float*, size_t);
+  void (*uniform)(float*, size_t, uint32_t, uint32_t);
+  void (*gaussian)(float*, size_t, uint32_t, uint32_t, float);
+  void (*sine)(const float*, float*, size_t, float);
+};
+
+/**
+ * The element-wise loops are simple enough to be vectorized by the compiler.
+ * Each instruction set only has to instantiate them with its own target
+ * attribute. The peak reductions are not vectorized without fast-math, so they
+ * are written with intrinsics further below.
+ */
+
+EE_DSP_INLINE void gain_loop(float* __restrict__ data, size_t count, float gain) {
+  for (size_t i = 0; i < count; i++) {
+    data[i] *= gain;
+  }
+}
+
+EE_DSP_INLINE void interleave_loop(const float* __restrict__ left,
+                                   const float* __restrict__ right,
+                                   float* __restrict__ output,
+                                   size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    output[2U * i] = left[i];
+    output[(2U * i) + 1U] = right[i];
+  }
+}
+
+EE_DSP_INLINE void deinterleave_loop(const float* __restrict__ input,
+                                     float* __restrict__ left,
+                                     float* __restrict__ right,
+                                     size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    left[i] = input[2U * i];
+    right[i] = input[(2U * i) + 1U];
+  }
+}
+
+EE_DSP_INLINE void downmix_loop(const float* __restrict__ left,
+                                const float* __restrict__ right,
+                                float* __restrict__ output,
+                                size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    output[i] = 0.5F * (left[i] + right[i]);
+  }
+}
+
+EE_DSP_INLINE void to_int16_loop(const float* __restrict__ input, int16_t* __restrict__ output, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    float v = input[i] * int16_scale;
+
+    v = v < -32768.0F ? -32768.0F : v;
+    v = v > 32767.0F ? 32767.0F : v;
+
+    output[i] = static_cast<int16_t>(v);
+  }
+}
+
+EE_DSP_INLINE void from_int16_loop(const int16_t* __restrict__ input, float* __restrict__ output, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    output[i] = static_cast<float>(input[i]) * inv_int16_scale;
+  }
+}
+
+/**
+ * Counter based random numbers. Each value is a hash of the seed and of its
+ * position in the stream, so there is no dependency between the samples of a
+ * block. The hash is lowbias32 from https://nullprogram.com/blog/2018/07/31/
+ */
+
+EE_DSP_INLINE auto hash32(uint32_t x) -> uint32_t {
+  x ^= x >> 16U;
+  x *= 0x7feb352dU;
+  x ^= x >> 15U;
+  x *= 0x846ca68bU;
+  x ^= x >> 16U;
+
+  return x;
+}
+
+// The 24 most significant bits mapped to [-1, 1)
+EE_DSP_INLINE auto to_uniform(const uint32_t& h) -> float {
+  return (static_cast<float>(h >> 8U) * (1.0F / 8388608.0F)) - 1.0F;
+}
+
+EE_DSP_INLINE void uniform_loop(float* __restrict__ output, size_t count, uint32_t seed, uint32_t counter) {
+  for (size_t i = 0; i < count; i++) {
+    output[i] = to_uniform(hash32((counter + static_cast<uint32_t>(i)) ^ seed));
+  }
+}
+
+/**
+ * The sum of 4 uniform values is close enough to a normal distribution for
+ * test signals (Irwin-Hall). Its variance is 4 / 3. The result is clipped to
+ * [-1, 1] like the output of the former std::normal_distribution generator.
+ */
+EE_DSP_INLINE void gaussian_loop(float* __restrict__ output,
+                                 size_t count,
+                                 uint32_t seed,
+                                 uint32_t counter,
+                                 float sigma) {
+  const float scale = sigma * 0.8660254F;  // sigma / sqrt(4 / 3)
+
+  for (size_t i = 0; i < count; i++) {
+    const uint32_t c = (counter + static_cast<uint32_t>(i)) * 4U;
+
+    float v = to_uniform(hash32(c ^ seed)) + to_uniform(hash32((c + 1U) ^ seed)) +
+              to_uniform(hash32((c + 2U) ^ seed)) + to_uniform(hash32((c + 3U) ^ seed));
+
+    v *= scale;
+
+    v = v < -1.0F ? -1.0F : v;
+    v = v > 1.0F ? 1.0F : v;
+
+    output[i] = v;
+  }
+}
+
+/**
+ * amplitude * sin(2 * pi * cycles) for non negative cycles. The fractional
+ * part is reduced to [-pi / 2, pi / 2] and a Taylor polynomial of degree 11 is
+ * used. Its error is below 1e-7.
+ */
+EE_DSP_INLINE void sine_loop(const float* __restrict__ cycles,
+                             float* __restrict__ output,
+                             size_t count,
+                             float amplitude) {
+  constexpr float two_pi = 6.28318530717958647692F;
+
+  for (size_t i = 0; i < count; i++) {
+    // sin(2 * pi * x) = -sin(2 * pi * (x - 0.5))
+
+    float y = cycles[i] - static_cast<float>(static_cast<int32_t>(cycles[i])) - 0.5F;
+
+    y = y > 0.25F ? 0.5F - y : y;
+    y = y < -0.25F ? -0.5F - y : y;
+
+    const float t = two_pi * y;
+    const float t2 = t * t;
+
+    float p = -2.5052108385e-8F;
+
+    p = (p * t2) + 2.7557319224e-6F;
+    p = (p * t2) - 1.9841269841e-4F;
+    p = (p * t2) + 8.3333333333e-3F;
+    p = (p * t2) - 1.6666666667e-1F;
+    p = (p * t2) + 1.0F;
+
+    output[i] = -amplitude * t * p;
+  }
+}
+
+EE_DSP_INLINE auto peak_tail(const float* data, size_t count, float peak) -> float {
+  for (size_t i = 0; i < count; i++) {
+    peak = std::max(peak, std::fabs(data[i]));
+  }
+
+  return peak;
+}
+
+EE_DSP_INLINE auto gain_peak_tail(float* data, size_t count, float gain, float peak) -> float {
+  for (size_t i = 0; i < count; i++) {
+    data[i] *= gain;
+
+    peak = std::max(peak, std::fabs(data[i]));
+  }
+
+  return peak;
+}
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
+
+#define EE_DSP_ELEMENTWISE(suffix, target)                                                                   \
+  target void gain_##suffix(float* data, size_t count, float gain) {                                         \
+    gain_loop(data, count, gain);                                                                            \
+  }                                                                                                          \
+  target void interleave_##suffix(const float* left, const float* right, float* output, size_t count) {      \
+    interleave_loop(left, right, output, count);                                                             \
+  }                                                                                                          \
+  target void deinterleave_##suffix(const float* input, float* left, float* right, size_t count) {           \
+    deinterleave_loop(input, left, right, count);                                                            \
+  }                                                                                                          \
+  target void downmix_##suffix(const float* left, const float* right, float* output, size_t count) {         \
+    downmix_loop(left, right, output, count);                                                                \
+  }                                                                                                          \
+  target void to_int16_##suffix(const float* input, int16_t* output, size_t count) {                         \
+    to_int16_loop(input, output, count);                                                                     \
+  }                                                                                                          \
+  target void from_int16_##suffix(const int16_t* input, float* output, size_t count) {                       \
+    from_int16_loop(input, output, count);                                                                   \
+  }                                                                                                          \
+  target void uniform_##suffix(float* output, size_t count, uint32_t seed, uint32_t counter) {               \
+    uniform_loop(output, count, seed, counter);                                                              \
+  }                                                                                                          \
+  target void gaussian_##suffix(float* output, size_t count, uint32_t seed, uint32_t counter, float sigma) { \
+    gaussian_loop(output, count, seed, counter, sigma);                                                      \
+  }                                                                                                          \
+  target void sine_##suffix(const float* cycles, float* output, size_t count, float amplitude) {             \
+    sine_loop(cycles, output, count, amplitude);                                                             \
+  }
+
+#define EE_DSP_TABLE(label, suffix)                                                          \
+  Kernels {                                                                                  \
+    label, &peak_##suffix, &gain_peak_##suffix, &gain_##suffix, &interleave_##suffix,        \
+        &deinterleave_##suffix, &downmix_##suffix, &to_int16_##suffix, &from_int16_##suffix, \
+        &uniform_##suffix, &gaussian_##suffix, &sine_##suffix                                \
+  }
+
+// NOLINTEND(cppcoreguidelines-macro-usage)
+
+// Portable fallback
+
+EE_DSP_ELEMENTWISE(scalar, )
+
+auto peak_scalar(const float* data, size_t count) -> float {
+  return peak_tail(data, count, 0.0F);
+}
+
+auto gain_peak_scalar(float* data, size_t count, float gain) -> float {
+  return gain_peak_tail(data, count, gain, 0.0F);
+}
+
+#ifdef EE_DSP_X86
+
+// SSE2
+
+EE_DSP_ELEMENTWISE(sse2, __attribute__((target("sse2"))))
+
+__attribute__((target("sse2"))) auto peak_sse2(const float* data, size_t count) -> float {
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+  __m128 acc = _mm_setzero_ps();
+
+  size_t i = 0;
+
+  for (; i + 4U <= count; i += 4U) {
+    acc = _mm_max_ps(acc, _mm_and_ps(_mm_loadu_ps(data + i), abs_mask));
+  }
+
+  std::array<float, 4> lanes{};
+
+  _mm_storeu_ps(lanes.data(), acc);
+
+  return peak_tail(data + i, count - i, std::ranges::max(lanes));
+}
+
+__attribute__((target("sse2"))) auto gain_peak_sse2(float* data, size_t count, float gain) -> float {
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+  const __m128 g = _mm_set1_ps(gain);
+
+  __m128 acc = _mm_setzero_ps();
+
+  size_t i = 0;
+
+  for (; i + 4U <= count; i += 4U) {
+    const __m128 v = _mm_mul_ps(_mm_loadu_ps(data + i), g);
+
+    _mm_storeu_ps(data + i, v);
+
+    acc = _mm_max_ps(acc, _mm_and_ps(v, abs_mask));
+  }
+
+  std::array<float, 4> lanes{};
+
+  _mm_storeu_ps(lanes.data(), acc);
+
+  return gain_peak_tail(data + i, count - i, gain, std::ranges::max(lanes));
+}
+
+// AVX2
+
+EE_DSP_ELEMENTWISE(avx2, __attribute__((target("avx2"))))
+
+__attribute__((target("avx2"))) auto peak_avx2(const float* data, size_t count) -> float {
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+  __m256 acc = _mm256_setzero_ps();
+
+  size_t i = 0;
+
+  for (; i + 8U <= count; i += 8U) {
+    acc = _mm256_max_ps(acc, _mm256_and_ps(_mm256_loadu_ps(data + i), abs_mask));
+  }
+
+  std::array<float, 8> lanes{};
+
+  _mm256_storeu_ps(lanes.data(), acc);
+
+  return peak_tail(data + i, count - i, std::ranges::max(lanes));
+}
+
+__attribute__((target("avx2"))) auto gain_peak_avx2(float* data, size_t count, float gain) -> float {
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+  const __m256 g = _mm256_set1_ps(gain);
+
+  __m256 acc = _mm256_setzero_ps();
+
+  size_t i = 0;
+
+  for (; i + 8U <= count; i += 8U) {
+    const __m256 v = _mm256_mul_ps(_mm256_loadu_ps(data + i), g);
+
+    _mm256_storeu_ps(data + i, v);
+
+    acc = _mm256_max_ps(acc, _mm256_and_ps(v, abs_mask));
+  }
+
+  std::array<float, 8> lanes{};
+
+  _mm256_storeu_ps(lanes.data(), acc);
+
+  return gain_peak_tail(data + i, count - i, gain, std::ranges::max(lanes));
+}
+
+// AVX-512
+
+EE_DSP_ELEMENTWISE(avx512, __attribute__((target("avx512f"))))
+
+__attribute__((target("avx512f"))) auto peak_avx512(const float* data, size_t count) -> float {
+  __m512 acc = _mm512_setzero_ps();
+
+  size_t i = 0;
+
+  for (; i + 16U <= count; i += 16U) {
+    acc = _mm512_max_ps(acc, _mm512_abs_ps(_mm512_loadu_ps(data + i)));
+  }
+
+  return peak_tail(data + i, count - i, _mm512_reduce_max_ps(acc));
+}
+
+__attribute__((target("avx512f"))) auto gain_peak_avx512(float* data, size_t count, float gain) -> float {
+  const __m512 g = _mm512_set1_ps(gain);
+
+  __m512 acc = _mm512_setzero_ps();
+
+  size_t i = 0;
+
+  for (; i + 16U <= count; i += 16U) {
+    const __m512 v = _mm512_mul_ps(_mm512_loadu_ps(data + i), g);
+
+    _mm512_storeu_ps(data + i, v);
+
+    acc = _mm512_max_ps(acc, _mm512_abs_ps(v));
+  }
+
+  return gain_peak_tail(data + i, count - i, gain, _mm512_reduce_max_ps(acc));
+}
+
+#endif
+
+#ifdef EE_DSP_NEON
+
+// NEON is part of the aarch64 baseline. No runtime check is needed.
+
+EE_DSP_ELEMENTWISE(neon, )
+
+auto peak_neon(const float* data, size_t count) -> float {
+  float32x4_t acc = vdupq_n_f32(0.0F);
+
+  size_t i = 0;
+
+  for (; i + 4U <= count; i += 4U) {
+    acc = vmaxq_f32(acc, vabsq_f32(vld1q_f32(data + i)));
+  }
+
+  return peak_tail(data + i, count - i, vmaxvq_f32(acc));
+}
+
+auto gain_peak_neon(float* data, size_t count, float gain) -> float {
+  float32x4_t acc = vdupq_n_f32(0.0F);
+
+  size_t i = 0;
+
+  for (; i + 4U <= count; i += 4U) {
+    const float32x4_t v = vmulq_n_f32(vld1q_f32(data + i), gain);
+
+    vst1q_f32(data + i, v);
+
+    acc = vmaxq_f32(acc, vabsq_f32(v));
+  }
+
+  return gain_peak_tail(data + i, count - i, gain, vmaxvq_f32(acc));
+}
+
+#endif
+
+auto select_kernels() -> Kernels {
+#ifdef EE_DSP_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f")) {
+    return EE_DSP_TABLE("avx512", avx512);
+  }
+
+  if (__builtin_cpu_supports("avx2")) {
+    return EE_DSP_TABLE("avx2", avx2);
+  }
+
+  if (__builtin_cpu_supports("sse2")) {
+    return EE_DSP_TABLE("sse2", sse2);
+  }
+#elif defined(EE_DSP_NEON)
+  return EE_DSP_TABLE("neon", neon);
+#endif
+
+  return EE_DSP_TABLE("scalar", scalar);
+}
+
+const Kernels kernels = select_kernels();
+
+}  // namespace
+
+namespace dsp {
+
+auto isa_name() -> std::string_view {
+  return kernels.name;
+}
+
+auto peak(std::span<const float> data) -> float {
+  return kernels.peak(data.data(), data.size());
+}
+
+auto apply_gain_peak(std::span<float> data, const float& gain) -> float {
+  return kernels.gain_peak(data.data(), data.size(), gain);
+}
+
+void apply_gain(std::span<float> data, const float& gain) {
+  kernels.gain(data.data(), data.size(), gain);
+}
+
+void interleave(std::span<const float> left, std::span<const float> right, std::span<float> output) {
+  const auto count = std::min({left.size(), right.size(), output.size() / 2U});
+
+  kernels.interleave(left.data(), right.data(), output.data(), count);
+}
+
+void deinterleave(std::span<const float> input, std::span<float> left, std::span<float> right) {
+  const auto count = std::min({input.size() / 2U, left.size(), right.size()});
+
+  kernels.deinterleave(input.data(), left.data(), right.data(), count);
+}
+
+void downmix(std::span<const float> left, std::span<const float> right, std::span<float> output) {
+  kernels.downmix(left.data(), right.data(), output.data(), std::min({left.size(), right.size(), output.size()}));
+}
+
+void float_to_int16(std::span<const float> input, std::span<int16_t> output) {
+  kernels.to_int16(input.data(), output.data(), std::min(input.size(), output.size()));
+}
+
+void int16_to_float(std::span<const int16_t> input, std::span<float> output) {
+  kernels.from_int16(input.data(), output.data(), std::min(input.size(), output.size()));
+}
+
+void uniform_noise(std::span<float> output, const uint32_t& seed, const uint32_t& counter) {
+  kernels.uniform(output.data(), output.size(), seed, counter);
+}
+
+void gaussian_noise(std::span<float> output, const uint32_t& seed, const uint32_t& counter, const float& sigma) {
+  kernels.gaussian(output.data(), output.size(), seed, counter, sigma);
+}
+
+void sine(std::span<const float> cycles, std::span<float> output, const float& amplitude) {
+  kernels.sine(cycles.data(), output.data(), std::min(cycles.size(), output.size()), amplitude);
+}
+
+}  // namespace dsp
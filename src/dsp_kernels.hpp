@@ -0,0 +1,68 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/**
+ * Small set of block kernels used by the realtime code of every plugin. The
+ * implementation matching the host cpu (AVX-512, AVX2 or SSE2 on x86 and NEON
+ * on ARM) is chosen once when the program starts.
+ */
+
+namespace dsp {
+
+// Name of the instruction set selected at runtime.
+auto isa_name() -> std::string_view;
+
+// Largest absolute value in the buffer.
+auto peak(std::span<const float> data) -> float;
+
+// Multiplies the buffer by gain and returns its peak in the same pass.
+auto apply_gain_peak(std::span<float> data, const float& gain) -> float;
+
+void apply_gain(std::span<float> data, const float& gain);
+
+// left and right -> l0 r0 l1 r1 ...
+void interleave(std::span<const float> left, std::span<const float> right, std::span<float> output);
+
+// l0 r0 l1 r1 ... -> left and right
+void deinterleave(std::span<const float> input, std::span<float> left, std::span<float> right);
+
+// output = 0.5 * (left + right)
+void downmix(std::span<const float> left, std::span<const float> right, std::span<float> output);
+
+// [-1, 1) floats to saturated 16 bits integers and back.
+void float_to_int16(std::span<const float> input, std::span<int16_t> output);
+
+void int16_to_float(std::span<const int16_t> input, std::span<float> output);
+
+// Uniform noise in [-1, 1). Sample n of the stream depends only on the seed and on counter + n.
+void uniform_noise(std::span<float> output, const uint32_t& seed, const uint32_t& counter);
+
+// Approximately normal noise with the given standard deviation, clipped to [-1, 1].
+void gaussian_noise(std::span<float> output, const uint32_t& seed, const uint32_t& counter, const float& sigma);
+
+// output = amplitude * sin(2 * pi * cycles). The cycles must not be negative.
+void sine(std::span<const float> cycles, std::span<float> output, const float& amplitude);
+
+}  // namespace dsp
@@ -32,8 +32,10 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 EchoCanceller::EchoCanceller(const std::string& tag,
                              pw::Manager* pipe_manager,
@@ -69,7 +71,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
 
   // Echo Canceller
 
-  connect(settings, &DbEchoCanceller::enableEchoCancellerChanged, [&]() {
+  connect(settings, &DbEchoCanceller::enableEchoCancellerChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -81,7 +83,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
     ap_builder->ApplyConfig(ap_cfg);
   });
 
-  connect(settings, &DbEchoCanceller::echoCancellerMobileModeChanged, [&]() {
+  connect(settings, &DbEchoCanceller::echoCancellerMobileModeChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -93,7 +95,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
     ap_builder->ApplyConfig(ap_cfg);
   });
 
-  connect(settings, &DbEchoCanceller::echoCancellerEnforceHighPassChanged, [&]() {
+  connect(settings, &DbEchoCanceller::echoCancellerEnforceHighPassChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -107,7 +109,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
 
   // Noise Suppression
 
-  connect(settings, &DbEchoCanceller::enableNoiseSuppressionChanged, [&]() {
+  connect(settings, &DbEchoCanceller::enableNoiseSuppressionChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -119,7 +121,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
     ap_builder->ApplyConfig(ap_cfg);
   });
 
-  connect(settings, &DbEchoCanceller::noiseSuppressionLevelChanged, [&]() {
+  connect(settings, &DbEchoCanceller::noiseSuppressionLevelChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -134,7 +136,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
 
   // High-pass Filter
 
-  connect(settings, &DbEchoCanceller::enableHighPassFilterChanged, [&]() {
+  connect(settings, &DbEchoCanceller::enableHighPassFilterChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -146,7 +148,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
     ap_builder->ApplyConfig(ap_cfg);
   });
 
-  connect(settings, &DbEchoCanceller::highPassFilterFullBandChanged, [&]() {
+  connect(settings, &DbEchoCanceller::highPassFilterFullBandChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -160,7 +162,7 @@ EchoCanceller::EchoCanceller(const std::string& tag,
 
   // Automatic gain control
 
-  connect(settings, &DbEchoCanceller::enableAGCChanged, [&]() {
+  connect(settings, &DbEchoCanceller::enableAGCChanged, this, [&]() {
     if (!ap_builder) {
       return;
     }
@@ -174,11 +176,13 @@ EchoCanceller::EchoCanceller(const std::string& tag,
 }
 
 EchoCanceller::~EchoCanceller() {
+  stop_worker();
+
   if (connected_to_pw) {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   data_mutex.lock();
 
@@ -213,15 +217,13 @@ void EchoCanceller::setup() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
-  ready = false;
-
-  notify_latency = true;
+  // Creating the webrtc processor is too expensive for the realtime thread
 
-  latency_n_frames = 0U;
+  WorkerPool::post(baseWorker, [this] { init_webrtc(); }, WorkerPool::Priority::high);
+}
 
-  init_webrtc();
+void EchoCanceller::quantum_changed() {
+  // webrtc always works on blocks of 10 ms. The buffers in process() adapt to any quantum.
 }
 
 void EchoCanceller::process([[maybe_unused]] std::span<float>& left_in,
@@ -244,9 +246,7 @@ void EchoCanceller::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   buf_near_L.insert(buf_near_L.end(), left_in.begin(), left_in.end());
   buf_near_R.insert(buf_near_R.end(), right_in.begin(), right_in.end());
@@ -292,14 +292,12 @@ void EchoCanceller::process(std::span<float>& left_in,
     buf_out_R.clear();
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     const float latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
 
@@ -316,14 +314,30 @@ void EchoCanceller::init_webrtc() {
     return;
   }
 
-  blocksize = rate * 0.01;  // webrtc needs blocks of 10 ms
+  const auto new_rate = rate;
+
+  const auto new_blocksize = new_rate / 100U;  // webrtc needs blocks of 10 ms
 
-  util::debug(std::format("webrtc blocksize: {}", blocksize));
+  util::debug(std::format("webrtc blocksize: {}", new_blocksize));
 
-  near_L.resize(blocksize);
-  near_R.resize(blocksize);
-  far_L.resize(blocksize);
-  far_R.resize(blocksize);
+  /**
+   * The new processor is prepared while the current one keeps running. The
+   * previous one is released after the lock, when this scope ends.
+   */
+
+  rtc::scoped_refptr<webrtc::AudioProcessing> processor = webrtc::AudioProcessingBuilder().Create();
+
+  std::vector<float> new_near_L(new_blocksize), new_near_R(new_blocksize);
+  std::vector<float> new_far_L(new_blocksize), new_far_R(new_blocksize);
+
+  std::scoped_lock<std::mutex> lock(data_mutex);
+
+  blocksize = new_blocksize;
+
+  near_L.swap(new_near_L);
+  near_R.swap(new_near_R);
+  far_L.swap(new_far_L);
+  far_R.swap(new_far_R);
 
   buf_near_L.clear();
   buf_near_R.clear();
@@ -332,11 +346,16 @@ void EchoCanceller::init_webrtc() {
   buf_out_L.clear();
   buf_out_R.clear();
 
-  ap_builder = webrtc::AudioProcessingBuilder().Create();
+  // Applied under the lock like the settings callbacks do so no change is lost
+  processor->ApplyConfig(ap_cfg);
+
+  ap_builder.swap(processor);
 
-  ap_builder->ApplyConfig(ap_cfg);
+  stream_config = webrtc::StreamConfig(static_cast<int>(new_rate), 2);
 
-  stream_config = webrtc::StreamConfig(rate, 2);
+  notify_latency = true;
+
+  latency_n_frames = 0U;
 
   ready = true;
 }
@@ -52,6 +52,8 @@ class EchoCanceller : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
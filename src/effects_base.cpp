@@ -18,20 +18,23 @@
  */
 
 #include "effects_base.hpp"
-#include <gsl/gsl_interp.h>
-#include <gsl/gsl_spline.h>
 #include <qcontainerfwd.h>
 #include <qnamespace.h>
 #include <qobjectdefs.h>
 #include <qpoint.h>
 #include <qthread.h>
+#include <qtimer.h>
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <spa/utils/defs.h>
 #include <QSharedPointer>
 #include <QString>
+#include <QStringList>
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <format>
 #include <map>
 #include <memory>
 #include <ranges>
@@ -42,6 +45,7 @@
 #include "autotune.hpp"
 #include "bass_enhancer.hpp"
 #include "bass_loudness.hpp"
+#include "chain_fader.hpp"
 #include "compressor.hpp"
 #include "convolver.hpp"
 #include "crossfeed.hpp"
@@ -61,6 +65,7 @@
 #include "level_meter.hpp"
 #include "limiter.hpp"
 #include "loudness.hpp"
+#include "lv2_wrapper.hpp"
 #include "maximizer.hpp"
 #include "multiband_compressor.hpp"
 #include "multiband_gate.hpp"
@@ -77,6 +82,7 @@
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
 #include "voice_suppressor.hpp"
+#include "worker_pool.hpp"
 
 EffectsBase::EffectsBase(pw::Manager* pipe_manager, PipelineType pipe_type)
     : log_tag(pipe_type == PipelineType::output ? "soe: " : "sie: "),
@@ -89,6 +95,16 @@ EffectsBase::EffectsBase(pw::Manager* pipe_manager, PipelineType pipe_type)
 
   spectrum = std::make_shared<Spectrum>(log_tag, pm, pipeline_type, "0");
 
+  chain_fader = std::make_shared<ChainFader>(log_tag, pm, pipeline_type, "0");
+
+  standby_fader = std::make_shared<ChainFader>(log_tag, pm, pipeline_type, "1");
+
+  standby_fader->set_gain(0.0F);
+
+  dry_fader = std::make_shared<ChainFader>(log_tag, pm, pipeline_type, "2");
+
+  dry_fader->set_gain(0.0F);
+
   if (!output_level->connected_to_pw) {
     output_level->connect_to_pw();
   }
@@ -97,6 +113,12 @@ EffectsBase::EffectsBase(pw::Manager* pipe_manager, PipelineType pipe_type)
     spectrum->connect_to_pw();
   }
 
+  for (const auto& fader : {chain_fader, standby_fader, dry_fader}) {
+    if (!fader->connected_to_pw) {
+      fader->connect_to_pw();
+    }
+  }
+
   create_filters_if_necessary();
 
   switch (pipeline_type) {
@@ -116,26 +138,17 @@ EffectsBase::EffectsBase(pw::Manager* pipe_manager, PipelineType pipe_type)
     }
   });
 
-  // worker thread for the native ui and maybe also other things
-
-  baseWorker->moveToThread(&workerThread);
+  // Shared worker thread used for the spectrum data processing
 
-  workerThread.start();
+  workerThread = WorkerPool::self().acquire_thread();
 
-  connect(&workerThread, &QThread::finished, baseWorker, &QObject::deleteLater);
+  baseWorker->moveToThread(workerThread);
 }
 
 EffectsBase::~EffectsBase() {
-  workerThread.quit();
-  workerThread.wait();
-
-  if (gsl_acc != nullptr) {
-    gsl_interp_accel_free(gsl_acc);
-  }
+  WorkerPool::destroy_context(baseWorker);
 
-  if (spline != nullptr) {
-    gsl_spline_free(spline);
-  }
+  WorkerPool::self().release_thread(workerThread);
 
   util::debug("effects_base: destroyed");
 }
@@ -147,150 +160,219 @@ void EffectsBase::create_filters_if_necessary() {
     return;
   }
 
+  QStringList missing;
+
   for (const auto& name : list) {
     if (plugins.contains(name)) {
       continue;
     }
 
-    auto instance_id = tags::plugin_name::get_id(name);
+    if (auto filter = take_standby_plugin(name); filter != nullptr) {
+      util::debug(std::format("{}{} reused from the standby pool", log_tag, name.toStdString()));
 
-    std::unique_ptr<PluginBase> filter = nullptr;
+      plugins.insert(std::make_pair(name, std::move(filter)));
 
-    if (name.startsWith(tags::plugin_name::BaseName::autogain)) {
-      filter = std::make_unique<Autogain>(log_tag, pm, pipeline_type, instance_id);
+      continue;
+    }
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::autotune)) {
-      filter = std::make_unique<Autotune>(log_tag, pm, pipeline_type, instance_id);
+    missing.append(name);
+  }
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::bassEnhancer)) {
-      filter = std::make_unique<BassEnhancer>(log_tag, pm, pipeline_type, instance_id);
+  if (missing.empty()) {
+    return;
+  }
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::bassLoudness)) {
-      filter = std::make_unique<BassLoudness>(log_tag, pm, pipeline_type, instance_id);
+  /**
+   * Loading the LV2 worlds takes most of the time and each world is
+   * independent, so they are loaded in parallel. The plugins themselves are
+   * built here because their constructors use the settings maps and other
+   * objects that belong to this thread.
+   */
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::compressor)) {
-      filter = std::make_unique<Compressor>(log_tag, pm, pipeline_type, instance_id);
+  if (missing.size() > 1) {
+    lv2::Lv2Wrapper::preload_worlds(static_cast<size_t>(missing.size()));
+  }
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::convolver)) {
-      filter = std::make_unique<Convolver>(log_tag, pm, pipeline_type, instance_id);
+  for (const auto& name : missing) {
+    auto filter = create_plugin(log_tag, pm, pipeline_type, name);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::crossfeed)) {
-      filter = std::make_unique<Crossfeed>(log_tag, pm, pipeline_type, instance_id);
+    if (filter != nullptr) {
+      /**
+       * The filters inherit from QObject and we do not want QML to take
+       * ownership of them. Double free may happen in this case when closing
+       * the window or doing similar actions that trigger qml cleanup. The way
+       * to avoid this is making sure that the objects managed by the C++
+       * backend already have a parent by the time they are used on QML.
+       */
+      filter->setParent(this);
+    }
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::crusher)) {
-      filter = std::make_unique<Crusher>(log_tag, pm, pipeline_type, instance_id);
+    plugins.insert(std::make_pair(name, std::move(filter)));
+  }
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::crystalizer)) {
-      filter = std::make_unique<Crystalizer>(log_tag, pm, pipeline_type, instance_id);
+  lv2::Lv2Wrapper::release_preloaded_worlds();
+}
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::deepfilternet)) {
-      filter = std::make_unique<DeepFilterNet>(log_tag, pm, pipeline_type, instance_id);
+auto EffectsBase::create_plugin(const std::string& log_tag,
+                                pw::Manager* pm,
+                                const PipelineType& pipeline_type,
+                                const QString& name) -> std::unique_ptr<PluginBase> {
+  auto instance_id = tags::plugin_name::get_id(name);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::deesser)) {
-      filter = std::make_unique<Deesser>(log_tag, pm, pipeline_type, instance_id);
+  std::unique_ptr<PluginBase> filter = nullptr;
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::delay)) {
-      filter = std::make_unique<Delay>(log_tag, pm, pipeline_type, instance_id);
+  if (name.startsWith(tags::plugin_name::BaseName::autogain)) {
+    filter = std::make_unique<Autogain>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::echoCanceller)) {
-      filter = std::make_unique<EchoCanceller>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::autotune)) {
+    filter = std::make_unique<Autotune>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::exciter)) {
-      filter = std::make_unique<Exciter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::bassEnhancer)) {
+    filter = std::make_unique<BassEnhancer>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::expander)) {
-      filter = std::make_unique<Expander>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::bassLoudness)) {
+    filter = std::make_unique<BassLoudness>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::equalizer)) {
-      filter = std::make_unique<Equalizer>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::compressor)) {
+    filter = std::make_unique<Compressor>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::filter)) {
-      filter = std::make_unique<Filter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::convolver)) {
+    filter = std::make_unique<Convolver>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::gate)) {
-      filter = std::make_unique<Gate>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::crossfeed)) {
+    filter = std::make_unique<Crossfeed>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::voiceSuppressor)) {
-      filter = std::make_unique<VoiceSuppressor>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::crusher)) {
+    filter = std::make_unique<Crusher>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::crosstalkCanceller)) {
-      filter = std::make_unique<CrosstalkCanceller>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::crystalizer)) {
+    filter = std::make_unique<Crystalizer>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::levelMeter)) {
-      filter = std::make_unique<LevelMeter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::deepfilternet)) {
+    filter = std::make_unique<DeepFilterNet>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::limiter)) {
-      filter = std::make_unique<Limiter>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::deesser)) {
+    filter = std::make_unique<Deesser>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::loudness)) {
-      filter = std::make_unique<Loudness>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::delay)) {
+    filter = std::make_unique<Delay>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::maximizer)) {
-      filter = std::make_unique<Maximizer>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::echoCanceller)) {
+    filter = std::make_unique<EchoCanceller>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::multibandCompressor)) {
-      filter = std::make_unique<MultibandCompressor>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::exciter)) {
+    filter = std::make_unique<Exciter>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::multibandGate)) {
-      filter = std::make_unique<MultibandGate>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::expander)) {
+    filter = std::make_unique<Expander>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::pitch)) {
-      filter = std::make_unique<Pitch>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::equalizer)) {
+    filter = std::make_unique<Equalizer>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::reverb)) {
-      filter = std::make_unique<Reverb>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::filter)) {
+    filter = std::make_unique<Filter>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::rnnoise)) {
-      filter = std::make_unique<RNNoise>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::gate)) {
+    filter = std::make_unique<Gate>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::speex)) {
-      filter = std::make_unique<Speex>(log_tag, pm, pipeline_type, instance_id);
+  } else if (name.startsWith(tags::plugin_name::BaseName::voiceSuppressor)) {
+    filter = std::make_unique<VoiceSuppressor>(log_tag, pm, pipeline_type, instance_id);
 
-    } else if (name.startsWith(tags::plugin_name::BaseName::stereoTools)) {
-      filter = std::make_unique<StereoTools>(log_tag, pm, pipeline_type, instance_id);
-    }
+  } else if (name.startsWith(tags::plugin_name::BaseName::crosstalkCanceller)) {
+    filter = std::make_unique<CrosstalkCanceller>(log_tag, pm, pipeline_type, instance_id);
 
-    if (filter != nullptr) {
-      /**
-       * The filters inherit from QObject and we do not want QML to take
-       * ownership of them. Double free may happen in this case when closing
-       * the window or doing similar actions that trigger qml cleanup. The way
-       * to avoid this is making sure that the objects managed by the C++
-       * backend already have a parent by the time they are used on QML.
-       */
-      filter->setParent(this);
-    }
+  } else if (name.startsWith(tags::plugin_name::BaseName::levelMeter)) {
+    filter = std::make_unique<LevelMeter>(log_tag, pm, pipeline_type, instance_id);
 
-    plugins.insert(std::make_pair(name, std::move(filter)));
+  } else if (name.startsWith(tags::plugin_name::BaseName::limiter)) {
+    filter = std::make_unique<Limiter>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::loudness)) {
+    filter = std::make_unique<Loudness>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::maximizer)) {
+    filter = std::make_unique<Maximizer>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::multibandCompressor)) {
+    filter = std::make_unique<MultibandCompressor>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::multibandGate)) {
+    filter = std::make_unique<MultibandGate>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::pitch)) {
+    filter = std::make_unique<Pitch>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::reverb)) {
+    filter = std::make_unique<Reverb>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::rnnoise)) {
+    filter = std::make_unique<RNNoise>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::speex)) {
+    filter = std::make_unique<Speex>(log_tag, pm, pipeline_type, instance_id);
+
+  } else if (name.startsWith(tags::plugin_name::BaseName::stereoTools)) {
+    filter = std::make_unique<StereoTools>(log_tag, pm, pipeline_type, instance_id);
   }
+
+  return filter;
 }
 
-void EffectsBase::remove_unused_filters() {
-  auto list = (pipeline_type == PipelineType::output ? DbStreamOutputs::plugins() : DbStreamInputs::plugins());
+auto EffectsBase::take_standby_plugin(const QString& name) -> std::unique_ptr<PluginBase> {
+  auto it = std::ranges::find_if(standby_plugins, [&](const auto& entry) { return entry.first == name; });
 
-  if (list.empty()) {
-    plugins.clear();
+  if (it == standby_plugins.end()) {
+    return nullptr;
+  }
+
+  auto plugin = std::move(it->second);
 
+  standby_plugins.erase(it);
+
+  return plugin;
+}
+
+void EffectsBase::park_plugin(const QString& name, std::unique_ptr<PluginBase> plugin) {
+  if (plugin == nullptr) {
     return;
   }
 
-  for (auto it = plugins.begin(); it != plugins.end();) {
-    auto key = it->first;
+  if (DbMain::pluginsPoolSize() == 0) {
+    plugin->bypass = true;
+  }
 
-    if (std::ranges::find(list, key) == list.end()) {
-      auto plugin = std::move(it->second);  // Move the unique_ptr
+  if (plugin->connected_to_pw) {
+    plugin->disconnect_from_pw();
+  }
 
-      if (plugin == nullptr) {
-        it = plugins.erase(it);
+  if (DbMain::pluginsPoolSize() == 0) {
+    return;
+  }
 
-        continue;
-      }
+  plugin->clear_data();
 
-      plugin->bypass = true;
+  standby_plugins.emplace_back(name, std::move(plugin));
 
-      if (plugin->connected_to_pw) {
-        plugin->disconnect_from_pw();
-      }
+  trim_standby_plugins();
+}
+
+void EffectsBase::trim_standby_plugins() {
+  const auto max_size = static_cast<size_t>(std::max(DbMain::pluginsPoolSize(), 0));
+
+  while (standby_plugins.size() > max_size) {
+    util::debug(
+        std::format("{}{} removed from the standby pool", log_tag, standby_plugins.front().first.toStdString()));
+
+    standby_plugins.erase(standby_plugins.begin());
+  }
+}
+
+void EffectsBase::remove_unused_filters() {
+  auto list = (pipeline_type == PipelineType::output ? DbStreamOutputs::plugins() : DbStreamInputs::plugins());
+
+  for (auto it = plugins.begin(); it != plugins.end();) {
+    if (std::ranges::find(list, it->first) == list.end()) {
+      park_plugin(it->first, std::move(it->second));
 
       it = plugins.erase(it);
     } else {
@@ -311,6 +393,499 @@ void EffectsBase::deactivate_filters() {
   }
 }
 
+void EffectsBase::update_analysis_taps(const QStringList& list,
+                                       const std::map<QString, PluginBase*>& instances,
+                                       const ChainFader& fader) {
+  const auto chain = fader.instance_id + "/";
+
+  QString tap = chain + "input";
+
+  for (const auto& name : list) {
+    if (!instances.contains(name)) {
+      continue;
+    }
+
+    instances.at(name)->set_analysis_tap(tap);
+
+    // The level meter does not change the signal. What comes after it sees the same tap.
+
+    if (!name.startsWith(tags::plugin_name::BaseName::levelMeter)) {
+      tap = chain + name;
+    }
+  }
+}
+
+auto EffectsBase::get_chain_instances(const QStringList& list) -> std::map<QString, PluginBase*> {
+  std::map<QString, PluginBase*> instances;
+
+  for (const auto& name : list) {
+    if (plugins.contains(name) && plugins[name] != nullptr) {
+      instances[name] = plugins[name].get();
+    }
+  }
+
+  return instances;
+}
+
+auto EffectsBase::link_chain([[maybe_unused]] const QStringList& list,
+                             [[maybe_unused]] const std::map<QString, PluginBase*>& instances,
+                             [[maybe_unused]] const uint& tail_node_id) -> std::vector<pw_proxy*> {
+  return {};
+}
+
+void EffectsBase::on_plugins_changed() {}
+
+auto EffectsBase::can_crossfade(const QStringList& list) const -> bool {
+  if (!DbMain::chainCrossfade() || !filtersLinked || chain_fader->rate == 0U) {
+    return false;
+  }
+
+  // The echo canceller probe is linked to the output device. It is not something we can have twice.
+
+  const auto is_echo_canceller = [](const auto& name) {
+    return name.startsWith(tags::plugin_name::BaseName::echoCanceller);
+  };
+
+  return !std::ranges::any_of(list, is_echo_canceller) && !std::ranges::any_of(linked_plugins, is_echo_canceller);
+}
+
+auto EffectsBase::crossfade_chain(const QStringList& list) -> bool {
+  if (chain_crossfade_rejected) {
+    chain_crossfade_rejected = false;
+
+    return false;
+  }
+
+  if (chain_crossfade_active || preset_loading) {
+    // The chain being faded in is kept. The new list is handled when its crossfade or the preset load is done.
+
+    chain_crossfade_pending = true;
+
+    return true;
+  }
+
+  if (!can_crossfade(list) || (list == linked_plugins && detached_plugins.empty())) {
+    drop_detached_plugins();
+
+    return false;
+  }
+
+  /**
+   * The running instances are busy in the old chain. Only the plugins whose
+   * settings are changed by a preset get a second instance. Running a plugin
+   * twice for a simple edit of the list would reset its state, so the pipeline
+   * is relinked instead.
+   */
+
+  QStringList duplicated;
+
+  for (const auto& name : list) {
+    if (linked_plugins.contains(name) && plugins.contains(name) && plugins[name] != nullptr) {
+      if (!detached_plugins.contains(name)) {
+        drop_detached_plugins();
+
+        return false;
+      }
+
+      duplicated.append(name);
+    }
+  }
+
+  standby_chain_list = list;
+
+  chain_crossfade_active = true;
+  chain_crossfade_pending = false;
+
+  const auto generation = ++chain_crossfade_generation;
+
+  // Like in create_filters_if_necessary the instances are built in our thread and only the LV2 worlds in parallel
+
+  if (duplicated.size() > 1) {
+    lv2::Lv2Wrapper::preload_worlds(static_cast<size_t>(duplicated.size()));
+  }
+
+  std::vector<std::unique_ptr<PluginBase>> duplicates;
+
+  for (const auto& name : duplicated) {
+    duplicates.push_back(create_plugin(log_tag, pm, pipeline_type, name));
+  }
+
+  lv2::Lv2Wrapper::release_preloaded_worlds();
+
+  link_standby_chain(generation, duplicated, duplicates);
+
+  return true;
+}
+
+void EffectsBase::link_standby_chain(const uint& generation,
+                                     const QStringList& names,
+                                     std::vector<std::unique_ptr<PluginBase>>& duplicates) {
+  if (!chain_crossfade_active || generation != chain_crossfade_generation) {
+    return;
+  }
+
+  std::map<QString, PluginBase*> instances;
+
+  for (const auto& name : standby_chain_list) {
+    if (!names.contains(name) && plugins.contains(name) && plugins[name] != nullptr) {
+      instances[name] = plugins[name].get();
+    }
+  }
+
+  for (qsizetype n = 0; n < names.size(); n++) {
+    if (duplicates[n] == nullptr) {
+      continue;
+    }
+
+    duplicates[n]->setParent(this);
+
+    instances[names[n]] = duplicates[n].get();
+
+    standby_duplicates.insert(std::make_pair(names[n], std::move(duplicates[n])));
+  }
+
+  standby_fader->set_gain(0.0F);
+  standby_fader->set_delay(0U);
+
+  update_analysis_taps(standby_chain_list, instances, *standby_fader);
+
+  standby_chain_proxies = link_chain(standby_chain_list, instances, standby_fader->get_node_id());
+
+  list_proxies.insert(list_proxies.end(), standby_chain_proxies.begin(), standby_chain_proxies.end());
+
+  for (auto* plugin : instances | std::views::values) {
+    plugin->update_probe_links();
+  }
+
+  standby_instances = instances;
+
+  chain_crossfade_ready_polls = 0;
+
+  util::debug(std::format("{}crossfading to a new chain with {} plugins", log_tag, instances.size()));
+
+  wait_for_standby_chain(generation);
+}
+
+void EffectsBase::wait_for_standby_chain(const uint& generation) {
+  if (!chain_crossfade_active || generation != chain_crossfade_generation) {
+    return;
+  }
+
+  const auto ready = std::ranges::all_of(standby_instances | std::views::values,
+                                         [](auto* plugin) { return plugin->is_ready(); });
+
+  if (!ready && ++chain_crossfade_ready_polls < chain_ready_polls) {
+    QTimer::singleShot(chain_poll_ms, this, [this, generation]() { wait_for_standby_chain(generation); });
+
+    return;
+  }
+
+  if (!ready) {
+    util::warning(std::format("{}the plugins of the new chain did not get ready. Fading it in anyway.", log_tag));
+  }
+
+  start_chain_crossfade(generation);
+}
+
+auto EffectsBase::chain_latency_frames(const std::map<QString, PluginBase*>& instances) -> uint {
+  auto seconds = 0.0F;
+
+  for (auto* plugin : instances | std::views::values) {
+    seconds += plugin->get_latency_seconds();
+  }
+
+  return static_cast<uint>(std::lround(seconds * static_cast<float>(chain_fader->rate)));
+}
+
+void EffectsBase::link_dry_fader(const uint& source_node_id) {
+  const auto links = pm->link_nodes(source_node_id, dry_fader->get_node_id());
+
+  list_proxies.insert(list_proxies.end(), links.begin(), links.end());
+
+  // A mono source has only one port to link
+
+  if (links.empty()) {
+    util::warning(std::format("{}link from node {} to the dry fader {} failed", log_tag, source_node_id,
+                              dry_fader->get_node_id()));
+  }
+}
+
+void EffectsBase::update_dry_delay() {
+  /**
+   * Without it the bypass would move the audio in time and during the fade the
+   * two paths would comb filter. While a chain is faded in it is aligned to the
+   * running one, so the running one is enough.
+   */
+
+  const auto frames = chain_latency_frames(get_chain_instances(linked_plugins)) + chain_fader->get_delay();
+
+  if (!dry_fader->set_delay(frames)) {
+    util::warning(std::format("{}the chain latency of {} frames is longer than the dry path can be delayed", log_tag,
+                              frames));
+  }
+}
+
+void EffectsBase::drop_detached_plugins() {
+  if (detached_plugins.empty()) {
+    return;
+  }
+
+  for (const auto& name : detached_plugins) {
+    plugins.erase(name);
+  }
+
+  detached_plugins.clear();
+
+  create_filters_if_necessary();
+}
+
+void EffectsBase::begin_preset_load() {
+  preset_loading = true;
+
+  if (chain_crossfade_active || !can_crossfade(linked_plugins)) {
+    return;
+  }
+
+  for (const auto& name : linked_plugins) {
+    if (plugins.contains(name) && plugins[name] != nullptr) {
+      plugins[name]->detach_settings();
+
+      detached_plugins.append(name);
+    }
+  }
+}
+
+void EffectsBase::end_preset_load() {
+  preset_loading = false;
+
+  if (chain_crossfade_pending) {
+    // The list of plugins changed while the preset was written
+
+    chain_crossfade_pending = false;
+
+    create_filters_if_necessary();
+
+    on_plugins_changed();
+
+    return;
+  }
+
+  if (!detached_plugins.empty() && !crossfade_chain(linked_plugins)) {
+    on_plugins_changed();
+  }
+}
+
+auto EffectsBase::chain_level() const -> float {
+  return global_bypass ? 0.0F : 1.0F;
+}
+
+auto EffectsBase::next_fade_position() const -> uint64_t {
+  /**
+   * The faders are in the same graph and see the same clock positions. A
+   * change scheduled two cycles ahead happens in the same sample for all of
+   * them.
+   */
+
+  return chain_fader->get_processed_position() + (2U * static_cast<uint64_t>(chain_fader->n_samples));
+}
+
+void EffectsBase::set_global_bypass(const bool& state) {
+  global_bypass = state;
+
+  update_dry_delay();
+
+  const auto start = next_fade_position();
+  const auto n_frames = static_cast<uint64_t>(bypass_fade_seconds * static_cast<float>(chain_fader->rate));
+
+  dry_fader->fade_to(1.0F - chain_level(), start, n_frames);
+
+  // During a crossfade the running chain is already going to silence. The bypass applies to the new one.
+
+  if (chain_crossfade_fading) {
+    standby_fader->fade_to(chain_level(), start, n_frames);
+  } else {
+    chain_fader->fade_to(chain_level(), start, n_frames);
+  }
+}
+
+void EffectsBase::start_chain_crossfade(const uint& generation) {
+  if (!chain_crossfade_active || generation != chain_crossfade_generation) {
+    return;
+  }
+
+  /**
+   * Both chains are heard during the fade. When the new chain has less latency
+   * it is delayed to stay in time with the running one, and the delay is faded
+   * out once the old chain is silent. The running chain is never delayed
+   * because its audio would jump in time while it is heard.
+   */
+
+  const auto running_latency = chain_latency_frames(get_chain_instances(linked_plugins));
+  const auto standby_latency = chain_latency_frames(standby_instances);
+
+  const auto alignment = (running_latency > standby_latency) ? running_latency - standby_latency : 0U;
+
+  if (!standby_fader->set_delay(alignment)) {
+    util::warning(std::format("{}the chains differ by {} frames of latency. The pipeline is relinked instead.", log_tag,
+                              alignment));
+
+    abort_chain_crossfade();
+
+    chain_crossfade_rejected = true;
+
+    on_plugins_changed();
+
+    return;
+  }
+
+  const auto start = next_fade_position();
+  const auto n_frames = static_cast<uint64_t>(DbMain::chainCrossfadeTime()) * chain_fader->rate / 1000U;
+
+  chain_fader->fade_to(0.0F, start, n_frames);
+  standby_fader->fade_to(chain_level(), start, n_frames);
+
+  chain_crossfade_fading = true;
+  chain_crossfade_last_position = chain_fader->get_processed_position();
+  chain_crossfade_stalled_polls = 0;
+
+  QTimer::singleShot(DbMain::chainCrossfadeTime(), this, [this, generation]() { finish_chain_crossfade(generation); });
+}
+
+void EffectsBase::finish_chain_crossfade(const uint& generation) {
+  if (!chain_crossfade_active || generation != chain_crossfade_generation) {
+    return;
+  }
+
+  if (!chain_fader->fade_finished() || !standby_fader->fade_finished()) {
+    const auto position = chain_fader->get_processed_position();
+
+    chain_crossfade_stalled_polls = (position == chain_crossfade_last_position) ? chain_crossfade_stalled_polls + 1 : 0;
+
+    chain_crossfade_last_position = position;
+
+    // When the graph stopped nothing is heard and there is no reason to wait for it.
+
+    if (chain_crossfade_stalled_polls < chain_stall_polls) {
+      QTimer::singleShot(chain_poll_ms, this, [this, generation]() { finish_chain_crossfade(generation); });
+
+      return;
+    }
+  }
+
+  // The old chain is silent. Its links are removed and the plugins that are not in the new one are parked.
+
+  for (auto* proxy : chain_proxies) {
+    std::erase(list_proxies, proxy);
+  }
+
+  pm->destroy_links(chain_proxies);
+
+  for (const auto& name : linked_plugins) {
+    if (!standby_chain_list.contains(name) && plugins.contains(name)) {
+      // A plugin that does not follow its settings anymore can not be reused
+
+      if (!detached_plugins.contains(name)) {
+        park_plugin(name, std::move(plugins[name]));
+      }
+
+      plugins.erase(name);
+    }
+  }
+
+  for (auto& [name, duplicate] : standby_duplicates) {
+    plugins[name] = std::move(duplicate);
+  }
+
+  standby_duplicates.clear();
+
+  standby_instances.clear();
+
+  detached_plugins.clear();
+
+  std::swap(chain_fader, standby_fader);
+
+  chain_fader->set_gain(chain_level());
+  standby_fader->set_gain(0.0F);
+  standby_fader->set_delay(0U);
+
+  // Nothing has to be aligned to the new chain anymore. Otherwise the latency could grow with each fade.
+
+  chain_fader->set_delay(0U);
+
+  chain_proxies = std::move(standby_chain_proxies);
+
+  standby_chain_proxies.clear();
+
+  linked_plugins = standby_chain_list;
+
+  update_dry_delay();
+
+  chain_crossfade_active = false;
+  chain_crossfade_fading = false;
+
+  update_analysis_taps(linked_plugins, get_chain_instances(linked_plugins), *chain_fader);
+
+  util::debug(std::format("{}crossfade to the new chain finished", log_tag));
+
+  Q_EMIT pipelineChanged();
+
+  if (chain_crossfade_pending) {
+    chain_crossfade_pending = false;
+
+    create_filters_if_necessary();
+
+    on_plugins_changed();
+  }
+}
+
+void EffectsBase::abort_chain_crossfade() {
+  // The pipeline is relinked after this. The chains do not have to be aligned anymore.
+
+  chain_fader->set_delay(0U);
+  standby_fader->set_delay(0U);
+
+  if (!chain_crossfade_active) {
+    drop_detached_plugins();
+
+    return;
+  }
+
+  chain_crossfade_generation++;  // the pending timers are discarded
+
+  chain_crossfade_active = false;
+  chain_crossfade_fading = false;
+  chain_crossfade_pending = false;
+
+  for (auto* proxy : standby_chain_proxies) {
+    std::erase(list_proxies, proxy);
+  }
+
+  pm->destroy_links(standby_chain_proxies);
+
+  standby_chain_proxies.clear();
+
+  // The running instances that do not follow their settings anymore are replaced by the new ones
+
+  for (auto& [name, duplicate] : standby_duplicates) {
+    if (detached_plugins.contains(name)) {
+      plugins[name] = std::move(duplicate);
+
+      detached_plugins.removeAll(name);
+    }
+  }
+
+  standby_duplicates.clear();
+
+  standby_instances.clear();
+
+  standby_chain_list.clear();
+
+  drop_detached_plugins();
+
+  chain_fader->set_gain(chain_level());
+  standby_fader->set_gain(0.0F);
+}
+
 auto EffectsBase::get_plugins_map() -> std::map<QString, std::unique_ptr<PluginBase>>& {
   return plugins;
 }
@@ -441,7 +1016,9 @@ uint EffectsBase::getPipeLineRate() const {
 uint EffectsBase::getPipeLineLatency() {
   auto list = (pipeline_type == PipelineType::output ? DbStreamOutputs::plugins() : DbStreamInputs::plugins());
 
-  auto v = 0.0F;
+  // The chain fader may delay the chain to keep it in time with the one it replaced
+
+  auto v = chain_fader->get_latency_seconds();
 
   for (const auto& name : list) {
     if (plugins.contains(name) && plugins[name] != nullptr) {
@@ -468,87 +1045,45 @@ void EffectsBase::requestSpectrumData() {
    * main thread and deliver the spectrum list to QML through a signal.
    */
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        auto [rate, bin_hz, list] = spectrum->compute_magnitudes();
+        auto [rate, bin_hz] = spectrum->compute_magnitudes(spectrum_squared_magnitudes);
 
-        if (list.empty() || rate == 0) {
+        if (spectrum_squared_magnitudes.empty() || rate == 0) {
           return;
         }
 
-        const qsizetype n_bands = list.size();
+        const auto n_bins = spectrum_squared_magnitudes.size();
 
-        // Reuse or resize frequency cache based on band count
-        if (cached_spectrum_frequencies.size() != n_bands) {
-          cached_spectrum_frequencies.resize(n_bands);
-
-          for (qsizetype n = 0; n < n_bands; n++) {
-            cached_spectrum_frequencies[n] = static_cast<double>(n) * static_cast<double>(bin_hz);
-          }
-        }
-
-        const auto min_available_freq = static_cast<float>(cached_spectrum_frequencies.front());
-        const auto max_available_freq = static_cast<float>(cached_spectrum_frequencies.back());
-        const auto min_freq =
-            std::clamp(static_cast<float>(DbSpectrum::minimumFrequency()), min_available_freq, max_available_freq);
-        const auto max_freq =
-            std::clamp(static_cast<float>(DbSpectrum::maximumFrequency()), min_available_freq, max_available_freq);
+        const auto max_available_freq = static_cast<float>(n_bins - 1U) * bin_hz;
+        const auto min_freq = std::clamp(static_cast<float>(DbSpectrum::minimumFrequency()), 0.0F, max_available_freq);
+        const auto max_freq = std::clamp(static_cast<float>(DbSpectrum::maximumFrequency()), 0.0F, max_available_freq);
 
         if (min_freq > (max_freq - 100.0F)) {
           return;
         }
 
-        const int npoints = DbSpectrum::nPoints();
-        const bool log_axis = DbSpectrum::logarithmicHorizontalAxis();
-
-        const bool axis_settings_changed =
-            (cached_spectrum_min_freq != min_freq || cached_spectrum_max_freq != max_freq ||
-             cached_spectrum_npoints != npoints || cached_spectrum_log_axis != log_axis);
-
-        if (axis_settings_changed) {
-          if (log_axis) {
-            cached_spectrum_x_axis = util::logspace(min_freq, max_freq, npoints);
-          } else {
-            cached_spectrum_x_axis = util::linspace(min_freq, max_freq, npoints);
-          }
-
-          cached_spectrum_min_freq = min_freq;
-          cached_spectrum_max_freq = max_freq;
-          cached_spectrum_npoints = npoints;
-          cached_spectrum_log_axis = log_axis;
-        }
+        // The table is only rebuilt when the axis settings change.
 
-        if (spline == nullptr) {
-          // The spectrum plugin sends arrays that always have the same size. So we can do this only once.
-          spline = gsl_spline_alloc(gsl_interp_steffen, n_bands);
-        }
+        spectrum_axis.update(n_bins, bin_hz, min_freq, max_freq, static_cast<uint>(DbSpectrum::nPoints()),
+                             DbSpectrum::logarithmicHorizontalAxis());
 
-        gsl_spline_init(spline, cached_spectrum_frequencies.data(), list.data(), n_bands);
+        const auto& x_axis = spectrum_axis.frequencies();
 
-        // Reuse or resize magnitude cache
-        if (cached_spectrum_mag.size() != static_cast<int>(cached_spectrum_x_axis.size())) {
-          cached_spectrum_mag.resize(cached_spectrum_x_axis.size());
-        }
+        spectrum_db.resize(x_axis.size());
 
-        for (size_t n = 0; n < cached_spectrum_x_axis.size(); n++) {
-          cached_spectrum_mag[n] = gsl_spline_eval(spline, cached_spectrum_x_axis[n], gsl_acc);
-        }
+        spectrum_axis.map(spectrum_squared_magnitudes, spectrum_db);
 
-        // Build output without extra temporary allocations
-        QList<QPointF> output_data(cached_spectrum_mag.size());
+        QList<QPointF> output_data(static_cast<qsizetype>(x_axis.size()));
 
-        for (qsizetype n = 0; n < cached_spectrum_mag.size(); n++) {
-          output_data[n] = QPointF(cached_spectrum_x_axis[n], cached_spectrum_mag[n]);
+        for (size_t n = 0U; n < x_axis.size(); n++) {
+          output_data[static_cast<qsizetype>(n)] = QPointF(x_axis[n], spectrum_db[n]);
         }
 
         Q_EMIT newSpectrumData(output_data);
       },
-      Qt::QueuedConnection);
-
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::normal);
 }
 
 void EffectsBase::setUpdateLevelMeters(const bool& state) {
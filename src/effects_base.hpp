@@ -19,8 +19,6 @@
 
 #pragma once
 
-#include <gsl/gsl_interp.h>
-#include <gsl/gsl_spline.h>
 #include <kconfigskeleton.h>
 #include <pipewire/proxy.h>
 #include <qlist.h>
@@ -29,17 +27,23 @@
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <QString>
+#include <QStringList>
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
+#include "chain_fader.hpp"
 #include "output_level.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "spectrum.hpp"
+#include "spectrum_axis.hpp"
+#include "worker_pool.hpp"
 
-class EffectsBaseWorker : public QObject {
+class EffectsBaseWorker : public WorkerContext {
   Q_OBJECT
 };
 
@@ -67,8 +71,19 @@ class EffectsBase : public QObject {
   std::shared_ptr<OutputLevel> output_level;
   std::shared_ptr<Spectrum> spectrum;
 
+  // Last nodes of the running chain and of the chain that is faded in when the list of plugins changes.
+  std::shared_ptr<ChainFader> chain_fader, standby_fader;
+
+  // Takes the signal from the pipeline source straight to spectrum. It is heard only when the effects are bypassed.
+  std::shared_ptr<ChainFader> dry_fader;
+
   auto get_plugins_map() -> std::map<QString, std::unique_ptr<PluginBase>>&;
 
+  static auto create_plugin(const std::string& log_tag,
+                            pw::Manager* pm,
+                            const PipelineType& pipeline_type,
+                            const QString& name) -> std::unique_ptr<PluginBase>;
+
   Q_INVOKABLE QVariant getPluginInstance(const QString& pluginName);
 
   Q_INVOKABLE [[nodiscard]] uint getPipeLineRate() const;
@@ -85,6 +100,22 @@ class EffectsBase : public QObject {
 
   Q_INVOKABLE void setSpectrumBypass(const bool& state);
 
+  /**
+   * Fades the plugins out and the unprocessed signal in, or the other way
+   * around. Nothing is unlinked, so the plugins keep running and the state
+   * can be toggled as often as wanted.
+   */
+  void set_global_bypass(const bool& state);
+
+  /**
+   * Called around the writing of the settings of a preset. The running chain
+   * keeps the parameters it has meanwhile and a chain made with the new ones
+   * is faded in when the preset is loaded, even if the plugins are the same.
+   */
+  void begin_preset_load();
+
+  void end_preset_load();
+
  Q_SIGNALS:
   void pipelineChanged();
   void newSpectrumData(QList<QPointF> newData);
@@ -95,31 +126,145 @@ class EffectsBase : public QObject {
 
   std::map<QString, std::unique_ptr<PluginBase>> plugins;
 
+  /**
+   * Plugins recently removed from the pipeline. They are kept alive with their
+   * PipeWire filter and internal buffers so adding them back is cheap. The
+   * oldest entries are at the front.
+   */
+  std::vector<std::pair<QString, std::unique_ptr<PluginBase>>> standby_plugins;
+
   std::vector<pw_proxy*> list_proxies, list_proxies_listen_mic;
 
+  // Plugins linked in the running chain and the links between them. These links are also in list_proxies.
+  QStringList linked_plugins;
+
+  std::vector<pw_proxy*> chain_proxies;
+
   EffectsBaseWorker* baseWorker;
 
-  QThread workerThread;
+  QThread* workerThread = nullptr;
 
   void create_filters_if_necessary();
 
+  auto take_standby_plugin(const QString& name) -> std::unique_ptr<PluginBase>;
+
+  void park_plugin(const QString& name, std::unique_ptr<PluginBase> plugin);
+
+  void trim_standby_plugins();
+
   void remove_unused_filters();
 
   void activate_filters();
 
   void deactivate_filters();
 
+  /**
+   * Tells each plugin of the list which chain position feeds it, so equal
+   * loudness measurements can be shared. The taps are named after the fader
+   * that ends the chain, so the two chains of a crossfade never share them.
+   */
+  void update_analysis_taps(const QStringList& list,
+                            const std::map<QString, PluginBase*>& instances,
+                            const ChainFader& fader);
+
+  // Running instances of the plugins of the list.
+  auto get_chain_instances(const QStringList& list) -> std::map<QString, PluginBase*>;
+
+  /**
+   * Links the source of the pipeline through the given plugins to the node
+   * tail_node_id and returns the links that were made.
+   */
+  virtual auto link_chain(const QStringList& list,
+                          const std::map<QString, PluginBase*>& instances,
+                          const uint& tail_node_id) -> std::vector<pw_proxy*>;
+
+  // Called when the list of plugins changed and the chain has to follow it.
+  virtual void on_plugins_changed();
+
+  /**
+   * Links a chain with the new list of plugins next to the running one and
+   * crossfades to it. Returns false when the pipeline has to be relinked
+   * instead.
+   */
+  auto crossfade_chain(const QStringList& list) -> bool;
+
+  // Links the source of the pipeline to the dry fader. The links are added to list_proxies.
+  void link_dry_fader(const uint& source_node_id);
+
+  // Latency of the given plugins in frames of the graph rate.
+  auto chain_latency_frames(const std::map<QString, PluginBase*>& instances) -> uint;
+
+  // Removes the chain being faded in. The running chain is heard again unless the effects are bypassed.
+  void abort_chain_crossfade();
+
  private:
-  int cached_spectrum_npoints = -1;
-  float cached_spectrum_min_freq = -1.0F;
-  float cached_spectrum_max_freq = -1.0F;
-  bool cached_spectrum_log_axis = false;
+  static constexpr int chain_poll_ms = 10;
+
+  static constexpr int chain_ready_polls = 200;  // The new chain is faded in after two seconds even if it is not ready
+
+  static constexpr int chain_stall_polls = 100;  // One second without new cycles means the graph is not running
+
+  static constexpr float bypass_fade_seconds = 0.02F;
+
+  bool global_bypass = false;
+
+  /**
+   * While the chains are crossfaded the plugins that are in both of them run
+   * twice. The second instances are kept here and replace the running ones
+   * when the crossfade is done.
+   */
+  std::map<QString, std::unique_ptr<PluginBase>> standby_duplicates;
+
+  std::vector<pw_proxy*> standby_chain_proxies;
+
+  QStringList standby_chain_list;
+
+  // Plugins of the chain being faded in. Some of them are in standby_duplicates.
+  std::map<QString, PluginBase*> standby_instances;
+
+  // Running plugins that stopped following their settings. They are replaced when the crossfade is done.
+  QStringList detached_plugins;
+
+  bool chain_crossfade_active = false;
+  bool chain_crossfade_fading = false;  // the new chain is ready and the faders are moving
+  bool chain_crossfade_pending = false;
+  bool chain_crossfade_rejected = false;  // the chains could not be aligned and the next change relinks them
+  bool preset_loading = false;
+
+  uint chain_crossfade_generation = 0U;
+
+  uint64_t chain_crossfade_last_position = 0U;
+
+  int chain_crossfade_stalled_polls = 0;
+  int chain_crossfade_ready_polls = 0;
+
+  // Gain of the running chain. It is zero while the effects are bypassed.
+  [[nodiscard]] auto chain_level() const -> float;
+
+  // First clock position that none of the faders has processed yet.
+  [[nodiscard]] auto next_fade_position() const -> uint64_t;
+
+  [[nodiscard]] auto can_crossfade(const QStringList& list) const -> bool;
+
+  void link_standby_chain(const uint& generation,
+                          const QStringList& names,
+                          std::vector<std::unique_ptr<PluginBase>>& duplicates);
+
+  // Polls the plugins of the new chain and starts the crossfade when all of them are ready.
+  void wait_for_standby_chain(const uint& generation);
+
+  // Replaces the plugins that stopped following their settings with new instances.
+  void drop_detached_plugins();
+
+  // Delays the unprocessed signal by the latency of the running chain.
+  void update_dry_delay();
+
+  void start_chain_crossfade(const uint& generation);
 
-  gsl_interp_accel* gsl_acc = gsl_interp_accel_alloc();
-  gsl_spline* spline = nullptr;
+  void finish_chain_crossfade(const uint& generation);
 
-  QList<double> cached_spectrum_frequencies;
-  QList<double> cached_spectrum_mag;
+  SpectrumAxis spectrum_axis;
 
-  std::vector<float> cached_spectrum_x_axis;
+  std::vector<float> spectrum_squared_magnitudes;
+  std::vector<float> spectrum_db;
 };
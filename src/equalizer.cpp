@@ -20,6 +20,7 @@
 #include "equalizer.hpp"
 #include <qlist.h>
 #include <qnamespace.h>
+#include <qmetaobject.h>
 #include <qobject.h>
 #include <sys/types.h>
 #include <QApplication>
@@ -44,9 +45,11 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_equalizer.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 using namespace std::string_literals;
 
@@ -78,6 +81,9 @@ Equalizer::Equalizer(const std::string& tag, pw::Manager* pipe_manager, Pipeline
 
   init_common_controls<DbEqualizer>(settings);
 
+  settings_objects.push_back(settings_left);
+  settings_objects.push_back(settings_right);
+
   BIND_LV2_PORT("mode", mode, setMode, DbEqualizer::modeChanged);
   BIND_LV2_PORT("bal", balance, setBalance, DbEqualizer::balanceChanged);
   BIND_LV2_PORT("frqs_l", pitchLeft, setPitchLeft, DbEqualizer::pitchLeftChanged);
@@ -98,7 +104,7 @@ Equalizer::Equalizer(const std::string& tag, pw::Manager* pipe_manager, Pipeline
    * But it is the easiest thing to do in the case below.
    */
 
-  connect(settings, &DbEqualizer::numBandsChanged, [&]() {
+  connect(settings, &DbEqualizer::numBandsChanged, this, [&]() {
     for (int n = 0; n < max_bands; n++) {
       if (n >= settings->numBands()) {  // turn off unused bands
         settings_left->setProperty(tags::equalizer::band_type[n].data(), 0);
@@ -110,7 +116,26 @@ Equalizer::Equalizer(const std::string& tag, pw::Manager* pipe_manager, Pipeline
     }
   });
 
-  connect(settings, &DbEqualizer::splitChannelsChanged, [&]() { on_split_channels(); });
+  connect(settings, &DbEqualizer::splitChannelsChanged, this, [&]() { on_split_channels(); });
+
+  // Each band has its own signals. They are found through the property names.
+
+  const auto tail_slot = metaObject()->method(metaObject()->indexOfSlot("update_tail()"));
+
+  for (auto* channel : {settings_left, settings_right}) {
+    const auto* channel_meta = channel->metaObject();
+
+    for (int n = 0; n < max_bands; n++) {
+      for (const auto* key : {tags::equalizer::band_type[n].data(), tags::equalizer::band_frequency[n].data(),
+                              tags::equalizer::band_q[n].data()}) {
+        connect(channel, channel_meta->property(channel_meta->indexOfProperty(key)).notifySignal(), this, tail_slot);
+      }
+    }
+  }
+
+  connect(settings, &DbEqualizer::numBandsChanged, this, &Equalizer::update_tail);
+
+  update_tail();
 }
 
 Equalizer::~Equalizer() {
@@ -120,9 +145,9 @@ Equalizer::~Equalizer() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
-  settings_left->disconnect();
-  settings_right->disconnect();
+  settings->disconnect(this);
+  settings_left->disconnect(this);
+  settings_right->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -223,20 +248,18 @@ void Equalizer::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Equalizer::process(std::span<float>& left_in,
@@ -256,23 +279,17 @@ void Equalizer::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   // This plugin gives the latency in number of samples
 
@@ -283,7 +300,7 @@ void Equalizer::process(std::span<float>& left_in,
 
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
   }
@@ -364,6 +381,25 @@ auto Equalizer::get_latency_seconds() -> float {
   return latency_value;
 }
 
+void Equalizer::update_tail() {
+  auto ring = 0.0F;
+
+  for (auto* channel : {settings_left, settings_right}) {
+    for (int n = 0; n < std::min(settings->numBands(), max_bands); n++) {
+      if (channel->property(tags::equalizer::band_type[n].data()).value<int>() == 0) {
+        continue;  // the band is off
+      }
+
+      const auto frequency = channel->property(tags::equalizer::band_frequency[n].data()).value<double>();
+      const auto quality = channel->property(tags::equalizer::band_q[n].data()).value<double>();
+
+      ring = std::max(ring, filter_ring_seconds(frequency, quality));
+    }
+  }
+
+  tail_seconds = filter_tail_seconds + ring;
+}
+
 void Equalizer::flatResponse() {
   RESET_BANDS_PROPERTY(settings_left, Gain);
   RESET_BANDS_PROPERTY(settings_right, Gain);
@@ -95,4 +95,8 @@ class Equalizer : public PluginBase {
   void bind_right_bands();
 
   void on_split_channels();
+
+ private Q_SLOTS:
+  // The tail follows the band that rings the longest.
+  void update_tail();
 };
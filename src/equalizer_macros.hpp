@@ -24,7 +24,7 @@
   {                                                                                                                  \
     lv2_wrapper->set_control_port_value(key, static_cast<float>(settings_obj->getter()));                            \
     lv2_wrapper->sync_funcs.emplace_back([&]() { settings_obj->setter(lv2_wrapper->get_control_port_value(key)); }); \
-    connect(settings_obj, &onChangedSignal, [this]() {                                                               \
+    connect(settings_obj, &onChangedSignal, this, [this]() {                                                         \
       if (this == nullptr || settings_obj == nullptr || lv2_wrapper == nullptr) {                                    \
         return;                                                                                                      \
       }                                                                                                              \
@@ -45,7 +45,7 @@
           ((enforceLowerBound) & (linear_v == 0.0F)) ? util::minimum_db_d_level : util::linear_to_db(linear_v); \
       settings_obj->setter(db_v);                                                                               \
     });                                                                                                         \
-    connect(settings_obj, &onChangedSignal, [this]() {                                                          \
+    connect(settings_obj, &onChangedSignal, this, [this]() {                                                    \
       if (this == nullptr || settings_obj == nullptr || lv2_wrapper == nullptr) {                               \
         return;                                                                                                 \
       }                                                                                                         \
@@ -193,15 +193,15 @@
                       DbEqualizerChannel::band31##property##Changed, enforceLowerBound);       \
   }
 
-#define UNIFIED_BAND_PORT_BIND(settings_right, settings_left, getter, setter, onChangedSignal) \
-  {                                                                                            \
-    settings_right->setter(settings_left->getter());                                           \
-    unified_mode_connections.push_back(connect(settings_left, &onChangedSignal, [this]() {     \
-      if (this == nullptr || settings_right == nullptr || settings_left == nullptr) {          \
-        return;                                                                                \
-      }                                                                                        \
-      settings_right->setter(settings_left->getter());                                         \
-    }));                                                                                       \
+#define UNIFIED_BAND_PORT_BIND(settings_right, settings_left, getter, setter, onChangedSignal)   \
+  {                                                                                              \
+    settings_right->setter(settings_left->getter());                                             \
+    unified_mode_connections.push_back(connect(settings_left, &onChangedSignal, this, [this]() { \
+      if (this == nullptr || settings_right == nullptr || settings_left == nullptr) {            \
+        return;                                                                                  \
+      }                                                                                          \
+      settings_right->setter(settings_left->getter());                                           \
+    }));                                                                                         \
   }
 
 #define UNIFIED_BANDS_PROPERTY_BIND(settings_right, settings_left, property)                     \
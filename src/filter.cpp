@@ -35,8 +35,10 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Filter::Filter(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -71,6 +73,15 @@ Filter::Filter(const std::string& tag, pw::Manager* pipe_manager, PipelineType p
   BIND_LV2_PORT("mode", equalMode, setEqualMode, DbFilter::equalModeChanged);
   BIND_LV2_PORT("s", slope, setSlope, DbFilter::slopeChanged);
   BIND_LV2_PORT("decramp", decramp, setDecramp, DbFilter::decrampChanged);
+
+  const auto update_tail = [this] {
+    tail_seconds = filter_tail_seconds + filter_ring_seconds(settings->frequency(), settings->quality());
+  };
+
+  update_tail();
+
+  connect(settings, &DbFilter::frequencyChanged, this, update_tail);
+  connect(settings, &DbFilter::qualityChanged, this, update_tail);
 }
 
 Filter::~Filter() {
@@ -80,7 +91,7 @@ Filter::~Filter() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -120,20 +131,18 @@ void Filter::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Filter::process(std::span<float>& left_in,
@@ -153,23 +162,17 @@ void Filter::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   // This plugin gives the latency in number of samples
 
@@ -180,7 +183,7 @@ void Filter::process(std::span<float>& left_in,
 
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
   }
@@ -200,3 +203,4 @@ void Filter::process([[maybe_unused]] std::span<float>& left_in,
 auto Filter::get_latency_seconds() -> float {
   return this->latency_value;
 }
+
@@ -22,13 +22,14 @@
 #include <cstddef>
 #include <string>
 #include <utility>
+#include <vector>
 #include "fir_filter_base.hpp"
 
 FirFilterBandpass::FirFilterBandpass(std::string tag) : FirFilterBase(std::move(tag)) {}
 
 FirFilterBandpass::~FirFilterBandpass() = default;
 
-void FirFilterBandpass::setup() {
+auto FirFilterBandpass::design_kernel() const -> std::vector<float> {
   const auto lowpass_kernel = create_lowpass_kernel(max_frequency, transition_band);
 
   // high-pass kernel
@@ -39,20 +40,18 @@ void FirFilterBandpass::setup() {
 
   highpass_kernel[(highpass_kernel.size() - 1U) / 2U] += 1.0F;
 
-  kernel.resize(highpass_kernel.size());
+  std::vector<float> output(highpass_kernel.size());
 
   // Creating a bandpass from a band reject through spectral inversion
   // https://www.dspguide.com/ch16/4.htm
 
-  for (size_t n = 0U; n < kernel.size(); n++) {
-    kernel[n] = lowpass_kernel[n] + highpass_kernel[n];
+  for (size_t n = 0U; n < output.size(); n++) {
+    output[n] = lowpass_kernel[n] + highpass_kernel[n];
   }
 
-  std::ranges::for_each(kernel, [](auto& v) { v *= -1.0F; });
+  std::ranges::for_each(output, [](auto& v) { v *= -1.0F; });
 
-  kernel[(kernel.size() - 1U) / 2U] += 1.0F;
+  output[(output.size() - 1U) / 2U] += 1.0F;
 
-  delay = 0.5F * static_cast<float>(kernel.size() - 1U) / static_cast<float>(rate);
-
-  setup_zita();
+  return output;
 }
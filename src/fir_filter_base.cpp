@@ -26,10 +26,13 @@
 #include <cmath>
 #include <cstddef>
 #include <format>
+#include <memory>
 #include <mutex>
 #include <numbers>
 #include <string>
 #include <thread>
+#include <typeindex>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 #include "util.hpp"
@@ -86,7 +89,59 @@ void FirFilterBase::set_transition_band(const float& value) {
   transition_band = value;
 }
 
-void FirFilterBase::setup() {}
+void FirFilterBase::setup() {
+  if (rate == 0U) {
+    return;
+  }
+
+  auto new_kernel = cached_kernel();
+
+  if (new_kernel->empty()) {
+    return;
+  }
+
+  delay = 0.5F * static_cast<float>(new_kernel->size() - 1U) / static_cast<float>(rate);
+
+  if (zita_ready && conv != nullptr && new_kernel == kernel && n_samples == zita_n_samples) {
+    return;
+  }
+
+  kernel = std::move(new_kernel);
+
+  setup_zita();
+}
+
+auto FirFilterBase::design_kernel() const -> std::vector<float> {
+  return {};
+}
+
+auto FirFilterBase::cached_kernel() const -> std::shared_ptr<const std::vector<float>> {
+  std::scoped_lock<std::mutex> lock(cache_mutex);
+
+  std::erase_if(cache, [](const auto& entry) { return entry.kernel.expired(); });
+
+  const std::type_index type(typeid(*this));
+
+  for (const auto& entry : cache) {
+    if (entry.type == type && entry.rate == rate && entry.min_frequency == min_frequency &&
+        entry.max_frequency == max_frequency && entry.transition_band == transition_band) {
+      if (auto cached = entry.kernel.lock()) {
+        return cached;
+      }
+    }
+  }
+
+  auto designed = std::make_shared<const std::vector<float>>(design_kernel());
+
+  cache.push_back({.type = type,
+                   .rate = rate,
+                   .min_frequency = min_frequency,
+                   .max_frequency = max_frequency,
+                   .transition_band = transition_band,
+                   .kernel = designed});
+
+  return designed;
+}
 
 auto FirFilterBase::create_lowpass_kernel(const float& cutoff, const float& transition_band) const
     -> std::vector<float> {
@@ -153,7 +208,7 @@ void FirFilterBase::setup_zita() {
 
   zita_ready = false;
 
-  if (n_samples == 0U || kernel.empty()) {
+  if (n_samples == 0U || kernel == nullptr || kernel->empty()) {
     return;
   }
 
@@ -165,7 +220,9 @@ void FirFilterBase::setup_zita() {
 
   float density = 0.5F;
 
-  int ret = conv->configure(2, 2, kernel.size(), n_samples, n_samples, Convproc::MAXPART, density);
+  const auto kernel_size = static_cast<int>(kernel->size());
+
+  int ret = conv->configure(2, 2, kernel->size(), n_samples, n_samples, Convproc::MAXPART, density);
 
   if (ret != 0) {
     util::warning(std::format("{}can't initialise zita-convolver engine: {}", log_tag, ret));
@@ -173,7 +230,7 @@ void FirFilterBase::setup_zita() {
     return;
   }
 
-  ret = conv->impdata_create(0, 0, 1, kernel.data(), 0, static_cast<int>(kernel.size()));
+  ret = conv->impdata_create(0, 0, 1, const_cast<float*>(kernel->data()), 0, kernel_size);
 
   if (ret != 0) {
     util::warning(std::format("{}left impdata_create failed: {}", log_tag, ret));
@@ -181,10 +238,11 @@ void FirFilterBase::setup_zita() {
     return;
   }
 
-  ret = conv->impdata_create(1, 1, 1, kernel.data(), 0, static_cast<int>(kernel.size()));
+  // Both channels use the same kernel, so the right one shares the partitions of the left one
+  ret = conv->impdata_link(0, 0, 1, 1);
 
   if (ret != 0) {
-    util::warning(std::format("{}right impdata_create failed: {}", log_tag, ret));
+    util::warning(std::format("{}right impdata_link failed: {}", log_tag, ret));
 
     return;
   }
@@ -202,6 +260,8 @@ void FirFilterBase::setup_zita() {
 
   // conv->print();
 
+  zita_n_samples = n_samples;
+
   zita_ready = true;
 }
 
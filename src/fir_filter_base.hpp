@@ -23,10 +23,13 @@
 #include <zita-convolver.h>
 #include <algorithm>
 #include <format>
+#include <memory>
 #include <mutex>
 #include <span>
 #include <string>
+#include <typeindex>
 #include <vector>
+#include "rt_log.hpp"
 #include "util.hpp"
 
 class FirFilterBase {
@@ -48,7 +51,12 @@ class FirFilterBase {
 
   void set_transition_band(const float& value);
 
-  virtual void setup();
+  /**
+   * Gets the kernel for the current parameters and loads it in the convolver.
+   * Nothing is planned again when neither the kernel nor the block size have
+   * changed since the last call.
+   */
+  void setup();
 
   void free_zita();
 
@@ -71,7 +79,7 @@ class FirFilterBase {
       const int& ret = conv->process(true);  // thread sync mode set to true
 
       if (ret != 0) {
-        util::debug(std::format("{}IR: process failed: {}", log_tag, ret));
+        util::rt_debug("{}IR: process failed: {}", log_tag, ret);
 
         zita_ready = false;
       } else {
@@ -94,14 +102,44 @@ class FirFilterBase {
   float transition_band = 100.0F;  // Hz
   float delay = 0.0F;
 
-  std::vector<float> kernel;
+  std::shared_ptr<const std::vector<float>> kernel;
 
   Convproc* conv = nullptr;
 
+  // Builds the kernel for the current parameters. Only called when no other filter is using it.
+  [[nodiscard]] virtual auto design_kernel() const -> std::vector<float>;
+
   [[nodiscard]] auto create_lowpass_kernel(const float& cutoff, const float& transition_band) const
       -> std::vector<float>;
 
   void setup_zita();
 
   static void direct_conv(const std::vector<float>& a, const std::vector<float>& b, std::vector<float>& c);
+
+ private:
+  /**
+   * Kernels used by the filter instances. Identical filters, like the
+   * crystalizer bands in the input and output pipelines, share the same
+   * kernel instead of designing it again. An entry is dropped once no filter
+   * uses its kernel.
+   */
+  struct CacheEntry {
+    std::type_index type;
+
+    uint rate = 0U;
+
+    float min_frequency = 0.0F;
+    float max_frequency = 0.0F;
+    float transition_band = 0.0F;
+
+    std::weak_ptr<const std::vector<float>> kernel;
+  };
+
+  inline static std::mutex cache_mutex;
+
+  inline static std::vector<CacheEntry> cache;
+
+  uint zita_n_samples = 0U;
+
+  [[nodiscard]] auto cached_kernel() const -> std::shared_ptr<const std::vector<float>>;
 };
@@ -21,20 +21,19 @@
 #include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 #include "fir_filter_base.hpp"
 
 FirFilterHighpass::FirFilterHighpass(std::string tag) : FirFilterBase(std::move(tag)) {}
 
 FirFilterHighpass::~FirFilterHighpass() = default;
 
-void FirFilterHighpass::setup() {
-  kernel = create_lowpass_kernel(min_frequency, transition_band);
+auto FirFilterHighpass::design_kernel() const -> std::vector<float> {
+  auto output = create_lowpass_kernel(min_frequency, transition_band);
 
-  std::ranges::for_each(kernel, [](auto& v) { v *= -1.0F; });
+  std::ranges::for_each(output, [](auto& v) { v *= -1.0F; });
 
-  kernel[(kernel.size() - 1U) / 2U] += 1.0F;
+  output[(output.size() - 1U) / 2U] += 1.0F;
 
-  delay = 0.5F * static_cast<float>(kernel.size() - 1U) / static_cast<float>(rate);
-
-  setup_zita();
+  return output;
 }
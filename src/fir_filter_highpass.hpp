@@ -20,6 +20,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "fir_filter_base.hpp"
 
 class FirFilterHighpass : public FirFilterBase {
@@ -31,5 +32,6 @@ class FirFilterHighpass : public FirFilterBase {
   auto operator=(const FirFilterHighpass&&) -> FirFilterHighpass& = delete;
   ~FirFilterHighpass() override;
 
-  void setup() override;
+ protected:
+  [[nodiscard]] auto design_kernel() const -> std::vector<float> override;
 };
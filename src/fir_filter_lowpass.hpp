@@ -20,6 +20,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "fir_filter_base.hpp"
 
 class FirFilterLowpass : public FirFilterBase {
@@ -31,5 +32,6 @@ class FirFilterLowpass : public FirFilterBase {
   auto operator=(const FirFilterLowpass&&) -> FirFilterLowpass& = delete;
   ~FirFilterLowpass() override;
 
-  void setup() override;
+ protected:
+  [[nodiscard]] auto design_kernel() const -> std::vector<float> override;
 };
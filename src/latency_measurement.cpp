@@ -0,0 +1,507 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "latency_measurement.hpp"
+#include <fftw3.h>
+#include <pipewire/filter.h>
+#include <pipewire/keys.h>
+#include <pipewire/port.h>
+#include <pipewire/properties.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qpoint.h>
+#include <qtimer.h>
+#include <spa/node/io.h>
+#include <spa/utils/hook.h>
+#include <sys/types.h>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <thread>
+#include <vector>
+#include "pw_manager.hpp"
+#include "tags_app.hpp"
+#include "test_signals.hpp"
+#include "util.hpp"
+
+namespace {
+
+void on_process(void* userdata, spa_io_position* position) {
+  auto* d = static_cast<LatencyMeasurement::data*>(userdata);
+
+  const auto n_samples = position->clock.duration;
+
+  if (n_samples == 0 || !d->lm->armed.load(std::memory_order_acquire) ||
+      d->lm->capture_done.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  // Both filters are driven by the same clock. So the position tells which sample of the sweep is arriving.
+
+  const auto sweep_start = d->lm->ts->get_sweep_start();
+
+  if (sweep_start == TestSignals::invalid_position || position->clock.position + n_samples <= sweep_start) {
+    return;
+  }
+
+  auto* in_left = static_cast<float*>(pw_filter_get_dsp_buffer(d->in_left, n_samples));
+  auto* in_right = static_cast<float*>(pw_filter_get_dsp_buffer(d->in_right, n_samples));
+
+  if (in_left == nullptr || in_right == nullptr) {
+    return;
+  }
+
+  std::span left_in(in_left, n_samples);
+  std::span right_in(in_right, n_samples);
+
+  auto& capture = d->lm->capture;
+
+  for (uint n = 0U; n < n_samples; n++) {
+    const auto clock_position = position->clock.position + n;
+
+    if (clock_position < sweep_start) {
+      continue;
+    }
+
+    const auto idx = clock_position - sweep_start;
+
+    if (idx >= capture.size()) {
+      break;
+    }
+
+    capture[idx] = 0.5F * (left_in[n] + right_in[n]);
+  }
+
+  if (position->clock.position + n_samples - sweep_start >= capture.size()) {
+    d->lm->capture_done.store(true, std::memory_order_release);
+  }
+}
+
+void on_filter_state_changed(void* userdata,
+                             [[maybe_unused]] pw_filter_state old,
+                             pw_filter_state state,
+                             [[maybe_unused]] const char* error) {
+  auto* d = static_cast<LatencyMeasurement::data*>(userdata);
+
+  d->lm->state = state;
+
+  d->lm->can_get_node_id = state == PW_FILTER_STATE_STREAMING || state == PW_FILTER_STATE_PAUSED;
+}
+
+const struct pw_filter_events filter_events = {.version = 0,
+                                               .destroy = nullptr,
+                                               .state_changed = on_filter_state_changed,
+                                               .io_changed = nullptr,
+                                               .param_changed = nullptr,
+                                               .add_buffer = nullptr,
+                                               .remove_buffer = nullptr,
+                                               .process = on_process,
+                                               .drained = nullptr,
+                                               .command = nullptr};
+
+}  // namespace
+
+LatencyMeasurement::LatencyMeasurement(pw::Manager* pipe_manager, TestSignals* test_signals)
+    : ts(test_signals), pm(pipe_manager) {
+  pf_data.lm = this;
+
+  const auto* filter_name = "ee_latency_capture";
+
+  pm->lock();
+
+  auto* props_filter = pw_properties_new(nullptr, nullptr);
+
+  pw_properties_set(props_filter, PW_KEY_APP_ID, tags::app::id);
+  pw_properties_set(props_filter, PW_KEY_NODE_NAME, filter_name);
+  pw_properties_set(props_filter, PW_KEY_NODE_DESCRIPTION, "Easy Effects Filter");
+  pw_properties_set(props_filter, PW_KEY_MEDIA_TYPE, "Audio");
+  pw_properties_set(props_filter, PW_KEY_MEDIA_CATEGORY, "Capture");
+  pw_properties_set(props_filter, PW_KEY_MEDIA_ROLE, "DSP");
+
+  filter = pw_filter_new(pm->core, filter_name, props_filter);
+
+  // left channel input
+
+  auto* props_in_left = pw_properties_new(nullptr, nullptr);
+
+  pw_properties_set(props_in_left, PW_KEY_FORMAT_DSP, "32 bit float mono audio");
+  pw_properties_set(props_in_left, PW_KEY_PORT_NAME, "input_FL");
+  pw_properties_set(props_in_left, "audio.channel", "FL");
+
+  pf_data.in_left = static_cast<port*>(pw_filter_add_port(filter, PW_DIRECTION_INPUT, PW_FILTER_PORT_FLAG_MAP_BUFFERS,
+                                                          sizeof(port), props_in_left, nullptr, 0));
+
+  // right channel input
+
+  auto* props_in_right = pw_properties_new(nullptr, nullptr);
+
+  pw_properties_set(props_in_right, PW_KEY_FORMAT_DSP, "32 bit float mono audio");
+  pw_properties_set(props_in_right, PW_KEY_PORT_NAME, "input_FR");
+  pw_properties_set(props_in_right, "audio.channel", "FR");
+
+  pf_data.in_right = static_cast<port*>(pw_filter_add_port(filter, PW_DIRECTION_INPUT, PW_FILTER_PORT_FLAG_MAP_BUFFERS,
+                                                           sizeof(port), props_in_right, nullptr, 0));
+
+  if (pw_filter_connect(filter, PW_FILTER_FLAG_RT_PROCESS, nullptr, 0) != 0) {
+    pm->unlock();
+
+    util::warning(std::format("{} cannot connect the filter to PipeWire!", filter_name));
+
+    return;
+  }
+
+  pw_filter_add_listener(filter, &listener, &filter_events, &pf_data);
+
+  pm->sync_wait_unlock();
+
+  while (!can_get_node_id) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    if (state == PW_FILTER_STATE_ERROR) {
+      util::warning(std::format("{} is in an error", filter_name));
+
+      return;
+    }
+  }
+
+  pm->lock();
+
+  node_id = pw_filter_get_node_id(filter);
+
+  pm->sync_wait_unlock();
+}
+
+LatencyMeasurement::~LatencyMeasurement() {
+  abort();
+
+  pm->lock();
+
+  spa_hook_remove(&listener);
+
+  pw_filter_set_active(filter, false);
+
+  pw_filter_disconnect(filter);
+
+  pw_filter_destroy(filter);
+
+  pm->sync_wait_unlock();
+}
+
+auto LatencyMeasurement::start(const std::vector<TapPoint>& tap_points) -> bool {
+  if (is_running || node_id == 0U) {
+    return false;
+  }
+
+  generation++;
+
+  taps = tap_points;
+
+  results.clear();
+  magnitude.clear();
+  phase.clear();
+
+  current_tap = 0U;
+
+  is_running = true;
+
+  ts->set_measurement_mode(true);
+
+  util::debug(std::format("measuring the latency at {} tap points", taps.size()));
+
+  QTimer::singleShot(settle_ms, this, [this, gen = generation]() { measure_tap(gen); });
+
+  return true;
+}
+
+void LatencyMeasurement::abort() {
+  generation++;
+
+  if (!is_running) {
+    return;
+  }
+
+  finish();
+}
+
+auto LatencyMeasurement::running() const -> bool {
+  return is_running;
+}
+
+auto LatencyMeasurement::get_results() const -> const std::vector<Result>& {
+  return results;
+}
+
+auto LatencyMeasurement::get_magnitude() const -> const QList<QPointF>& {
+  return magnitude;
+}
+
+auto LatencyMeasurement::get_phase() const -> const QList<QPointF>& {
+  return phase;
+}
+
+void LatencyMeasurement::measure_tap(const uint& gen) {
+  if (gen != generation) {
+    return;
+  }
+
+  if (current_tap >= taps.size()) {
+    finish();
+
+    return;
+  }
+
+  rate = ts->rate;
+
+  if (rate == 0U) {
+    util::warning("the test signals filter is not being processed. The latency can not be measured.");
+
+    finish();
+
+    return;
+  }
+
+  sweep = TestSignals::log_sweep(rate, sweep_duration, f_start, std::min(f_end, 0.45F * static_cast<float>(rate)));
+
+  // The realtime thread does not touch the capture buffer while it is not armed
+
+  capture.assign(sweep.size() + static_cast<size_t>(max_latency * static_cast<float>(rate)), 0.0F);
+
+  capture_done = false;
+
+  tap_proxies = pm->link_nodes(taps[current_tap].node_id, node_id, false);
+
+  // Giving some time for the links to be ready before the sweep is started
+
+  QTimer::singleShot(settle_ms, this, [this, gen]() {
+    if (gen != generation) {
+      return;
+    }
+
+    armed.store(true, std::memory_order_release);
+
+    ts->start_sweep(sweep);
+
+    const auto wait_ms = static_cast<int>(1000.0F * (sweep_duration + max_latency)) + timeout_ms;
+
+    QTimer::singleShot(wait_ms, this, [this, gen]() { collect_tap(gen); });
+  });
+}
+
+void LatencyMeasurement::collect_tap(const uint& gen) {
+  if (gen != generation) {
+    return;
+  }
+
+  armed = false;
+
+  pm->destroy_links(tap_proxies);
+
+  tap_proxies.clear();
+
+  const auto& tap = taps[current_tap];
+
+  Result result{.name = tap.name, .valid = false, .reported_latency = tap.reported_latency};
+
+  if (!results.empty()) {
+    result.reported_latency += results.back().reported_latency;
+  }
+
+  if (capture_done.load(std::memory_order_acquire)) {
+    if (const auto delay = analyze_capture(current_tap + 1U == taps.size()); delay >= 0.0F) {
+      result.valid = true;
+      result.measured_latency = delay;
+    }
+  }
+
+  if (result.valid) {
+    util::debug(std::format("{}: reported latency {} s, measured latency {} s", tap.name.toStdString(),
+                            result.reported_latency, result.measured_latency));
+  } else {
+    util::warning(std::format("{}: the sweep was not found in the captured signal", tap.name.toStdString()));
+  }
+
+  results.push_back(result);
+
+  current_tap++;
+
+  QTimer::singleShot(settle_ms, this, [this, gen]() { measure_tap(gen); });
+}
+
+void LatencyMeasurement::finish() {
+  armed = false;
+
+  pm->destroy_links(tap_proxies);
+
+  tap_proxies.clear();
+
+  ts->set_measurement_mode(false);
+
+  is_running = false;
+
+  Q_EMIT finished(!taps.empty() && results.size() == taps.size());
+}
+
+auto LatencyMeasurement::analyze_capture(const bool& with_response) -> float {
+  const auto fft_size = std::bit_ceil(capture.size() + sweep.size());
+  const auto n_bins = (fft_size / 2U) + 1U;
+
+  auto* real_buffer = fftwf_alloc_real(fft_size);
+  auto* sweep_spectrum = fftwf_alloc_complex(n_bins);
+  auto* capture_spectrum = fftwf_alloc_complex(n_bins);
+
+  auto free_buffers = [&]() {
+    fftwf_free(real_buffer);
+    fftwf_free(sweep_spectrum);
+    fftwf_free(capture_spectrum);
+  };
+
+  if (real_buffer == nullptr || sweep_spectrum == nullptr || capture_spectrum == nullptr) {
+    util::debug("FFTW buffer allocation failed!");
+
+    free_buffers();
+
+    return -1.0F;
+  }
+
+  fftwf_plan plan_sweep = nullptr;
+  fftwf_plan plan_capture = nullptr;
+  fftwf_plan plan_inverse = nullptr;
+
+  {
+    // Only the planner is not thread safe. The transforms are executed without the lock.
+
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+    const auto n = static_cast<int>(fft_size);
+
+    plan_sweep = fftwf_plan_dft_r2c_1d(n, real_buffer, sweep_spectrum, FFTW_ESTIMATE);
+    plan_capture = fftwf_plan_dft_r2c_1d(n, real_buffer, capture_spectrum, FFTW_ESTIMATE);
+    plan_inverse = fftwf_plan_dft_c2r_1d(n, capture_spectrum, real_buffer, FFTW_ESTIMATE);
+  }
+
+  auto destroy_plans = [&]() {
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+    for (auto* plan : {plan_sweep, plan_capture, plan_inverse}) {
+      if (plan != nullptr) {
+        fftwf_destroy_plan(plan);
+      }
+    }
+  };
+
+  if (plan_sweep == nullptr || plan_capture == nullptr || plan_inverse == nullptr) {
+    util::debug("FFTW plan creation failed!");
+
+    destroy_plans();
+    free_buffers();
+
+    return -1.0F;
+  }
+
+  std::ranges::copy(sweep, real_buffer);
+  std::fill(real_buffer + sweep.size(), real_buffer + fft_size, 0.0F);  // NOLINT
+
+  fftwf_execute(plan_sweep);
+
+  std::ranges::copy(capture, real_buffer);
+  std::fill(real_buffer + capture.size(), real_buffer + fft_size, 0.0F);  // NOLINT
+
+  fftwf_execute(plan_capture);
+
+  /**
+   * Regularized division of the captured spectrum by the sweep spectrum. The
+   * regularization keeps the bins outside of the sweep range from amplifying
+   * noise.
+   */
+
+  auto* x = reinterpret_cast<std::complex<float>*>(sweep_spectrum);    // NOLINT
+  auto* y = reinterpret_cast<std::complex<float>*>(capture_spectrum);  // NOLINT
+
+  const auto x_span = std::span(x, n_bins);
+  const auto y_span = std::span(y, n_bins);
+
+  float max_power = 0.0F;
+
+  for (const auto& v : x_span) {
+    max_power = std::max(max_power, std::norm(v));
+  }
+
+  const auto regularization = 1e-4F * max_power;
+
+  for (size_t k = 0U; k < n_bins; k++) {
+    y_span[k] = y_span[k] * std::conj(x_span[k]) / (std::norm(x_span[k]) + regularization);
+  }
+
+  std::vector<std::complex<float>> transfer;
+
+  if (with_response) {
+    transfer.assign(y_span.begin(), y_span.end());
+  }
+
+  fftwf_execute(plan_inverse);  // it overwrites the spectrum
+
+  // The impulse response is searched only in the range we can measure
+
+  const auto impulse = std::span(real_buffer, capture.size() - sweep.size());
+
+  const auto peak = std::ranges::max_element(impulse, {}, [](const float& v) { return std::fabs(v); });
+
+  const auto peak_value = std::fabs(*peak) / static_cast<float>(fft_size);
+
+  const auto delay_frames = static_cast<size_t>(std::distance(impulse.begin(), peak));
+
+  destroy_plans();
+  free_buffers();
+
+  if (peak_value < util::minimum_linear_level * 100.0F) {
+    return -1.0F;
+  }
+
+  if (with_response) {
+    const auto rate_f = static_cast<float>(rate);
+    const auto f_max = std::min(f_end, 0.45F * rate_f);
+
+    for (uint n = 0U; n < n_response_points; n++) {
+      const auto f =
+          f_start * std::pow(f_max / f_start, static_cast<float>(n) / static_cast<float>(n_response_points - 1U));
+
+      const auto k = std::min(static_cast<size_t>(std::round(f * static_cast<float>(fft_size) / rate_f)), n_bins - 1U);
+
+      // Removing the linear phase of the delay so only the phase distortion is left
+
+      const auto delay_phase = 2.0F * std::numbers::pi_v<float> * static_cast<float>(k * delay_frames % fft_size) /
+                               static_cast<float>(fft_size);
+
+      const auto h = transfer[k] * std::polar(1.0F, delay_phase);
+
+      magnitude.append(QPointF(f, util::linear_to_db(std::abs(h))));
+      phase.append(QPointF(f, std::arg(h) * 180.0F / std::numbers::pi_v<float>));
+    }
+  }
+
+  return static_cast<float>(delay_frames) / static_cast<float>(rate);
+}
@@ -0,0 +1,166 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <pipewire/filter.h>
+#include <pipewire/proxy.h>
+#include <qlist.h>
+#include <qobject.h>
+#include <qpoint.h>
+#include <qtmetamacros.h>
+#include <spa/utils/hook.h>
+#include <sys/types.h>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "pw_manager.hpp"
+#include "test_signals.hpp"
+
+/**
+ * Measures the real latency and the frequency response of the output
+ * pipeline. A logarithmic sine sweep is played through it by TestSignals and
+ * captured at the output of each plugin and at the end of the chain, one tap
+ * point at a time. Dividing the spectrum of the capture by the spectrum of the
+ * sweep gives the impulse response of everything between our sink and the tap
+ * point. The position of its peak is the delay the signal really had.
+ */
+class LatencyMeasurement : public QObject {
+  Q_OBJECT
+
+ public:
+  LatencyMeasurement(pw::Manager* pipe_manager, TestSignals* test_signals);
+  LatencyMeasurement(const LatencyMeasurement&) = delete;
+  auto operator=(const LatencyMeasurement&) -> LatencyMeasurement& = delete;
+  LatencyMeasurement(const LatencyMeasurement&&) = delete;
+  auto operator=(const LatencyMeasurement&&) -> LatencyMeasurement& = delete;
+  ~LatencyMeasurement() override;
+
+  struct TapPoint {
+    QString name;
+
+    uint node_id = 0U;
+
+    // Latency reported by the node itself, in seconds
+    float reported_latency = 0.0F;
+  };
+
+  struct Result {
+    QString name;
+
+    bool valid = false;
+
+    // Sum of the latencies reported up to this tap point, in seconds
+    float reported_latency = 0.0F;
+
+    float measured_latency = 0.0F;
+  };
+
+  struct data;
+
+  struct port {
+    struct data* data;
+  };
+
+  struct data {
+    struct port* in_left = nullptr;
+    struct port* in_right = nullptr;
+
+    LatencyMeasurement* lm = nullptr;
+  };
+
+  pw_filter_state state = PW_FILTER_STATE_UNCONNECTED;
+
+  bool can_get_node_id = false;
+
+  TestSignals* ts = nullptr;
+
+  std::atomic<bool> armed = false;
+  std::atomic<bool> capture_done = false;
+
+  // Mono sum of the captured channels. Written only by the realtime thread while armed.
+  std::vector<float> capture;
+
+  // Measures the tap points in the given order. Returns false if a measurement is already running.
+  auto start(const std::vector<TapPoint>& tap_points) -> bool;
+
+  void abort();
+
+  [[nodiscard]] auto running() const -> bool;
+
+  [[nodiscard]] auto get_results() const -> const std::vector<Result>&;
+
+  // Response between our sink and the last tap point. Frequency in Hz and magnitude in dB.
+  [[nodiscard]] auto get_magnitude() const -> const QList<QPointF>&;
+
+  // Frequency in Hz and phase in degrees, without the linear phase of the measured delay.
+  [[nodiscard]] auto get_phase() const -> const QList<QPointF>&;
+
+ Q_SIGNALS:
+  // completed is false if the measurement was aborted or could not be started
+  void finished(bool completed);
+
+ private:
+  pw::Manager* pm = nullptr;
+
+  pw_filter* filter = nullptr;
+
+  spa_hook listener{};
+
+  data pf_data = {};
+
+  uint node_id = 0U;
+
+  uint rate = 0U;
+
+  bool is_running = false;
+
+  // Incremented on each start and abort so pending timers of an old measurement do nothing
+  uint generation = 0U;
+
+  size_t current_tap = 0U;
+
+  std::vector<TapPoint> taps;
+
+  std::vector<Result> results;
+
+  std::vector<pw_proxy*> tap_proxies;
+
+  std::vector<float> sweep;
+
+  QList<QPointF> magnitude, phase;
+
+  static constexpr float sweep_duration = 1.0F;  // seconds
+  static constexpr float max_latency = 1.0F;     // seconds
+  static constexpr float f_start = 20.0F;        // Hz
+  static constexpr float f_end = 20000.0F;       // Hz
+  static constexpr int settle_ms = 200;
+  static constexpr int timeout_ms = 1000;
+  static constexpr uint n_response_points = 256U;
+
+  void measure_tap(const uint& gen);
+
+  void collect_tap(const uint& gen);
+
+  void finish();
+
+  // Returns the measured delay in seconds or a negative value if the sweep was not found in the capture
+  auto analyze_capture(const bool& with_response) -> float;
+};
@@ -18,22 +18,23 @@
  */
 
 #include "level_meter.hpp"
-#include <ebur128.h>
 #include <qnamespace.h>
 #include <qobject.h>
+#include <QString>
 #include <algorithm>
-#include <cstddef>
 #include <format>
 #include <mutex>
 #include <span>
 #include <string>
 #include "db_manager.hpp"
 #include "easyeffects_db_level_meter.h"
+#include "loudness_analyzer.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 LevelMeter::LevelMeter(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -45,9 +46,11 @@ LevelMeter::LevelMeter(const std::string& tag, pw::Manager* pipe_manager, Pipeli
       settings(db::Manager::self().get_plugin_db<DbLevelMeter>(
           pipe_type,
           tags::plugin_name::BaseName::levelMeter + "#" + instance_id)) {
+  settings_objects.push_back(settings);
+
   bypass = settings->bypass();
 
-  connect(settings, &DbLevelMeter::bypassChanged, [&]() { bypass = settings->bypass(); });
+  connect(settings, &DbLevelMeter::bypassChanged, this, [&]() { bypass = settings->bypass(); });
 }
 
 LevelMeter::~LevelMeter() {
@@ -59,11 +62,7 @@ LevelMeter::~LevelMeter() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
-
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
-  }
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -76,26 +75,6 @@ void LevelMeter::clear_data() {
   setup();
 }
 
-auto LevelMeter::init_ebur128() -> bool {
-  if (n_samples == 0U || rate == 0U) {
-    return false;
-  }
-
-  if (ebur_state != nullptr) {
-    ebur128_destroy(&ebur_state);
-
-    ebur_state = nullptr;
-  }
-
-  ebur_state = ebur128_init(
-      2U, rate, EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_TRUE_PEAK | EBUR128_MODE_HISTOGRAM);
-
-  ebur128_set_channel(ebur_state, 0U, EBUR128_LEFT);
-  ebur128_set_channel(ebur_state, 1U, EBUR128_RIGHT);
-
-  return ebur_state != nullptr;
-}
-
 void LevelMeter::setup() {
   if (rate == 0 || n_samples == 0) {
     // Some signals may be emitted before PipeWire calls our setup function
@@ -106,26 +85,24 @@ void LevelMeter::setup() {
 
   ebur128_ready = false;
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
-      [this] {
+      [this, tap = analysis_tap] {
         if (ebur128_ready) {
           return;
         }
 
-        if (2U * static_cast<size_t>(n_samples) != data.size()) {
-          data.resize(static_cast<size_t>(n_samples) * 2U);
-        }
-
-        auto status = init_ebur128();
+        auto status = analyzer.attach(pipeline_type, tap, rate, 0U);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ebur128_ready = status;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
+}
+
+void LevelMeter::quantum_changed() {
+  // The loudness analyzer only depends on the sampling rate
 }
 
 void LevelMeter::process(std::span<float>& left_in,
@@ -141,51 +118,16 @@ void LevelMeter::process(std::span<float>& left_in,
     return;
   }
 
-  {
-    const float* __restrict__ l = left_in.data();
-    const float* __restrict__ r = right_in.data();
-    float* __restrict__ d = data.data();
-
-    for (size_t i = 0; i < n_samples; ++i) {
-      const size_t idx = i * 2;
-
-      d[idx] = l[i];
-      d[idx + 1] = r[i];
-    }
-  }
-
-  ebur128_add_frames_float(ebur_state, data.data(), n_samples);
-
-  if (EBUR128_SUCCESS != ebur128_loudness_momentary(ebur_state, &momentary)) {
-    momentary = 0.0;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_loudness_shortterm(ebur_state, &shortterm)) {
-    shortterm = 0.0;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_loudness_global(ebur_state, &global)) {
-    global = 0.0;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_relative_threshold(ebur_state, &relative)) {
-    relative = 0.0;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_loudness_range(ebur_state, &range)) {
-    range = 0.0;
-  }
-
-  if (EBUR128_SUCCESS != ebur128_true_peak(ebur_state, 0U, &true_peak_L)) {
-    true_peak_L = 0.0;
-  }
+  const auto& measurements = analyzer.process(left_in.first(n_samples), right_in.first(n_samples), clock_position);
 
-  if (EBUR128_SUCCESS != ebur128_true_peak(ebur_state, 1U, &true_peak_R)) {
-    true_peak_R = 0.0;
-  }
+  momentary = measurements.momentary;
+  shortterm = measurements.shortterm;
+  global = measurements.global;
+  relative = measurements.relative;
+  range = measurements.range;
 
-  true_peak_L = util::linear_to_db(true_peak_L);
-  true_peak_R = util::linear_to_db(true_peak_R);
+  true_peak_L = util::linear_to_db(measurements.true_peak[0]);
+  true_peak_R = util::linear_to_db(measurements.true_peak[1]);
 
   if (updateLevelMeters) {
     get_peaks(left_in, right_in, left_out, right_out);
@@ -203,10 +145,30 @@ auto LevelMeter::get_latency_seconds() -> float {
   return 0.0F;
 }
 
-void LevelMeter::resetHistory() {
+void LevelMeter::set_analysis_tap(const QString& tap) {
+  if (tap == analysis_tap) {
+    return;
+  }
+
+  data_mutex.lock();
+
+  analysis_tap = tap;
+
+  ebur128_ready = false;
+
+  data_mutex.unlock();
+
   setup();
 }
 
+void LevelMeter::resetHistory() {
+  WorkerPool::post(baseWorker, [this] {
+    std::scoped_lock<std::mutex> lock(data_mutex);
+
+    analyzer.reset_history();
+  });
+}
+
 float LevelMeter::getMomentaryLevel() const {
   return momentary;
 }
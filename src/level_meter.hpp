@@ -26,8 +26,8 @@
 #include <sys/types.h>
 #include <span>
 #include <string>
-#include <vector>
 #include "easyeffects_db_level_meter.h"
+#include "loudness_analyzer.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
@@ -51,6 +51,8 @@ class LevelMeter : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
@@ -65,6 +67,8 @@ class LevelMeter : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  void set_analysis_tap(const QString& tap) override;
+
   Q_INVOKABLE [[nodiscard]] float getMomentaryLevel() const;
 
   Q_INVOKABLE [[nodiscard]] float getShorttermLevel() const;
@@ -95,9 +99,6 @@ class LevelMeter : public PluginBase {
   double true_peak_L = 0.0;
   double true_peak_R = 0.0;
 
-  std::vector<float> data;
-
-  ebur128_state* ebur_state = nullptr;
-
-  auto init_ebur128() -> bool;
+  LoudnessAnalyzer analyzer{EBUR128_MODE_S | EBUR128_MODE_I | EBUR128_MODE_LRA | EBUR128_MODE_TRUE_PEAK |
+                            EBUR128_MODE_HISTOGRAM};
 };
@@ -36,8 +36,10 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Limiter::Limiter(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -63,8 +65,8 @@ Limiter::Limiter(const std::string& tag, pw::Manager* pipe_manager, PipelineType
 
   // specific plugin controls
 
-  connect(settings, &DbLimiter::sidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbLimiter::sidechainInputDeviceChanged, [&]() { update_sidechain_links(); });
+  connect(settings, &DbLimiter::sidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbLimiter::sidechainInputDeviceChanged, this, [&]() { update_sidechain_links(); });
 
   BIND_LV2_PORT("mode", mode, setMode, DbLimiter::modeChanged);
   BIND_LV2_PORT("ovs", oversampling, setOversampling, DbLimiter::oversamplingChanged);
@@ -90,6 +92,14 @@ Limiter::Limiter(const std::string& tag, pw::Manager* pipe_manager, PipelineType
   BIND_LV2_PORT_DB("sc2lk", sidechainToLink, setSidechainToLink, DbLimiter::sidechainToLinkChanged, true);
   BIND_LV2_PORT_DB("lk2sc", linkToSidechain, setLinkToSidechain, DbLimiter::linkToSidechainChanged, true);
   BIND_LV2_PORT_DB("lk2in", linkToInput, setLinkToInput, DbLimiter::linkToInputChanged, true);
+
+  const auto update_tail = [this] {
+    tail_seconds = filter_tail_seconds + static_cast<float>(settings->release() * 0.001);
+  };
+
+  update_tail();
+
+  connect(settings, &DbLimiter::releaseChanged, this, update_tail);
 }
 
 Limiter::~Limiter() {
@@ -99,7 +109,7 @@ Limiter::~Limiter() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -140,20 +150,18 @@ void Limiter::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Limiter::process([[maybe_unused]] std::span<float>& left_in,
@@ -180,23 +188,17 @@ void Limiter::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out, probe_left, probe_right);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   // This plugin gives the latency in number of samples
 
@@ -207,7 +209,7 @@ void Limiter::process(std::span<float>& left_in,
 
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
   }
@@ -22,8 +22,13 @@
 #include <qobject.h>
 #include <qstandardpaths.h>
 #include <qtmetamacros.h>
+#include <QByteArray>
+#include <QCoreApplication>
 #include <QLocalServer>
 #include <QMetaType>
+#include <QProcess>
+#include <QStringList>
+#include <algorithm>
 #include <cstring>
 #include <filesystem>
 #include <format>
@@ -204,6 +209,46 @@ void LocalServer::onReadyRead() {
     } else if (std::strncmp(buf, tags::local_server::toggle_global_bypass,
                             strlen(tags::local_server::toggle_global_bypass)) == 0) {
       DbMain::setBypass(!DbMain::bypass());
+    } else if (std::strncmp(buf, tags::local_server::render, strlen(tags::local_server::render)) == 0) {
+      /**
+       * The files are rendered by a separate headless process. It does not
+       * touch our settings or the PipeWire graph and the audio processing
+       * running here is not disturbed.
+       *
+       * Format: render:preset<TAB>input<TAB>output[<TAB>input<TAB>output...]
+       * Tabs are used because paths can have colons. The reply is 1 when the
+       * process was started and 0 otherwise.
+       */
+
+      auto line = QByteArray(buf, lineLength);
+
+      // Long paths do not fit in the buffer
+      if (!line.endsWith('\n')) {
+        line += socket->readLine();
+      }
+
+      const auto prefix = QByteArray(tags::local_server::render) + ":";
+
+      QStringList fields;
+
+      if (line.startsWith(prefix) && line.endsWith('\n')) {
+        fields = QString::fromUtf8(line.sliced(prefix.size(), line.size() - prefix.size() - 1)).split('\t');
+      }
+
+      const bool valid = fields.size() >= 3 && fields.size() % 2 == 1 &&
+                         std::ranges::none_of(fields, [](const QString& f) { return f.isEmpty(); });
+
+      if (!valid) {
+        util::warning("LocalServer: the render command has to be render:preset<TAB>input<TAB>output...");
+
+        socket->write("0\n");
+      } else {
+        const QStringList args = QStringList{"--render", fields.first(), "--"} + fields.mid(1);
+
+        const auto started = QProcess::startDetached(QCoreApplication::applicationFilePath(), args);
+
+        socket->write(started ? "1\n" : "0\n");
+      }
     }
   }
 
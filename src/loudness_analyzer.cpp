@@ -0,0 +1,278 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "loudness_analyzer.hpp"
+#include <ebur128.h>
+#include <sys/types.h>
+#include <QString>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "dsp_kernels.hpp"
+#include "pipeline_type.hpp"
+#include "plugin_base.hpp"
+
+namespace {
+
+auto has_mode(const int& mode, const int& flag) -> bool {
+  return (mode & flag) == flag;
+}
+
+}  // namespace
+
+struct LoudnessAnalyzer::Shared {
+  Shared(const int& mode, const uint& rate, const ulong& max_history)
+      : mode(mode), rate(rate), max_history(max_history) {
+    // The realtime thread only interleaves in it
+    data.reserve(2U * PluginBase::max_quantum);
+
+    init();
+  }
+
+  Shared(const Shared&) = delete;
+  auto operator=(const Shared&) -> Shared& = delete;
+  Shared(const Shared&&) = delete;
+  auto operator=(const Shared&&) -> Shared& = delete;
+
+  ~Shared() {
+    if (state != nullptr) {
+      ebur128_destroy(&state);
+    }
+  }
+
+  const int mode;
+  const uint rate;
+  const ulong max_history;
+
+  std::mutex mutex;
+
+  ebur128_state* state = nullptr;
+
+  std::vector<float> data;
+
+  uint64_t position = std::numeric_limits<uint64_t>::max();
+
+  size_t n_frames = 0U;
+
+  Measurements measurements;
+
+  void init() {
+    if (state != nullptr) {
+      ebur128_destroy(&state);
+    }
+
+    state = ebur128_init(2U, rate, static_cast<uint>(mode));
+
+    if (state == nullptr) {
+      return;
+    }
+
+    ebur128_set_channel(state, 0U, EBUR128_LEFT);
+    ebur128_set_channel(state, 1U, EBUR128_RIGHT);
+
+    if (max_history != 0U) {
+      ebur128_set_max_history(state, max_history);
+    }
+
+    position = std::numeric_limits<uint64_t>::max();
+
+    measurements = Measurements();
+  }
+
+  void feed(std::span<const float> left, std::span<const float> right) {
+    if (state == nullptr) {
+      return;
+    }
+
+    if (data.size() != 2U * left.size()) {
+      data.resize(2U * left.size());
+    }
+
+    dsp::interleave(left, right, data);
+
+    ebur128_add_frames_float(state, data.data(), left.size());
+
+    auto& m = measurements;
+
+    m.loudness_failed = false;
+    m.peak_failed = false;
+
+    if (EBUR128_SUCCESS != ebur128_loudness_momentary(state, &m.momentary)) {
+      m.momentary = 0.0;
+      m.loudness_failed = true;
+    }
+
+    if (has_mode(mode, EBUR128_MODE_S) && EBUR128_SUCCESS != ebur128_loudness_shortterm(state, &m.shortterm)) {
+      m.shortterm = 0.0;
+      m.loudness_failed = true;
+    }
+
+    if (has_mode(mode, EBUR128_MODE_I)) {
+      if (EBUR128_SUCCESS != ebur128_loudness_global(state, &m.global)) {
+        m.global = 0.0;
+        m.loudness_failed = true;
+      }
+
+      if (EBUR128_SUCCESS != ebur128_relative_threshold(state, &m.relative)) {
+        m.relative = 0.0;
+        m.loudness_failed = true;
+      }
+    }
+
+    if (has_mode(mode, EBUR128_MODE_LRA) && EBUR128_SUCCESS != ebur128_loudness_range(state, &m.range)) {
+      m.range = 0.0;
+      m.loudness_failed = true;
+    }
+
+    for (uint n = 0U; n < 2U; n++) {
+      if (has_mode(mode, EBUR128_MODE_SAMPLE_PEAK) &&
+          EBUR128_SUCCESS != ebur128_prev_sample_peak(state, n, &m.sample_peak.at(n))) {
+        m.sample_peak.at(n) = 0.0;
+        m.peak_failed = true;
+      }
+
+      if (has_mode(mode, EBUR128_MODE_TRUE_PEAK) &&
+          EBUR128_SUCCESS != ebur128_true_peak(state, n, &m.true_peak.at(n))) {
+        m.true_peak.at(n) = 0.0;
+        m.peak_failed = true;
+      }
+    }
+  }
+};
+
+struct LoudnessAnalyzer::Registry {
+  std::mutex mutex;
+
+  std::map<Key, std::weak_ptr<Shared>> entries;
+};
+
+auto LoudnessAnalyzer::registry() -> Registry& {
+  static Registry r;
+
+  return r;
+}
+
+LoudnessAnalyzer::LoudnessAnalyzer(const int& mode) : mode(mode) {}
+
+LoudnessAnalyzer::~LoudnessAnalyzer() = default;
+
+auto LoudnessAnalyzer::attach(const PipelineType& pipeline_type,
+                              const QString& tap,
+                              const uint& rate,
+                              const ulong& max_history) -> bool {
+  // Without a tap nothing is known about the signal and the measurement is not shared.
+
+  has_tap = !tap.isEmpty();
+
+  if (!has_tap) {
+    shared = std::make_shared<Shared>(mode, rate, max_history);
+
+    return shared->state != nullptr;
+  }
+
+  key = Key{pipeline_type, tap.toStdString(), rate, mode, max_history};
+
+  auto& r = registry();
+
+  std::scoped_lock<std::mutex> lock(r.mutex);
+
+  std::erase_if(r.entries, [](const auto& entry) { return entry.second.expired(); });
+
+  std::shared_ptr<Shared> s;
+
+  if (auto it = r.entries.find(key); it != r.entries.end()) {
+    s = it->second.lock();
+  }
+
+  if (s != nullptr) {
+    std::scoped_lock<std::mutex> shared_lock(s->mutex);
+
+    // It was already fed. Its history started before this analyzer existed.
+
+    if (s->position != std::numeric_limits<uint64_t>::max()) {
+      s.reset();
+    }
+  }
+
+  if (s == nullptr) {
+    s = std::make_shared<Shared>(mode, rate, max_history);
+
+    if (s->state == nullptr) {
+      shared.reset();
+
+      return false;
+    }
+
+    // The measurements already running keep their analyzers. New ones join this one.
+
+    r.entries[key] = s;
+  }
+
+  shared = s;
+
+  return true;
+}
+
+void LoudnessAnalyzer::reset_history() {
+  if (shared == nullptr) {
+    return;
+  }
+
+  auto s = std::make_shared<Shared>(mode, shared->rate, shared->max_history);
+
+  if (s->state == nullptr) {
+    return;
+  }
+
+  if (has_tap) {
+    auto& r = registry();
+
+    std::scoped_lock<std::mutex> lock(r.mutex);
+
+    r.entries[key] = s;
+  }
+
+  shared = s;
+}
+
+auto LoudnessAnalyzer::process(std::span<const float> left, std::span<const float> right, const uint64_t& position)
+    -> const Measurements& {
+  if (shared == nullptr) {
+    return measurements;
+  }
+
+  std::scoped_lock<std::mutex> lock(shared->mutex);
+
+  if (position != shared->position || left.size() != shared->n_frames) {
+    shared->position = position;
+    shared->n_frames = left.size();
+
+    shared->feed(left, right);
+  }
+
+  measurements = shared->measurements;
+
+  return measurements;
+}
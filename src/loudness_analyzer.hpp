@@ -0,0 +1,102 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <ebur128.h>
+#include <sys/types.h>
+#include <QString>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <tuple>
+#include "pipeline_type.hpp"
+
+/**
+ * EBU R128 measurements shared between the plugins of a pipeline. A tap is the
+ * signal between two nodes of one filter chain. The analyzers that ask for the
+ * same measurement, same libebur128 mode and history, on the same tap use one
+ * libebur128 state. The first of them to run in a graph cycle feeds it and the
+ * others only read the results. An analyzer only joins a measurement that has
+ * not started yet, so it never reports history it did not see.
+ */
+class LoudnessAnalyzer {
+ public:
+  struct Measurements {
+    double momentary = 0.0;
+    double shortterm = 0.0;
+    double global = 0.0;
+    double relative = 0.0;
+    double range = 0.0;
+
+    std::array<double, 2U> sample_peak{};  // of the last quantum
+    std::array<double, 2U> true_peak{};    // since the last reset
+
+    bool loudness_failed = false;
+    bool peak_failed = false;
+  };
+
+  explicit LoudnessAnalyzer(const int& mode);
+  LoudnessAnalyzer(const LoudnessAnalyzer&) = delete;
+  auto operator=(const LoudnessAnalyzer&) -> LoudnessAnalyzer& = delete;
+  LoudnessAnalyzer(const LoudnessAnalyzer&&) = delete;
+  auto operator=(const LoudnessAnalyzer&&) -> LoudnessAnalyzer& = delete;
+  ~LoudnessAnalyzer();
+
+  /**
+   * Not realtime safe. The history is in milliseconds and zero keeps the
+   * libebur128 default. Returns false if libebur128 could not be initialized.
+   */
+  auto attach(const PipelineType& pipeline_type, const QString& tap, const uint& rate, const ulong& max_history)
+      -> bool;
+
+  /**
+   * Not realtime safe and it must not run concurrently with process(). This
+   * analyzer starts a new measurement. The others keep their history.
+   */
+  void reset_history();
+
+  /**
+   * Realtime safe. The position is the one of the graph clock. It tells if
+   * this quantum was already given by another analyzer on the same tap.
+   */
+  auto process(std::span<const float> left, std::span<const float> right, const uint64_t& position)
+      -> const Measurements&;
+
+ private:
+  struct Shared;
+
+  using Key = std::tuple<PipelineType, std::string, uint, int, ulong>;
+
+  struct Registry;
+
+  static auto registry() -> Registry&;
+
+  int mode;
+
+  Key key;
+
+  bool has_tap = false;
+
+  std::shared_ptr<Shared> shared;
+
+  Measurements measurements;
+};
@@ -24,7 +24,7 @@
   {                                                                                                              \
     lv2_wrapper->set_control_port_value(key, static_cast<float>(settings->getter()));                            \
     lv2_wrapper->sync_funcs.emplace_back([&]() { settings->setter(lv2_wrapper->get_control_port_value(key)); }); \
-    connect(settings, &onChangedSignal, [this]() {                                                               \
+    connect(settings, &onChangedSignal, this, [this]() {                                                         \
       if (this == nullptr || settings == nullptr || lv2_wrapper == nullptr) {                                    \
         return;                                                                                                  \
       }                                                                                                          \
@@ -45,7 +45,7 @@
           ((enforceLowerBound) & (linear_v == 0.0F)) ? util::minimum_db_d_level : util::linear_to_db(linear_v); \
       settings->setter(db_v);                                                                                   \
     });                                                                                                         \
-    connect(settings, &onChangedSignal, [this]() {                                                              \
+    connect(settings, &onChangedSignal, this, [this]() {                                                        \
       if (this == nullptr || settings == nullptr || lv2_wrapper == nullptr) {                                   \
         return;                                                                                                 \
       }                                                                                                         \
@@ -62,7 +62,7 @@
     lv2_wrapper->set_control_port_value(key, static_cast<float>(!settings->getter()));              \
     lv2_wrapper->sync_funcs.emplace_back(                                                           \
         [&]() { settings->setter(!static_cast<bool>(lv2_wrapper->get_control_port_value(key))); }); \
-    connect(settings, &onChangedSignal, [this]() {                                                  \
+    connect(settings, &onChangedSignal, this, [this]() {                                            \
       if (this == nullptr || settings == nullptr || lv2_wrapper == nullptr) {                       \
         return;                                                                                     \
       }                                                                                             \
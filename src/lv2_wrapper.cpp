@@ -31,14 +31,18 @@
 #include <lv2/ui/ui.h>
 #include <lv2/urid/urid.h>
 #include <sys/types.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <climits>
 #include <cmath>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#include <execution>
 #include <format>
 #include <functional>
+#include <mutex>
 #include <span>
 #include <string>
 #include <unordered_map>
@@ -48,8 +52,42 @@
 
 namespace lv2 {
 
+namespace {
+
+std::mutex preloaded_mutex;
+
+std::vector<LilvWorld*> preloaded_worlds;
+
+auto load_world() -> LilvWorld* {
+  auto* world = lilv_world_new();
+
+  if (world != nullptr) {
+    lilv_world_load_all(world);
+  }
+
+  return world;
+}
+
+auto take_world() -> LilvWorld* {
+  {
+    std::scoped_lock<std::mutex> lock(preloaded_mutex);
+
+    if (!preloaded_worlds.empty()) {
+      auto* world = preloaded_worlds.back();
+
+      preloaded_worlds.pop_back();
+
+      return world;
+    }
+  }
+
+  return load_world();
+}
+
+}  // namespace
+
 Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri)
-    : plugin_uri(plugin_uri), world(lilv_world_new()), native_ui(this) {
+    : plugin_uri(plugin_uri), world(take_world()), native_ui(this) {
   if (world == nullptr) {
     util::warning("Failed to initialized the world");
 
@@ -64,8 +102,6 @@ Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri)
     return;
   }
 
-  lilv_world_load_all(world);
-
   const LilvPlugins* plugins = lilv_world_get_all_plugins(world);
 
   plugin = lilv_plugins_get_by_uri(plugins, uri);
@@ -85,6 +121,35 @@ Lv2Wrapper::Lv2Wrapper(const std::string& plugin_uri)
   create_ports();
 }
 
+void Lv2Wrapper::preload_worlds(const size_t& n) {
+  std::vector<LilvWorld*> worlds(n, nullptr);
+
+#if defined(ENABLE_LIBCPP_WORKAROUNDS) || defined(_LIBCPP_HAS_NO_INCOMPLETE_PSTL) || \
+    (defined(_LIBCPP_VERSION) && _LIBCPP_VERSION < 170000)
+  std::ranges::for_each(worlds, [](auto& world) { world = load_world(); });
+#else
+  std::for_each(std::execution::par, worlds.begin(), worlds.end(), [](auto& world) { world = load_world(); });
+#endif
+
+  std::scoped_lock<std::mutex> lock(preloaded_mutex);
+
+  for (auto* world : worlds) {
+    if (world != nullptr) {
+      preloaded_worlds.push_back(world);
+    }
+  }
+}
+
+void Lv2Wrapper::release_preloaded_worlds() {
+  std::scoped_lock<std::mutex> lock(preloaded_mutex);
+
+  for (auto* world : preloaded_worlds) {
+    lilv_world_free(world);
+  }
+
+  preloaded_worlds.clear();
+}
+
 Lv2Wrapper::~Lv2Wrapper() {
   if (instance != nullptr) {
     lilv_instance_deactivate(instance);
@@ -244,8 +309,43 @@ auto Lv2Wrapper::create_instance(const uint& rate) -> bool {
 
   destroy_instance();
 
+  pending_rate = rate;
+
+  instance = instantiate();
+
   this->rate = rate;
 
+  return instance != nullptr;
+}
+
+auto Lv2Wrapper::replace_instance(const uint& rate, std::mutex& run_mutex) -> bool {
+  if (instance != nullptr && this->rate == rate) {
+    return true;
+  }
+
+  pending_rate = rate;
+
+  auto* new_instance = instantiate();
+
+  LilvInstance* old_instance = nullptr;
+
+  {
+    std::scoped_lock<std::mutex> lock(run_mutex);
+
+    old_instance = std::exchange(instance, new_instance);
+
+    this->rate = rate;
+  }
+
+  if (old_instance != nullptr) {
+    lilv_instance_deactivate(old_instance);
+    lilv_instance_free(old_instance);
+  }
+
+  return new_instance != nullptr;
+}
+
+auto Lv2Wrapper::instantiate() -> LilvInstance* {
   LV2_Log_Log lv2_log = {.handle = this,
                          .printf = &lv2_printf,
                          .vprintf = []([[maybe_unused]] LV2_Log_Handle handle, [[maybe_unused]] LV2_URID type,
@@ -275,7 +375,7 @@ auto Lv2Wrapper::create_instance(const uint& rate) -> bool {
         .key = map_urid(LV2_PARAMETERS__sampleRate),
         .size = sizeof(float),
         .type = map_urid(LV2_ATOM__Float),
-        .value = &rate},
+        .value = &pending_rate},
        {.context = LV2_OPTIONS_INSTANCE,
         .subject = 0,
         .key = map_urid(LV2_BUF_SIZE__minBlockLength),
@@ -301,19 +401,19 @@ auto Lv2Wrapper::create_instance(const uint& rate) -> bool {
   const auto features = std::to_array<const LV2_Feature*>(
       {&lv2_log_feature, &lv2_map_feature, &lv2_unmap_feature, &feature_options, static_features.data(), nullptr});
 
-  instance = lilv_plugin_instantiate(plugin, rate, features.data());
+  auto* new_instance = lilv_plugin_instantiate(plugin, pending_rate, features.data());
 
-  if (instance == nullptr) {
+  if (new_instance == nullptr) {
     util::warning(std::format("Failed to instantiate {}", plugin_uri));
 
-    return false;
+    return nullptr;
   }
 
-  connect_control_ports();
+  connect_control_ports(new_instance);
 
-  activate();
+  lilv_instance_activate(new_instance);
 
-  return true;
+  return new_instance;
 }
 
 void Lv2Wrapper::destroy_instance() {
@@ -330,10 +430,10 @@ auto Lv2Wrapper::get_instance() -> LilvInstance* {
   return instance;
 }
 
-void Lv2Wrapper::connect_control_ports() {
+void Lv2Wrapper::connect_control_ports(LilvInstance* target) {
   for (auto& p : ports) {
     if (p.type == PortType::TYPE_CONTROL) {
-      lilv_instance_connect_port(instance, p.index, &p.value);
+      lilv_instance_connect_port(target, p.index, &p.value);
     }
   }
 }
@@ -27,6 +27,7 @@
 #include <lv2/urid/urid.h>
 #include <sys/types.h>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <functional>
 #include <limits>
@@ -90,8 +91,26 @@ class Lv2Wrapper {
 
   std::vector<std::function<void()>> sync_funcs;
 
+  /**
+   * Loads n lilv worlds in parallel. They do not depend on the plugin, so the
+   * wrappers created afterwards take them instead of loading their own.
+   */
+  static void preload_worlds(const size_t& n);
+
+  // Frees the preloaded worlds that were not taken.
+  static void release_preloaded_worlds();
+
   auto create_instance(const uint& rate) -> bool;
 
+  /**
+   * Same as create_instance but the current instance keeps running while the
+   * new one is created. They are swapped while run_mutex is locked, so it has
+   * to be the mutex held around run(). Until the swap get_rate returns the
+   * rate of the running instance, so the plugins can call this from their
+   * setup without stopping the audio.
+   */
+  auto replace_instance(const uint& rate, std::mutex& run_mutex) -> bool;
+
   void destroy_instance();
 
   void set_n_samples(const uint& value);
@@ -168,7 +187,10 @@ class Lv2Wrapper {
 
   uint n_samples = 0U;
 
-  uint rate = 0U;
+  // Rate of the running instance. It changes only when the instance for pending_rate replaces it.
+  std::atomic<uint> rate = 0U;
+
+  uint pending_rate = 0U;
 
   // Multiband compressor/gate use 1+8*7=57 control ports. Round up to 64.
   std::array<std::pair<size_t, uint>, 64> control_ports_cache;
@@ -193,7 +215,9 @@ class Lv2Wrapper {
 
   void create_ports();
 
-  void connect_control_ports();
+  auto instantiate() -> LilvInstance*;
+
+  void connect_control_ports(LilvInstance* target);
 };
 
 }  // namespace lv2
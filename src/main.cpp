@@ -35,6 +35,7 @@
 #include <KIconTheme>
 #include <KLocalizedString>
 #include <QApplication>
+#include <QCoreApplication>
 #include <QDir>
 #include <QLocalServer>
 #include <QLoggingCategory>
@@ -43,6 +44,7 @@
 #include <QSystemTrayIcon>
 #include <QTimer>
 #include <csignal>
+#include <cstdlib>
 #include <format>
 #include <memory>
 #include <stdexcept>
@@ -51,19 +53,23 @@
 #include "command_line_parser.hpp"
 #include "config.h"
 #include "db_manager.hpp"
+#include "effects_base.hpp"
 #include "global_shortcuts.hpp"
 #include "iostream"
 #include "kcolor_manager.hpp"
 #include "local_client.hpp"
 #include "local_server.hpp"
+#include "offline_renderer.hpp"
 #include "pipeline_type.hpp"
 #include "presets_manager.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "stream_input_effects.hpp"
 #include "stream_output_effects.hpp"
 #include "tags_plugin_name.hpp"
 #include "test_signals.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 #ifdef __GLIBC__
 #include <malloc.h>
@@ -94,13 +100,18 @@ struct CoreServices {
   std::unique_ptr<StreamOutputEffects> soe;
   std::unique_ptr<GlobalShortcuts> global_shortcuts;
 
-  CoreServices(bool is_primary) {
+  CoreServices(bool is_primary, bool headless = false) {
     util::debug(std::format("easyffects version: {}.{}.{}", VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH));
 
     if (is_primary) {
       extra_lv2_paths();
 
       dbm = &db::Manager::self();
+
+      // The realtime log has to exist before the PipeWire threads can use it
+
+      util::RtLog::self();
+
       pwm = &pw::Manager::self();
 
       sie = std::make_unique<StreamInputEffects>(pwm);
@@ -110,9 +121,31 @@ struct CoreServices {
       tags::plugin_name::Model::self();
       presets::Manager::self();
 
-      global_shortcuts = std::make_unique<GlobalShortcuts>(nullptr);
+      // The pipelines crossfade to the settings of a new preset instead of jumping to them
+
+      for (EffectsBase* effects : {static_cast<EffectsBase*>(sie.get()), static_cast<EffectsBase*>(soe.get())}) {
+        QObject::connect(&presets::Manager::self(), &presets::Manager::presetAboutToLoad, effects,
+                         [effects](PipelineType pipeline_type) {
+                           if (pipeline_type == effects->pipeline_type) {
+                             effects->begin_preset_load();
+                           }
+                         });
+
+        QObject::connect(&presets::Manager::self(), &presets::Manager::presetLoadFinished, effects,
+                         [effects](PipelineType pipeline_type) {
+                           if (pipeline_type == effects->pipeline_type) {
+                             effects->end_preset_load();
+                           }
+                         });
+      }
+
+      // Global shortcuts are bound through the desktop portal and only make sense with our window.
 
-      initGlobalShortcuts();
+      if (!headless) {
+        global_shortcuts = std::make_unique<GlobalShortcuts>(nullptr);
+
+        initGlobalShortcuts();
+      }
     }
   }
 
@@ -201,8 +234,8 @@ static void initGlobalBypass(StreamInputEffects& sie, StreamOutputEffects& soe)
   bypass_coalescer->setSingleShot(true);
 
   auto update_bypass_state = [&]() {
-    soe.set_bypass(DbMain::bypass());
-    sie.set_bypass(DbMain::bypass());
+    soe.set_global_bypass(DbMain::bypass());
+    sie.set_global_bypass(DbMain::bypass());
 
     util::debug((DbMain::bypass() ? "Enabling global bypass" : "Disabling global bypass"));
   };
@@ -291,7 +324,7 @@ static void initQml(QQmlApplicationEngine& engine,
 
 static int runSecondaryInstance(const QLockFile& lockFile,
                                 KAboutData& about,
-                                QApplication& app,
+                                QCoreApplication& app,
                                 CommandLineParser& parser,
                                 bool& show_window) {
   auto local_client = std::make_unique<LocalClient>();
@@ -356,24 +389,67 @@ static int runSecondaryInstance(const QLockFile& lockFile,
   return 0;
 }
 
+static int runRenderMode(KAboutData& about, QCoreApplication& app, CommandLineParser& parser) {
+  parser.process(about, &app);
+  parser.process_debug_option();
+
+  /**
+   * The renderer may run while another instance is processing the live
+   * streams. Nothing it loads may be written back to the settings files and
+   * it must not touch the PipeWire graph.
+   */
+
+  db::Manager::self().set_read_only(true);
+
+  DbMain::setProcessAllOutputs(false);
+  DbMain::setProcessAllInputs(false);
+
+  CoreServices::extra_lv2_paths();
+
+  tags::plugin_name::Model::self();
+
+  OfflineRenderer renderer;
+
+  return renderer.render(parser.render_preset(), parser.render_files()) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
 int main(int argc, char* argv[]) {
-  // Set the desktop app ID before QApplication startup so portal integration
-  // does not try to re-register a different/late app ID on the same bus.
-  QGuiApplication::setDesktopFileName(QStringLiteral(APPLICATION_ID));
+  /**
+   * In headless mode we do not create the QApplication/QML engine path. Only the
+   * PipeWire, effects and presets subsystems are initialized and they are
+   * controlled through the local socket server and the command line options.
+   */
+  const bool render = CommandLineParser::render_requested(argc, argv);
+  const bool headless = render || CommandLineParser::headless_requested(argc, argv);
+
+  // Virtual devices are not needed to render files
+  pw::Manager::offline = render;
+
+  if (!headless) {
+    // Set the desktop app ID before QApplication startup so portal integration
+    // does not try to re-register a different/late app ID on the same bus.
+    QGuiApplication::setDesktopFileName(QStringLiteral(APPLICATION_ID));
+
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+  }
 
-  QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
   QCoreApplication::setOrganizationDomain(ORGANIZATION_DOMAIN);
   QCoreApplication::setApplicationName(APPLICATION_DOMAIN);
   QLoggingCategory::setFilterRules("easyeffects.debug=false");
 
-  KIconTheme::initTheme();
+  if (!headless) {
+    KIconTheme::initTheme();
 
-  QGuiApplication::setWindowIcon(QIcon::fromTheme(QStringLiteral(APPLICATION_ID)));
+    QGuiApplication::setWindowIcon(QIcon::fromTheme(QStringLiteral(APPLICATION_ID)));
+  }
 
-  QApplication app(argc, argv);
+  std::unique_ptr<QCoreApplication> app = headless ? std::make_unique<QCoreApplication>(argc, argv)
+                                                   : std::make_unique<QApplication>(argc, argv);
 
   SignalHandler signalHandler;
 
+  WorkerPoolShutdown worker_pool_shutdown;
+
   if (DbMain::englishLanguage()) {
     KLocalizedString::setLanguages({QStringLiteral("C")});
   }
@@ -394,7 +470,9 @@ int main(int argc, char* argv[]) {
 
   KAboutData::setApplicationData(about);
 
-  KColorSchemeManager::instance();
+  if (!headless) {
+    KColorSchemeManager::instance();
+  }
 
   // Parsing command line options
 
@@ -402,19 +480,23 @@ int main(int argc, char* argv[]) {
 
   QObject::connect(cmd_parser.get(), &CommandLineParser::onReset, [&]() { db::Manager::self().resetAll(); });
 
+  if (render) {
+    return runRenderMode(about, *app, *cmd_parser);
+  }
+
   // Checking if there is already an instance running
 
   auto lockFile = util::get_lock_file();
 
-  bool show_window = true;
+  bool show_window = !headless;
 
   if (!lockFile->isLocked()) {
     // Used only by an instance started when one is already running
 
-    return runSecondaryInstance(*lockFile, about, app, *cmd_parser, show_window);
+    return runSecondaryInstance(*lockFile, about, *app, *cmd_parser, show_window);
   }
 
-  cmd_parser->process(about, &app);
+  cmd_parser->process(about, app.get());
   cmd_parser->process_debug_option();  // if we take too long to process this one we will miss debug messages
   cmd_parser->process_hide_window(show_window);
 
@@ -424,34 +506,43 @@ int main(int argc, char* argv[]) {
   UiState ui;
 
   // Core managers
-  CoreServices core(true);
+  CoreServices core(true, headless);
 
   // Main instance services
   auto local_server = std::make_unique<LocalServer>();
-  auto autostart = std::make_unique<Autostart>(nullptr);
-  auto color_manager = std::make_unique<KColorManager>();
 
-  // theme initialization
+  std::unique_ptr<Autostart> autostart;
+  std::unique_ptr<KColorManager> color_manager;
+  std::unique_ptr<QQmlApplicationEngine> engine;
 
-  if (DbMain::forceBreezeTheme()) {
-    QApplication::setStyle(QStringLiteral("breeze"));
-  }
+  if (headless) {
+    util::debug("Running in headless mode. The graphical interface will not be loaded.");
+  } else {
+    autostart = std::make_unique<Autostart>(nullptr);
+    color_manager = std::make_unique<KColorManager>();
 
-  if (qEnvironmentVariableIsEmpty("QT_QUICK_CONTROLS_STYLE")) {
-    QQuickStyle::setStyle(QStringLiteral("org.kde.desktop"));
-  }
+    // theme initialization
+
+    if (DbMain::forceBreezeTheme()) {
+      QApplication::setStyle(QStringLiteral("breeze"));
+    }
 
-  QQmlApplicationEngine engine;
+    if (qEnvironmentVariableIsEmpty("QT_QUICK_CONTROLS_STYLE")) {
+      QQuickStyle::setStyle(QStringLiteral("org.kde.desktop"));
+    }
+
+    engine = std::make_unique<QQmlApplicationEngine>();
+  }
 
   // Starting the local socket server
 
-  local_server->startServer();  // it has to be done after "QApplication app(argc, argv)"
+  local_server->startServer();  // it has to be done after the application object is created
 
-  QObject::connect(local_server.get(), &LocalServer::onQuitApp, [&]() { QApplication::quit(); });
+  QObject::connect(local_server.get(), &LocalServer::onQuitApp, [&]() { QCoreApplication::quit(); });
 
   initGlobalBypass(*core.sie, *core.soe);
 
-  QObject::connect(&app, &QApplication::aboutToQuit, [&]() { db::Manager::self().saveAll(); });
+  QObject::connect(app.get(), &QCoreApplication::aboutToQuit, [&]() { db::Manager::self().saveAll(); });
 
   QObject::connect(cmd_parser.get(), &CommandLineParser::onHideWindow, [&]() {
     show_window = false;
@@ -461,10 +552,18 @@ int main(int argc, char* argv[]) {
     }
   });
 
-  QObject::connect(cmd_parser.get(), &CommandLineParser::onInitQML,
-                   [&]() { initQml(engine, *autostart, *local_server, ui, show_window); });
+  if (!headless) {
+    QObject::connect(cmd_parser.get(), &CommandLineParser::onInitQML,
+                     [&]() { initQml(*engine, *autostart, *local_server, ui, show_window); });
+  }
 
   cmd_parser->process_events();
 
-  return QApplication::exec();
+#ifdef __GLIBC__
+  if (headless) {
+    malloc_trim(0);
+  }
+#endif
+
+  return QCoreApplication::exec();
 }
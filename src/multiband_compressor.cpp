@@ -39,9 +39,11 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_multiband_compressor.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 MultibandCompressor::MultibandCompressor(const std::string& tag,
                                          pw::Manager* pipe_manager,
@@ -78,16 +80,16 @@ MultibandCompressor::MultibandCompressor(const std::string& tag,
 
   // specific plugin controls
 
-  connect(settings, &DbMultibandCompressor::sidechainInputDeviceChanged, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::sidechainInputDeviceChanged, this, [&]() { update_sidechain_links(); });
 
-  connect(settings, &DbMultibandCompressor::band0SidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbMultibandCompressor::band1SidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbMultibandCompressor::band2SidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbMultibandCompressor::band3SidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbMultibandCompressor::band4SidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbMultibandCompressor::band5SidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbMultibandCompressor::band6SidechainTypeChanged, [&]() { update_sidechain_links(); });
-  connect(settings, &DbMultibandCompressor::band7SidechainTypeChanged, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band0SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band1SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band2SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band3SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band4SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band5SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band6SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
+  connect(settings, &DbMultibandCompressor::band7SidechainTypeChanged, this, [&]() { update_sidechain_links(); });
 
   BIND_LV2_PORT("mode", compressorMode, setCompressorMode, DbMultibandCompressor::compressorModeChanged);
   BIND_LV2_PORT("envb", envelopeBoost, setEnvelopeBoost, DbMultibandCompressor::envelopeBoostChanged);
@@ -115,7 +117,7 @@ MultibandCompressor::~MultibandCompressor() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -212,20 +214,18 @@ void MultibandCompressor::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void MultibandCompressor::process([[maybe_unused]] std::span<float>& left_in,
@@ -252,23 +252,17 @@ void MultibandCompressor::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out, probe_left, probe_right);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   // This plugin gives the latency in number of samples
 
@@ -279,7 +273,7 @@ void MultibandCompressor::process(std::span<float>& left_in,
 
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
   }
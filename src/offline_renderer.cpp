@@ -0,0 +1,353 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "offline_renderer.hpp"
+#include <qnamespace.h>
+#include <qobjectdefs.h>
+#include <sndfile.h>
+#include <sys/types.h>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QString>
+#include <QStringList>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <sndfile.hh>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "dsp_kernels.hpp"
+#include "easyeffects_db_streaminputs.h"
+#include "easyeffects_db_streamoutputs.h"
+#include "effects_base.hpp"
+#include "pipeline_type.hpp"
+#include "plugin_base.hpp"
+#include "presets_manager.hpp"
+#include "pw_manager.hpp"
+#include "util.hpp"
+
+auto OfflineRenderer::render(const QString& preset, const QStringList& files) -> bool {
+  if (files.empty() || files.size() % 2 != 0) {
+    util::warning(log_tag + "the files have to be given in input/output pairs");
+
+    return false;
+  }
+
+  PipelineType pipeline_type = PipelineType::output;
+
+  if (!load_preset(preset, pipeline_type)) {
+    return false;
+  }
+
+  const auto names =
+      (pipeline_type == PipelineType::output) ? DbStreamOutputs::plugins() : DbStreamInputs::plugins();
+
+  const auto n_files = static_cast<size_t>(files.size() / 2);
+  const auto n_jobs = std::clamp<size_t>(std::thread::hardware_concurrency(), 1U, n_files);
+
+  util::debug(std::format("{}rendering {} files with {} jobs", log_tag, n_files, n_jobs));
+
+  std::atomic<size_t> next_file = 0U;
+  std::atomic<size_t> n_failed = 0U;
+  std::atomic<size_t> n_finished_jobs = 0U;
+
+  std::vector<std::thread> jobs;
+
+  for (size_t n = 0U; n < n_jobs; n++) {
+    jobs.emplace_back([&] {
+      for (auto f = next_file++; f < n_files; f = next_file++) {
+        const auto input_path = std::filesystem::path{files[static_cast<qsizetype>(2U * f)].toStdString()};
+        const auto output_path = std::filesystem::path{files[static_cast<qsizetype>((2U * f) + 1U)].toStdString()};
+
+        /**
+         * Every file gets a new chain, so delay lines, reverb tails and level
+         * detectors do not carry anything over from the previous file. The
+         * plugins are QObjects bound to their settings. They have to be
+         * created and destroyed in the main thread.
+         */
+
+        Chain chain;
+
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(), [&] { chain = create_chain(pipeline_type, names); },
+            Qt::BlockingQueuedConnection);
+
+        if (render_file(chain, input_path, output_path)) {
+          util::info(std::format("{}{} -> {}", log_tag, input_path.string(), output_path.string()));
+        } else {
+          n_failed++;
+        }
+
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [&] { chain.clear(); }, Qt::BlockingQueuedConnection);
+      }
+
+      n_finished_jobs++;
+    });
+  }
+
+  /**
+   * Some plugins finish their setup through queued calls to the main thread.
+   * So its event loop has to keep running while the jobs are busy.
+   */
+
+  while (n_finished_jobs < n_jobs) {
+    QCoreApplication::processEvents(QEventLoop::AllEvents);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+
+  for (auto& job : jobs) {
+    job.join();
+  }
+
+  return n_failed == 0U;
+}
+
+auto OfflineRenderer::load_preset(const QString& preset, PipelineType& pipeline_type) -> bool {
+  auto& presets_manager = presets::Manager::self();
+
+  auto preset_path = std::filesystem::path{preset.toStdString()};
+
+  if (!std::filesystem::is_regular_file(preset_path)) {
+    // Not a file. Looking for a local preset with this name.
+
+    preset_path.clear();
+
+    for (const auto& type : {PipelineType::output, PipelineType::input}) {
+      for (const auto& p : presets_manager.get_local_presets_paths(type)) {
+        if (p.stem().string() == preset.toStdString()) {
+          preset_path = p;
+          pipeline_type = type;
+
+          break;
+        }
+      }
+
+      if (!preset_path.empty()) {
+        break;
+      }
+    }
+
+    if (preset_path.empty()) {
+      util::warning(std::format("{}the preset {} does not exist", log_tag, preset.toStdString()));
+
+      return false;
+    }
+  } else {
+    nlohmann::json json;
+
+    try {
+      std::ifstream is(preset_path);
+
+      is >> json;
+    } catch (const std::exception& e) {
+      util::warning(std::format("{}could not parse {}: {}", log_tag, preset_path.string(), e.what()));
+
+      return false;
+    }
+
+    if (json.contains("output")) {
+      pipeline_type = PipelineType::output;
+    } else if (json.contains("input")) {
+      pipeline_type = PipelineType::input;
+    } else {
+      util::warning(std::format("{}{} is not an Easy Effects preset", log_tag, preset_path.string()));
+
+      return false;
+    }
+  }
+
+  return presets_manager.load_preset_file(pipeline_type, preset_path);
+}
+
+auto OfflineRenderer::create_chain(const PipelineType& pipeline_type, const QStringList& names) -> Chain {
+  Chain chain;
+
+  for (const auto& name : names) {
+    auto plugin = EffectsBase::create_plugin(log_tag, &pw::Manager::self(), pipeline_type, name);
+
+    if (plugin == nullptr) {
+      util::warning(std::format("{}skipping the unknown plugin {}", log_tag, name.toStdString()));
+
+      continue;
+    }
+
+    chain.push_back(std::move(plugin));
+  }
+
+  return chain;
+}
+
+void OfflineRenderer::prepare_chain(Chain& chain, const uint& rate) {
+  for (auto& plugin : chain) {
+    plugin->set_format(rate, block_size);
+
+    plugin->wait_for_pending_jobs();
+  }
+
+  // Flushing what the worker jobs have queued for the main thread and whatever these calls queued again.
+
+  QMetaObject::invokeMethod(QCoreApplication::instance(), [] {}, Qt::BlockingQueuedConnection);
+
+  for (auto& plugin : chain) {
+    plugin->wait_for_pending_jobs();
+  }
+}
+
+auto OfflineRenderer::render_file(Chain& chain,
+                                  const std::filesystem::path& input_path,
+                                  const std::filesystem::path& output_path) -> bool {
+  SndfileHandle input(input_path.string());
+
+  if (input.error() != 0) {
+    util::warning(std::format("{}could not open {}: {}", log_tag, input_path.string(), input.strError()));
+
+    return false;
+  }
+
+  const auto n_channels = input.channels();
+
+  if (n_channels != 1 && n_channels != 2) {
+    util::warning(std::format("{}{} has {} channels. Only mono and stereo files are supported", log_tag,
+                              input_path.string(), n_channels));
+
+    return false;
+  }
+
+  SndfileHandle output(output_path.string(), SFM_WRITE, input.format(), n_channels, input.samplerate());
+
+  if (output.error() != 0) {
+    util::warning(std::format("{}could not create {}: {}", log_tag, output_path.string(), output.strError()));
+
+    return false;
+  }
+
+  prepare_chain(chain, static_cast<uint>(input.samplerate()));
+
+  const auto channels = static_cast<size_t>(n_channels);
+
+  std::vector<float> buffer(block_size * channels);
+  std::vector<float> left_a(block_size), right_a(block_size), left_b(block_size), right_b(block_size);
+  std::vector<float> probe_l(block_size), probe_r(block_size);
+
+  auto probe_left = std::span<float>(probe_l);
+  auto probe_right = std::span<float>(probe_r);
+
+  bool end_of_file = false;
+  bool first_block = true;
+
+  sf_count_t frames_to_skip = 0;
+  sf_count_t frames_to_write = input.frames();
+
+  uint64_t clock_position = 0U;
+
+  while (frames_to_write > 0) {
+    sf_count_t n_read = 0;
+
+    if (!end_of_file) {
+      n_read = input.readf(buffer.data(), block_size);
+
+      end_of_file = n_read < static_cast<sf_count_t>(block_size);
+    }
+
+    // After the end of the file the chain is fed with silence until the latency has been flushed.
+
+    std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(n_read) * n_channels, buffer.end(), 0.0F);
+
+    if (channels == 2U) {
+      dsp::deinterleave(buffer, left_a, right_a);
+    } else {
+      std::ranges::copy(buffer, left_a.begin());
+      std::ranges::copy(buffer, right_a.begin());
+    }
+
+    auto left_in = std::span<float>(left_a);
+    auto right_in = std::span<float>(right_a);
+    auto left_out = std::span<float>(left_b);
+    auto right_out = std::span<float>(right_b);
+
+    for (auto& plugin : chain) {
+      plugin->clock_position = clock_position;
+
+      // The buffers belong to the renderer, so the plugins can write to their input
+      plugin->input_is_writable = true;
+
+      if (plugin->enable_probe) {
+        std::ranges::fill(probe_l, 0.0F);
+        std::ranges::fill(probe_r, 0.0F);
+
+        plugin->process(left_in, right_in, left_out, right_out, probe_left, probe_right);
+      } else {
+        plugin->process(left_in, right_in, left_out, right_out);
+      }
+
+      std::swap(left_in, left_out);
+      std::swap(right_in, right_out);
+    }
+
+    clock_position += block_size;
+
+    if (first_block) {
+      // The plugins only know their latency after processing some data.
+
+      for (auto& plugin : chain) {
+        frames_to_skip += std::lround(plugin->get_latency_seconds() * static_cast<float>(input.samplerate()));
+      }
+
+      first_block = false;
+    }
+
+    const auto skipped = std::min<sf_count_t>(frames_to_skip, block_size);
+    const auto count = std::min<sf_count_t>(static_cast<sf_count_t>(block_size) - skipped, frames_to_write);
+
+    frames_to_skip -= skipped;
+
+    if (count == 0) {
+      continue;
+    }
+
+    if (channels == 2U) {
+      dsp::interleave(left_in, right_in, buffer);
+    } else {
+      dsp::downmix(left_in, right_in, buffer);
+    }
+
+    if (output.writef(buffer.data() + (skipped * n_channels), count) != count) {
+      util::warning(std::format("{}could not write to {}: {}", log_tag, output_path.string(), output.strError()));
+
+      return false;
+    }
+
+    frames_to_write -= count;
+  }
+
+  return true;
+}
@@ -0,0 +1,63 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <QString>
+#include <QStringList>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "pipeline_type.hpp"
+#include "plugin_base.hpp"
+
+/**
+ * Applies a preset to audio files without going through the PipeWire graph.
+ * The plugins are created the same way the effects pipelines do it but their
+ * process functions are called directly with blocks read from the files.
+ */
+class OfflineRenderer {
+ public:
+  OfflineRenderer() = default;
+
+  /**
+   * The preset can be a local preset name or the path to a preset file. The
+   * files list holds input and output paths one after the other. Returns false
+   * if any of the files could not be rendered.
+   */
+  auto render(const QString& preset, const QStringList& files) -> bool;
+
+ private:
+  const std::string log_tag = "offline_renderer: ";
+
+  static constexpr uint block_size = 1024U;
+
+  using Chain = std::vector<std::unique_ptr<PluginBase>>;
+
+  auto load_preset(const QString& preset, PipelineType& pipeline_type) -> bool;
+
+  auto create_chain(const PipelineType& pipeline_type, const QStringList& names) -> Chain;
+
+  auto render_file(Chain& chain, const std::filesystem::path& input_path, const std::filesystem::path& output_path)
+      -> bool;
+
+  static void prepare_chain(Chain& chain, const uint& rate);
+};
@@ -29,12 +29,15 @@
 #include <span>
 #include <string>
 #include "db_manager.hpp"
+#include "dsp_kernels.hpp"
 #include "easyeffects_db_pitch.h"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Pitch::Pitch(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -47,42 +50,49 @@ Pitch::Pitch(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
                                                           tags::plugin_name::BaseName::pitch + "#" + instance_id)) {
   init_common_controls<DbPitch>(settings);
 
-  dry = (settings->dry() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->dry()));
+  data.resize(2U * static_cast<size_t>(max_quantum));
 
-  wet = (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
+  dry.reset((settings->dry() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->dry())));
+
+  wet.reset((settings->wet() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->wet())));
+
+  ramped_values.push_back(&dry);
+  ramped_values.push_back(&wet);
 
   // resetting soundtouch when bypass is pressed so its internal data is discarded
 
-  connect(settings, &DbPitch::bypassChanged, [&]() { resetHistory(); });
+  connect(settings, &DbPitch::bypassChanged, this, [&]() { resetHistory(); });
 
-  connect(settings, &DbPitch::quickSeekChanged, [&]() { set_quick_seek(); });
+  connect(settings, &DbPitch::quickSeekChanged, this, [&]() { set_quick_seek(); });
 
-  connect(settings, &DbPitch::antiAliasChanged, [&]() { set_anti_alias(); });
+  connect(settings, &DbPitch::antiAliasChanged, this, [&]() { set_anti_alias(); });
 
-  connect(settings, &DbPitch::sequenceLengthChanged, [&]() { set_sequence_length(); });
+  connect(settings, &DbPitch::sequenceLengthChanged, this, [&]() { set_sequence_length(); });
 
-  connect(settings, &DbPitch::seekWindowChanged, [&]() { set_seek_window(); });
+  connect(settings, &DbPitch::seekWindowChanged, this, [&]() { set_seek_window(); });
 
-  connect(settings, &DbPitch::overlapLengthChanged, [&]() { set_overlap_length(); });
+  connect(settings, &DbPitch::overlapLengthChanged, this, [&]() { set_overlap_length(); });
 
-  connect(settings, &DbPitch::tempoDifferenceChanged, [&]() { set_tempo_difference(); });
+  connect(settings, &DbPitch::tempoDifferenceChanged, this, [&]() { set_tempo_difference(); });
 
-  connect(settings, &DbPitch::rateDifferenceChanged, [&]() { set_rate_difference(); });
+  connect(settings, &DbPitch::rateDifferenceChanged, this, [&]() { set_rate_difference(); });
 
-  connect(settings, &DbPitch::octavesChanged, [&]() { set_semitones(); });
+  connect(settings, &DbPitch::octavesChanged, this, [&]() { set_semitones(); });
 
-  connect(settings, &DbPitch::semitonesChanged, [&]() { set_semitones(); });
+  connect(settings, &DbPitch::semitonesChanged, this, [&]() { set_semitones(); });
 
-  connect(settings, &DbPitch::centsChanged, [&]() { set_semitones(); });
+  connect(settings, &DbPitch::centsChanged, this, [&]() { set_semitones(); });
 
-  connect(settings, &DbPitch::dryChanged, [&]() {
-    dry =
-        (settings->dry() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->dry()));
+  connect(settings, &DbPitch::dryChanged, this, [&]() {
+    dry.set((settings->dry() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->dry())));
   });
 
-  connect(settings, &DbPitch::wetChanged, [&]() {
-    wet =
-        (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
+  connect(settings, &DbPitch::wetChanged, this, [&]() {
+    wet.set((settings->wet() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->wet())));
   });
 }
 
@@ -93,7 +103,7 @@ Pitch::~Pitch() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   delete snd_touch;
 
@@ -120,7 +130,7 @@ void Pitch::setup() {
 
   soundtouch_ready = false;
 
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
         if (soundtouch_ready) {
@@ -129,10 +139,6 @@ void Pitch::setup() {
 
         latency_n_frames = 0U;
 
-        if (data.size() != static_cast<size_t>(n_samples) * 2) {
-          data.resize(2U * static_cast<size_t>(n_samples));
-        }
-
         deque_out_L.resize(0U);
         deque_out_R.resize(0U);
 
@@ -142,7 +148,11 @@ void Pitch::setup() {
 
         soundtouch_ready = true;
       },
-      Qt::QueuedConnection);
+      WorkerPool::Priority::high);
+}
+
+void Pitch::quantum_changed() {
+  // SoundTouch takes any number of frames. Its output queues adapt to the new quantum.
 }
 
 void Pitch::process(std::span<float>& left_in,
@@ -158,14 +168,9 @@ void Pitch::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
-  for (size_t n = 0U; n < left_in.size(); n++) {
-    data[n * 2U] = left_in[n];
-    data[(n * 2U) + 1U] = right_in[n];
-  }
+  dsp::interleave(left_in, right_in, data);
 
   snd_touch->putSamples(data.data(), n_samples);
 
@@ -216,20 +221,14 @@ void Pitch::process(std::span<float>& left_in,
     }
   }
 
-  for (size_t n = 0; n < left_out.size(); n++) {
-    left_out[n] = (wet * left_out[n]) + (dry * left_in[n]);
-
-    right_out[n] = (wet * right_out[n]) + (dry * right_in[n]);
-  }
+  RampedValue::mix(left_out, right_out, left_in, right_in, wet, dry);
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
 
@@ -356,9 +355,5 @@ auto Pitch::get_latency_seconds() -> float {
 }
 
 void Pitch::resetHistory() {
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-
-  QMetaObject::invokeMethod(baseWorker, [this] { setup(); }, Qt::QueuedConnection);
-
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+  WorkerPool::post(baseWorker, [this] { setup(); }, WorkerPool::Priority::high);
 }
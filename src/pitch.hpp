@@ -33,6 +33,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "ramped_value.hpp"
 
 class Pitch : public PluginBase {
   Q_OBJECT
@@ -59,6 +60,8 @@ class Pitch : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
@@ -83,7 +86,7 @@ class Pitch : public PluginBase {
 
   uint latency_n_frames = 0U;
 
-  float dry = 0.0F, wet = 1.0F;
+  RampedValue dry{0.0F}, wet{1.0F};
 
   std::vector<float> data_L, data_R, data;
 
@@ -48,19 +48,39 @@
 #include <cstddef>
 #include <cstdint>
 #include <format>
+#include <numbers>
 #include <span>
 #include <string>
 #include <thread>
 #include <utility>
 #include "db_manager.hpp"
+#include "dsp_kernels.hpp"
 #include "pipeline_type.hpp"
 #include "pw_manager.hpp"
+#include "ramped_value.hpp"
+#include "rt_log.hpp"
 #include "tags_app.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 namespace {
 
+// Used when PipeWire gives us more frames than our buffers can hold
+void passthrough(PluginBase::port* in, PluginBase::port* out, const uint& n_samples) {
+  auto* out_buffer = static_cast<float*>(pw_filter_get_dsp_buffer(out, n_samples));
+
+  if (out_buffer == nullptr) {
+    return;
+  }
+
+  if (auto* in_buffer = static_cast<float*>(pw_filter_get_dsp_buffer(in, n_samples)); in_buffer != nullptr) {
+    std::copy_n(in_buffer, n_samples, out_buffer);
+  } else {
+    std::fill_n(out_buffer, n_samples, 0.0F);
+  }
+}
+
 void on_process(void* userdata, spa_io_position* position) {
   auto* d = static_cast<PluginBase::data*>(userdata);
 
@@ -71,37 +91,47 @@ void on_process(void* userdata, spa_io_position* position) {
     return;
   }
 
-  // We had to add the following checks for dummy array sizes. See #4085
-  if (d->pb->dummy_left.size() != n_samples) {
-    d->pb->dummy_left.resize(n_samples);
+  d->pb->clock_position = position->clock.position;
 
-    std::ranges::fill(d->pb->dummy_left, 0.0F);
-  }
+  if (n_samples > PluginBase::max_quantum) {
+    if (!d->pb->got_oversized_quantum) {
+      util::rt_warning("Processing: the quantum {} is larger than the maximum of {} frames. Passing the audio through.",
+                       n_samples, PluginBase::max_quantum);
 
-  if (d->pb->dummy_right.size() != n_samples) {
-    d->pb->dummy_right.resize(n_samples);
+      d->pb->got_oversized_quantum = true;
+    }
 
-    std::ranges::fill(d->pb->dummy_right, 0.0F);
-  }
+    passthrough(d->in_left, d->out_left, n_samples);
+    passthrough(d->in_right, d->out_right, n_samples);
 
-  if (DbMain::copyFilterInputBuffers() && d->pb->copy_left_in.size() != n_samples) {
-    d->pb->copy_left_in.resize(n_samples);
-    d->pb->copy_right_in.resize(n_samples);
+    return;
   }
 
   if (rate != d->pb->rate || n_samples != d->pb->n_samples) {
-    d->pb->rate = rate;
-    d->pb->n_samples = n_samples;
-
     d->pb->got_null_left_in = false;
     d->pb->got_null_left_out = false;
     d->pb->got_null_right_in = false;
     d->pb->got_null_right_out = false;
     d->pb->got_null_probe = false;
+    d->pb->got_oversized_quantum = false;
+
+    /**
+     * PipeWire changes the quantum whenever clients with different latency
+     * requirements come and go. Only a new rate makes the plugins set
+     * themselves up again.
+     */
 
-    d->pb->setup();
+    if (rate != d->pb->rate) {
+      d->pb->set_format(rate, n_samples);
+    } else {
+      d->pb->set_quantum(n_samples);
+    }
   }
 
+  // The buffers are allocated for the maximum quantum. See #4085
+  auto dummy_left = std::span(d->pb->dummy_left).first(n_samples);
+  auto dummy_right = std::span(d->pb->dummy_right).first(n_samples);
+
   // util::warning("Processing: " + util::to_string(n_samples));
 
   auto* in_left = static_cast<float*>(pw_filter_get_dsp_buffer(d->in_left, n_samples));
@@ -117,118 +147,107 @@ void on_process(void* userdata, spa_io_position* position) {
 
   if (in_left != nullptr) {
     left_in = std::span(in_left, n_samples);
-
-    if (DbMain::copyFilterInputBuffers()) {
-      std::ranges::copy(left_in, d->pb->copy_left_in.begin());
-    }
-
   } else {
     if (!d->pb->got_null_left_in) {
-      util::debug("Processing: we received a null left_in pointer. Using the dummy array instead.");
+      util::rt_debug("Processing: we received a null left_in pointer. Using the dummy array instead.");
 
       d->pb->got_null_left_in = true;
     }
 
-    std::ranges::fill(d->pb->dummy_left, 0.0F);
+    std::ranges::fill(dummy_left, 0.0F);
 
-    left_in = d->pb->dummy_left;
+    left_in = dummy_left;
   }
 
   if (in_right != nullptr) {
     right_in = std::span(in_right, n_samples);
-
-    if (DbMain::copyFilterInputBuffers()) {
-      std::ranges::copy(right_in, d->pb->copy_right_in.begin());
-    }
-
   } else {
     if (!d->pb->got_null_right_in) {
-      util::debug("Processing: we received a null right_in pointer. Using the dummy array instead.");
+      util::rt_debug("Processing: we received a null right_in pointer. Using the dummy array instead.");
 
       d->pb->got_null_right_in = true;
     }
 
-    std::ranges::fill(d->pb->dummy_right, 0.0F);
+    std::ranges::fill(dummy_right, 0.0F);
 
-    right_in = d->pb->dummy_right;
+    right_in = dummy_right;
   }
 
   if (out_left != nullptr) {
     left_out = std::span(out_left, n_samples);
   } else {
     if (!d->pb->got_null_left_out) {
-      util::debug("Processing: we received a null left_out pointer. Using the dummy array instead.");
+      util::rt_debug("Processing: we received a null left_out pointer. Using the dummy array instead.");
 
       d->pb->got_null_left_out = true;
     }
 
-    std::ranges::fill(d->pb->dummy_left, 0.0F);
+    std::ranges::fill(dummy_left, 0.0F);
 
-    left_out = d->pb->dummy_left;
+    left_out = dummy_left;
   }
 
   if (out_right != nullptr) {
     right_out = std::span(out_right, n_samples);
   } else {
     if (!d->pb->got_null_right_out) {
-      util::debug("Processing: we received a null right_out pointer. Using the dummy array instead.");
+      util::rt_debug("Processing: we received a null right_out pointer. Using the dummy array instead.");
 
       d->pb->got_null_right_out = true;
     }
 
-    std::ranges::fill(d->pb->dummy_right, 0.0F);
+    std::ranges::fill(dummy_right, 0.0F);
 
-    right_out = d->pb->dummy_right;
+    right_out = dummy_right;
   }
 
-  if (!d->pb->enable_probe) {
-    if (DbMain::copyFilterInputBuffers()) {
-      auto copy_left_in = std::span(d->pb->copy_left_in);
-      auto copy_right_in = std::span(d->pb->copy_right_in);
+  if (d->pb->skip_silent_block(left_in, right_in, left_out, right_out)) {
+    return;
+  }
 
-      d->pb->process(copy_left_in, copy_right_in, left_out, right_out);
-    } else {
-      d->pb->process(left_in, right_in, left_out, right_out);
-    }
+  /**
+   * Only the plugins that declare they write to their input get the copy up
+   * front. The input gain makes its own copy when it is needed. See
+   * modifies_input()
+   */
+  d->pb->input_is_writable = d->pb->modifies_input();
+
+  if (d->pb->input_is_writable) {
+    auto copy_left_in = std::span(d->pb->copy_left_in).first(n_samples);
+    auto copy_right_in = std::span(d->pb->copy_right_in).first(n_samples);
+
+    std::ranges::copy(left_in, copy_left_in.begin());
+    std::ranges::copy(right_in, copy_right_in.begin());
 
+    left_in = copy_left_in;
+    right_in = copy_right_in;
+  }
+
+  if (!d->pb->enable_probe) {
+    d->pb->process(left_in, right_in, left_out, right_out);
   } else {
     auto* probe_left = static_cast<float*>(pw_filter_get_dsp_buffer(d->probe_left, n_samples));
     auto* probe_right = static_cast<float*>(pw_filter_get_dsp_buffer(d->probe_right, n_samples));
 
     if (probe_left == nullptr || probe_right == nullptr) {
       if (!d->pb->got_null_probe) {
-        util::debug("Processing: we received a null pointer for probe left/right. Using the dummy array instead.");
+        util::rt_debug("Processing: we received a null pointer for probe left/right. Using the dummy array instead.");
 
         d->pb->got_null_probe = true;
       }
 
-      std::ranges::fill(d->pb->dummy_left, 0.0F);
-      std::ranges::fill(d->pb->dummy_right, 0.0F);
-
-      std::span l(d->pb->dummy_left.data(), n_samples);
-      std::span r(d->pb->dummy_right.data(), n_samples);
+      std::ranges::fill(dummy_left, 0.0F);
+      std::ranges::fill(dummy_right, 0.0F);
 
-      if (DbMain::copyFilterInputBuffers()) {
-        auto copy_left_in = std::span(d->pb->copy_left_in);
-        auto copy_right_in = std::span(d->pb->copy_right_in);
-
-        d->pb->process(copy_left_in, copy_right_in, left_out, right_out, l, r);
-      } else {
-        d->pb->process(left_in, right_in, left_out, right_out, l, r);
-      }
+      auto l = dummy_left;
+      auto r = dummy_right;
 
+      d->pb->process(left_in, right_in, left_out, right_out, l, r);
     } else {
       std::span l(probe_left, n_samples);
       std::span r(probe_right, n_samples);
 
-      if (DbMain::copyFilterInputBuffers()) {
-        auto copy_left_in = std::span(d->pb->copy_left_in);
-        auto copy_right_in = std::span(d->pb->copy_right_in);
-
-        d->pb->process(copy_left_in, copy_right_in, left_out, right_out, l, r);
-      } else {
-        d->pb->process(left_in, right_in, left_out, right_out, l, r);
-      }
+      d->pb->process(left_in, right_in, left_out, right_out, l, r);
     }
   }
 }
@@ -311,11 +330,18 @@ PluginBase::PluginBase(std::string tag,
       name(std::move(plugin_name)),
       package(std::move(package)),
       instance_id(std::move(instance_id)),
+      log_name(name.toStdString()),
       pipeline_type(pipe_type),
       enable_probe(enable_probe),
       pm(pipe_manager),
       baseWorker(new PluginBaseWorker),
       native_ui_timer(new QTimer(this)) {
+  // Allocated once for the largest quantum so the realtime thread never resizes them
+  dummy_left.resize(max_quantum, 0.0F);
+  dummy_right.resize(max_quantum, 0.0F);
+  copy_left_in.resize(max_quantum, 0.0F);
+  copy_right_in.resize(max_quantum, 0.0F);
+
   QString description;
   QString description_pipeline;
 
@@ -328,12 +354,14 @@ PluginBase::PluginBase(std::string tag,
       break;
   }
 
-  if (name != "output_level" && name != "spectrum") {
+  if (name != "output_level" && name != "spectrum" && name != "chain_fader") {
     description = tags::plugin_name::Model::self().translate(name) + " " + description_pipeline;
   } else if (name == "output_level") {
     description = i18n("Output Level Meter");
   } else if (name == "spectrum") {
     description = i18n("Spectrum");
+  } else if (name == "chain_fader") {
+    description = i18n("Effects Chain Crossfade");
   }
 
   pf_data.pb = this;
@@ -354,6 +382,13 @@ PluginBase::PluginBase(std::string tag,
   pw_properties_set(props_filter, PW_KEY_NODE_GROUP, log_tag == "soe: " ? "ee_sink_group" : "ee_source_group");
   pw_properties_set(props_filter, PW_KEY_NODE_PASSIVE, log_tag == "soe: " ? "true" : "false");
 
+  // The key is spelled out because PW_KEY_NODE_LOOP_NAME does not exist in the oldest PipeWire we support
+
+  if (const auto& loop_name = (pipeline_type == PipelineType::output) ? pm->output_data_loop : pm->input_data_loop;
+      !loop_name.empty()) {
+    pw_properties_set(props_filter, "node.loop.name", loop_name.c_str());
+  }
+
   filter = pw_filter_new(pm->core, filter_name.c_str(), props_filter);
 
   // left channel input
@@ -439,13 +474,11 @@ PluginBase::PluginBase(std::string tag,
     lv2_wrapper->update_ui();
   });
 
-  // worker thread for the native ui and maybe also other things
-
-  baseWorker->moveToThread(&workerThread);
+  // Shared worker thread for the native ui and the reinitializations done in setup()
 
-  workerThread.start();
+  workerThread = WorkerPool::self().acquire_thread();
 
-  connect(&workerThread, &QThread::finished, baseWorker, &QObject::deleteLater);
+  baseWorker->moveToThread(workerThread);
 }
 
 PluginBase::~PluginBase() {
@@ -465,8 +498,15 @@ PluginBase::~PluginBase() {
 void PluginBase::stop_worker() {
   native_ui_timer->stop();
 
-  workerThread.quit();
-  workerThread.wait();
+  if (baseWorker == nullptr) {
+    return;
+  }
+
+  WorkerPool::destroy_context(baseWorker);
+
+  baseWorker = nullptr;
+
+  WorkerPool::self().release_thread(workerThread);
 }
 
 void PluginBase::reset() {}
@@ -590,6 +630,45 @@ void PluginBase::clear_data() {}
 
 void PluginBase::setup() {}
 
+void PluginBase::set_format(const uint& new_rate, const uint& new_n_samples) {
+  rate = new_rate;
+  n_samples = new_n_samples;
+
+  for (auto* v : ramped_values) {
+    v->set_rate(rate);
+  }
+
+  setup();
+}
+
+void PluginBase::set_quantum(const uint& new_n_samples) {
+  n_samples = new_n_samples;
+
+  quantum_changed();
+}
+
+void PluginBase::quantum_changed() {
+  setup();
+}
+
+auto PluginBase::modifies_input() -> bool {
+  return false;
+}
+
+auto PluginBase::is_ready() -> bool {
+  return rate != 0U && (baseWorker == nullptr || !baseWorker->has_pending_jobs());
+}
+
+void PluginBase::detach_settings() {
+  for (auto* object : settings_objects) {
+    object->disconnect(this);
+  }
+}
+
+void PluginBase::wait_for_pending_jobs() {
+  WorkerPool::wait_for_pending_jobs(baseWorker);
+}
+
 void PluginBase::process([[maybe_unused]] std::span<float>& left_in,
                          [[maybe_unused]] std::span<float>& right_in,
                          [[maybe_unused]] std::span<float>& left_out,
@@ -606,30 +685,65 @@ auto PluginBase::get_latency_seconds() -> float {
   return 0.0F;
 }
 
+auto PluginBase::get_tail_seconds() -> float {
+  return tail_seconds.load(std::memory_order_relaxed);
+}
+
+auto PluginBase::skip_silent_block(const std::span<float>& left_in,
+                                   const std::span<float>& right_in,
+                                   std::span<float>& left_out,
+                                   std::span<float>& right_out) -> bool {
+  const auto tail = get_tail_seconds();
+
+  if (tail < 0.0F || rate == 0U) {
+    return false;
+  }
+
+  if (dsp::peak(left_in) > silence_threshold || dsp::peak(right_in) > silence_threshold) {
+    silent_frames = 0U;
+
+    return false;
+  }
+
+  silent_frames += left_in.size();
+
+  // The block has to start after the latency and the tail of the last non silent input
+
+  const auto tail_frames = static_cast<uint64_t>((tail + latency_value) * static_cast<float>(rate));
+
+  if (silent_frames - left_in.size() <= tail_frames) {
+    return false;
+  }
+
+  std::ranges::fill(left_out, 0.0F);
+  std::ranges::fill(right_out, 0.0F);
+
+  if (updateLevelMeters) {
+    get_peaks(left_in, right_in, left_out, right_out);
+  }
+
+  return true;
+}
+
 void PluginBase::showNativeUi() {
   native_ui_timer->start();
 
-  // using invokeMethod to force this code to run in the base class worker thread and
-  // avoid load in QML or main thread.
+  // Running this code in the worker thread to avoid load in QML or main thread.
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
         if (lv2_wrapper != nullptr && !lv2_wrapper->has_ui()) {
           lv2_wrapper->load_ui();
         }
       },
-      Qt::QueuedConnection);
-
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::low);
 }
 
 void PluginBase::closeNativeUi() {
   native_ui_timer->stop();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
         if (lv2_wrapper != nullptr) {
@@ -637,9 +751,7 @@ void PluginBase::closeNativeUi() {
           lv2_wrapper->close_ui();
         }
       },
-      Qt::QueuedConnection);
-
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::low);
 }
 
 void PluginBase::set_native_ui_update_frequency(const uint& value) {
@@ -650,44 +762,130 @@ void PluginBase::set_native_ui_update_frequency(const uint& value) {
   native_ui_timer->setInterval(static_cast<long>(1000.0 / value));
 }
 
+auto PluginBase::filter_ring_seconds(const double& frequency, const double& quality) -> float {
+  if (frequency <= 0.0) {
+    return 0.0F;
+  }
+
+  // The envelope of a resonance decays as exp(-pi * f * t / Q). Below 1/sqrt(2) there is no resonance.
+
+  const auto q = std::max(quality, 1.0 / std::numbers::sqrt2);
+
+  return static_cast<float>(std::log(1000.0) * q / (std::numbers::pi * frequency));
+}
+
 void PluginBase::get_peaks(const std::span<float>& left_in,
                            const std::span<float>& right_in,
                            std::span<float>& left_out,
                            std::span<float>& right_out) {
-  float in_left_max = 0.0F;
-  float in_right_max = 0.0F;
-  float out_left_max = 0.0F;
-  float out_right_max = 0.0F;
+  input_peak_left = util::linear_to_db(dsp::peak(left_in.first(n_samples)));
+  input_peak_right = util::linear_to_db(dsp::peak(right_in.first(n_samples)));
+  output_peak_left = util::linear_to_db(dsp::peak(left_out.first(n_samples)));
+  output_peak_right = util::linear_to_db(dsp::peak(right_out.first(n_samples)));
+}
 
-  for (size_t i = 0; i < n_samples; ++i) {
-    in_left_max = std::max(in_left_max, std::fabs(left_in[i]));
-    in_right_max = std::max(in_right_max, std::fabs(right_in[i]));
-    out_left_max = std::max(out_left_max, std::fabs(left_out[i]));
-    out_right_max = std::max(out_right_max, std::fabs(right_out[i]));
+void PluginBase::apply_gain(std::span<float>& left, std::span<float>& right, const float& gain) const {
+  if (left.empty() || right.empty()) {
+    return;
   }
 
-  input_peak_left = util::linear_to_db(in_left_max);
-  input_peak_right = util::linear_to_db(in_right_max);
-  output_peak_left = util::linear_to_db(out_left_max);
-  output_peak_right = util::linear_to_db(out_right_max);
+  dsp::apply_gain(left.first(n_samples), gain);
+  dsp::apply_gain(right.first(n_samples), gain);
 }
 
-void PluginBase::apply_gain(std::span<float>& left, std::span<float>& right, const float& gain) const {
+void PluginBase::apply_gain(std::span<float>& left, std::span<float>& right, RampedValue& gain) const {
   if (left.empty() || right.empty()) {
     return;
   }
 
-  float* __restrict l_ptr = left.data();
-  float* __restrict r_ptr = right.data();
+  gain.apply(left.first(n_samples), right.first(n_samples));
+}
+
+void PluginBase::apply_input_gain(std::span<float>& left_in, std::span<float>& right_in) {
+  if (left_in.empty() || right_in.empty()) {
+    return;
+  }
+
+  /**
+   * The decision is taken once per block. If the gain is unity nothing is
+   * written, and a change that arrives after the check is picked up in the next
+   * block. Otherwise the input is moved to the private copy before it is
+   * scaled.
+   */
+
+  if (input_gain.is_unity()) {
+    return;
+  }
+
+  if (!input_is_writable) {
+    const auto count = std::min({left_in.size(), right_in.size(), static_cast<size_t>(max_quantum)});
 
-  for (uint i = 0; i < n_samples; i++) {
-    l_ptr[i] *= gain;
-    r_ptr[i] *= gain;
+    auto copy_left = std::span(copy_left_in).first(count);
+    auto copy_right = std::span(copy_right_in).first(count);
+
+    std::ranges::copy(left_in.first(count), copy_left.begin());
+    std::ranges::copy(right_in.first(count), copy_right.begin());
+
+    left_in = copy_left;
+    right_in = copy_right;
+
+    input_is_writable = true;
+  }
+
+  input_gain.apply(left_in, right_in);
+}
+
+void PluginBase::apply_gain_and_get_peaks(const std::span<float>& left_in,
+                                          const std::span<float>& right_in,
+                                          std::span<float>& left_out,
+                                          std::span<float>& right_out,
+                                          const float& gain) {
+  if (!updateLevelMeters) {
+    if (gain != 1.0F) {
+      apply_gain(left_out, right_out, gain);
+    }
+
+    return;
+  }
+
+  if (gain == 1.0F) {
+    get_peaks(left_in, right_in, left_out, right_out);
+
+    return;
+  }
+
+  // The output is scaled and measured in a single pass
+
+  input_peak_left = util::linear_to_db(dsp::peak(left_in.first(n_samples)));
+  input_peak_right = util::linear_to_db(dsp::peak(right_in.first(n_samples)));
+  output_peak_left = util::linear_to_db(dsp::apply_gain_peak(left_out.first(n_samples), gain));
+  output_peak_right = util::linear_to_db(dsp::apply_gain_peak(right_out.first(n_samples), gain));
+}
+
+void PluginBase::apply_gain_and_get_peaks(const std::span<float>& left_in,
+                                          const std::span<float>& right_in,
+                                          std::span<float>& left_out,
+                                          std::span<float>& right_out,
+                                          RampedValue& gain) {
+  if (!gain.is_ramping()) {
+    apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, gain.value());
+
+    return;
+  }
+
+  apply_gain(left_out, right_out, gain);
+
+  if (updateLevelMeters) {
+    get_peaks(left_in, right_in, left_out, right_out);
   }
 }
 
 void PluginBase::update_probe_links() {}
 
+void PluginBase::set_analysis_tap(const QString& tap) {
+  analysis_tap = tap;
+}
+
 void PluginBase::update_filter_params() {
   pw_loop_invoke(pw_thread_loop_get_loop(pm->thread_loop), update_filter, 1, nullptr, 0, false, this);  // NOLINT
 }
@@ -27,6 +27,7 @@
 #include <sys/types.h>
 #include <QTimer>
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <span>
@@ -35,9 +36,11 @@
 #include "lv2_wrapper.hpp"
 #include "pipeline_type.hpp"
 #include "pw_manager.hpp"
+#include "ramped_value.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
-class PluginBaseWorker : public QObject {
+class PluginBaseWorker : public WorkerContext {
   Q_OBJECT
 };
 
@@ -84,6 +87,9 @@ class PluginBase : public QObject {
 
   QString name, package, instance_id;
 
+  // The name as a std::string so the realtime thread can log it without converting it
+  const std::string log_name;
+
   PipelineType pipeline_type{};
 
   pw_filter* filter = nullptr;
@@ -98,6 +104,9 @@ class PluginBase : public QObject {
 
   uint rate = 0U;
 
+  // Largest quantum we process. It is PipeWire's default clock.quantum-limit.
+  static constexpr uint max_quantum = 8192U;
+
   bool packageInstalled = true;
 
   std::atomic<bool> bypass = {false};
@@ -120,11 +129,17 @@ class PluginBase : public QObject {
   bool got_null_right_in = false;
   bool got_null_right_out = false;
   bool got_null_probe = false;
+  bool got_oversized_quantum = false;
 
   bool updateLevelMeters = false;
 
   std::vector<float> dummy_left, dummy_right, copy_left_in, copy_right_in;
 
+  // Set before each process() call. True when the input spans are private to the plugin and can be written to.
+  bool input_is_writable = false;
+
+  uint64_t clock_position = 0U;  // of the graph cycle being processed
+
   [[nodiscard]] auto get_node_id() const -> uint;
 
   void set_active(const bool& state) const;
@@ -143,6 +158,45 @@ class PluginBase : public QObject {
 
   virtual void setup();
 
+  // Sets the sampling rate and block size and then calls setup(). Used by the realtime thread and the offline renderer.
+  void set_format(const uint& new_rate, const uint& new_n_samples);
+
+  // Sets the block size and then calls quantum_changed(). Used by the realtime thread when the rate is the same.
+  void set_quantum(const uint& new_n_samples);
+
+  /**
+   * Called by the realtime thread when only the quantum changes. The buffers
+   * given to process() never have more than max_quantum frames, so plugins
+   * that work with any block size override it with something realtime safe
+   * instead of setting themselves up again. The default calls setup().
+   */
+  virtual void quantum_changed();
+
+  // Blocks until the reinitializations posted to the worker thread are done.
+  virtual void wait_for_pending_jobs();
+
+  /**
+   * Whether the plugin got its format from the graph and has no setup job
+   * pending. A chain is faded in only when its plugins are ready.
+   */
+  virtual auto is_ready() -> bool;
+
+  /**
+   * Stops following the settings. The plugin keeps the parameters it has
+   * while a chain made with the new ones replaces it.
+   */
+  void detach_settings();
+
+  /**
+   * The input spans given to process() point straight at the buffers PipeWire
+   * shares with the other consumers of the previous node, like the applications
+   * recording from our monitors. Plugins must not write to them. The input gain
+   * goes through apply_input_gain(), which moves the input to a private copy
+   * first when the gain is not unity. Plugins that write to their input in any
+   * other way have to return true here and always get the copy.
+   */
+  virtual auto modifies_input() -> bool;
+
   virtual void process(std::span<float>& left_in,
                        std::span<float>& right_in,
                        std::span<float>& left_out,
@@ -157,8 +211,26 @@ class PluginBase : public QObject {
 
   virtual void update_probe_links();
 
+  // Name of the chain position whose signal reaches the input of this plugin. Set by the pipeline when it is linked.
+  virtual void set_analysis_tap(const QString& tap);
+
   virtual auto get_latency_seconds() -> float;
 
+  /**
+   * How long the output keeps sounding after the input becomes silent, not
+   * counting the latency. Once it has passed the processing is skipped until
+   * the input is not silent anymore. Negative values mean the plugin is always
+   * processed. It is called by the realtime thread, so it must not read the
+   * settings. The default returns tail_seconds.
+   */
+  virtual auto get_tail_seconds() -> float;
+
+  // Zero-fills the output instead of processing when the input has been silent for longer than the tail.
+  auto skip_silent_block(const std::span<float>& left_in,
+                         const std::span<float>& right_in,
+                         std::span<float>& left_out,
+                         std::span<float>& right_out) -> bool;
+
   Q_INVOKABLE virtual void reset() = 0;
 
   Q_INVOKABLE [[nodiscard]] float getInputLevelLeft() const;
@@ -191,14 +263,34 @@ class PluginBase : public QObject {
 
   uint n_ports = 4U;
 
-  float input_gain = 1.0F;
-  float output_gain = 1.0F;
+  RampedValue input_gain;
+  RampedValue output_gain;
+
+  // Parameters whose ramp length follows the sampling rate. Subclasses add their own mix controls.
+  std::vector<RampedValue*> ramped_values = {&input_gain, &output_gain};
 
   std::unique_ptr<lv2::Lv2Wrapper> lv2_wrapper;
 
+  static constexpr float silence_threshold = 1e-6F;  // -120 dB
+
+  static constexpr float filter_tail_seconds = 0.5F;  // Ringing of filters and settling of level detectors
+
+  // Time the ringing of a filter at the frequency with the given quality takes to decay by 60 dB.
+  [[nodiscard]] static auto filter_ring_seconds(const double& frequency, const double& quality) -> float;
+
+  uint64_t silent_frames = 0U;
+
+  // Set from the main thread by the plugins whose tail depends on their settings
+  std::atomic<float> tail_seconds = -1.0F;
+
+  QString analysis_tap;
+
+  // Settings objects whose signals are connected to this plugin
+  std::vector<QObject*> settings_objects;
+
   PluginBaseWorker* baseWorker;
 
-  QThread workerThread;
+  QThread* workerThread = nullptr;
 
   void get_peaks(const std::span<float>& left_in,
                  const std::span<float>& right_in,
@@ -207,21 +299,44 @@ class PluginBase : public QObject {
 
   void apply_gain(std::span<float>& left, std::span<float>& right, const float& gain) const;
 
+  void apply_gain(std::span<float>& left, std::span<float>& right, RampedValue& gain) const;
+
+  // Applies input_gain. The spans are pointed to the private copy of the input if they are not writable.
+  void apply_input_gain(std::span<float>& left_in, std::span<float>& right_in);
+
+  /**
+   * Same as applying the gain to the output buffers and then calling
+   * get_peaks, but the output is read only once when the meters are enabled.
+   */
+  void apply_gain_and_get_peaks(const std::span<float>& left_in,
+                                const std::span<float>& right_in,
+                                std::span<float>& left_out,
+                                std::span<float>& right_out,
+                                const float& gain);
+
+  void apply_gain_and_get_peaks(const std::span<float>& left_in,
+                                const std::span<float>& right_in,
+                                std::span<float>& left_out,
+                                std::span<float>& right_out,
+                                RampedValue& gain);
+
   void update_filter_params();
 
   void stop_worker();
 
   template <typename dbClass>
   void init_common_controls(dbClass* settings) {
+    settings_objects.push_back(settings);
+
     bypass = settings->bypass();
-    input_gain = util::db_to_linear(settings->inputGain());
-    output_gain = util::db_to_linear(settings->outputGain());
-
-    connect(settings, &dbClass::bypassChanged, [&, settings]() { bypass = settings->bypass(); });
-    connect(settings, &dbClass::inputGainChanged,
-            [&, settings]() { input_gain = util::db_to_linear(settings->inputGain()); });
-    connect(settings, &dbClass::outputGainChanged,
-            [&, settings]() { output_gain = util::db_to_linear(settings->outputGain()); });
+    input_gain.reset(util::db_to_linear(settings->inputGain()));
+    output_gain.reset(util::db_to_linear(settings->outputGain()));
+
+    connect(settings, &dbClass::bypassChanged, this, [&, settings]() { bypass = settings->bypass(); });
+    connect(settings, &dbClass::inputGainChanged, this,
+            [&, settings]() { input_gain.set(util::db_to_linear(settings->inputGain())); });
+    connect(settings, &dbClass::outputGainChanged, this,
+            [&, settings]() { output_gain.set(util::db_to_linear(settings->outputGain())); });
   }
 
  private:
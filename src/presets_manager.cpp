@@ -508,20 +508,26 @@ auto Manager::load_preset_file(const PipelineType& pipeline_type, const std::fil
 
   std::vector<std::string> plugins;
 
+  Q_EMIT presetAboutToLoad(pipeline_type);
+
   // Read effects_pipeline
   if (!read_effects_pipeline_from_preset(pipeline_type, input_file, json, plugins)) {
+    Q_EMIT presetLoadFinished(pipeline_type);
+
     return false;
   }
 
   // After the plugin order list, load the blocklist and then
   // apply the parameters of the loaded plugins.
-  if (load_blocklist(pipeline_type, json) && read_plugins_preset(pipeline_type, plugins, json)) {
-    util::debug(std::format("Successfully loaded the preset: {}", input_file.string()));
+  const auto loaded = load_blocklist(pipeline_type, json) && read_plugins_preset(pipeline_type, plugins, json);
 
-    return true;
+  if (loaded) {
+    util::debug(std::format("Successfully loaded the preset: {}", input_file.string()));
   }
 
-  return false;
+  Q_EMIT presetLoadFinished(pipeline_type);
+
+  return loaded;
 }
 
 bool Manager::loadLocalPresetFile(const PipelineType& pipeline_type, const QString& name) {
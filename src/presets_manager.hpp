@@ -110,6 +110,8 @@ class Manager : public QObject {
 
   auto get_local_presets_paths(const PipelineType& pipeline_type) -> QList<std::filesystem::path>;
 
+  auto load_preset_file(const PipelineType& pipeline_type, const std::filesystem::path& input_file) -> bool;
+
   Q_INVOKABLE bool add(const PipelineType& pipeline_type, const QString& name);
 
   Q_INVOKABLE bool savePresetFile(const PipelineType& pipeline_type, const QString& name);
@@ -161,6 +163,10 @@ class Manager : public QObject {
   // signal sending title and description strings
   void presetLoadError(const QString& msg1, const QString& msg2);
 
+  // Emitted before and after the settings of a preset are written.
+  void presetAboutToLoad(PipelineType pipeline_type);
+  void presetLoadFinished(PipelineType pipeline_type);
+
  private:
   DirectoryManager dir_manager;
 
@@ -206,8 +212,6 @@ class Manager : public QObject {
                                    const QString& preset_name = "",
                                    const QString& package_name = "");
 
-  auto load_preset_file(const PipelineType& pipeline_type, const std::filesystem::path& input_file) -> bool;
-
   void notify_error(const PresetError& preset_error, const std::string& plugin_name = "");
 
   static auto create_wrapper(const PipelineType& pipeline_type, const QString& filter_name)
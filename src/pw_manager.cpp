@@ -34,10 +34,12 @@
 #include <pipewire/thread-loop.h>
 #include <pipewire/version.h>
 #include <qmap.h>
+#include <qnamespace.h>
 #include <qobjectdefs.h>
 #include <qqml.h>
 #include <qtmetamacros.h>
 #include <qvariant.h>
+#include <sched.h>
 #include <spa/monitor/device.h>
 #include <spa/param/audio/raw-types.h>
 #include <spa/param/audio/raw.h>
@@ -57,6 +59,7 @@
 #include <spa/utils/result.h>
 #include <spa/utils/type.h>
 #include <sys/types.h>
+#include <QRegularExpression>
 #include <QString>
 #include <chrono>
 #include <cstdint>
@@ -196,6 +199,36 @@ const struct pw_registry_events registry_events = {.version = 0,
                                                    .global = on_registry_global,
                                                    .global_remove = nullptr};
 
+/**
+ * Converts a list like "0,2-3" to the json array "[ 0 2 3 ]" PipeWire expects
+ * in thread.affinity. Invalid entries are ignored.
+ */
+auto cpu_list_to_json(const QString& list) -> std::string {
+  std::string json;
+
+  for (const auto& token : list.split(QRegularExpression("[,\\s]+"), Qt::SkipEmptyParts)) {
+    const auto range = token.split("-");
+
+    bool ok_first = false;
+    bool ok_last = false;
+
+    const auto first = range.front().toUInt(&ok_first);
+    const auto last = (range.size() == 2) ? range.back().toUInt(&ok_last) : first;
+
+    if (!ok_first || range.size() > 2 || (range.size() == 2 && !ok_last) || last < first || last >= CPU_SETSIZE) {
+      util::warning(std::format("Ignoring the invalid cpu list entry: {}", token.toStdString()));
+
+      continue;
+    }
+
+    for (auto cpu = first; cpu <= last; cpu++) {
+      json += std::format(" {}", cpu);
+    }
+  }
+
+  return json.empty() ? std::string{} : std::format("[{} ]", json);
+}
+
 }  // namespace
 
 namespace pw {
@@ -327,6 +360,10 @@ Manager::Manager(QObject* parent)
   pw_properties_set(props_context, PW_KEY_MEDIA_CATEGORY, "Manager");
   pw_properties_set(props_context, PW_KEY_MEDIA_ROLE, "Music");
 
+  if (const auto data_loops = data_loops_config(); !data_loops.empty()) {
+    pw_properties_set(props_context, "context.data-loops", data_loops.c_str());
+  }
+
   context = pw_context_new(pw_thread_loop_get_loop(thread_loop), props_context, 0);
 
   if (context == nullptr) {
@@ -349,6 +386,14 @@ Manager::Manager(QObject* parent)
 
   pw_registry_add_listener(registry, &registry_listener, &registry_events, this);  // NOLINT
 
+  if (offline) {
+    sync_wait_unlock();
+
+    util::debug("offline mode: our virtual devices will not be loaded");
+
+    return;
+  }
+
   if (ee_sink_node.id == SPA_ID_INVALID || ee_source_node.id == SPA_ID_INVALID) {
     auto r = NodeManager::load_virtual_devices(core);
 
@@ -405,8 +450,15 @@ Manager::~Manager() {
 
   metadata_manager.destroy_metadata();
 
-  pw_proxy_destroy(proxy_stream_output_sink);
-  pw_proxy_destroy(proxy_stream_input_source);
+  // They are not created in offline mode
+
+  if (proxy_stream_output_sink != nullptr) {
+    pw_proxy_destroy(proxy_stream_output_sink);
+  }
+
+  if (proxy_stream_input_source != nullptr) {
+    pw_proxy_destroy(proxy_stream_input_source);
+  }
 
   util::debug("Destroying PipeWire registry...");
   pw_proxy_destroy(reinterpret_cast<pw_proxy*>(registry));
@@ -481,6 +533,70 @@ auto Manager::link_nodes(const uint& output_node_id, const uint& input_node_id,
   return link_manager.link_nodes(output_node_id, input_node_id, probe_link);
 }
 
+auto Manager::data_loops_config() -> std::string {
+  /**
+   * Each pipeline may run its filters on a data loop of its own. PipeWire
+   * creates the loops together with the context, so changes only apply after a
+   * restart. Named data loops need PipeWire 1.2.
+   */
+
+  if (util::compare_versions(libraryVersion.toStdString(), "1.2.0") == -1) {
+    if (DbStreamOutputs::dataLoop() || DbStreamInputs::dataLoop()) {
+      util::warning("Dedicated data loops need PipeWire 1.2 or newer. Using the default data loop.");
+    }
+
+    return {};
+  }
+
+  struct LoopSettings {
+    bool enabled;
+    const char* name;
+    QString cpus;
+    int priority;
+    std::string* loop_name;
+  };
+
+  const auto loops = {LoopSettings{DbStreamOutputs::dataLoop(), tags::pipewire::data_loop::output,
+                                   DbStreamOutputs::dataLoopCpus(), DbStreamOutputs::dataLoopPriority(),
+                                   &output_data_loop},
+                      LoopSettings{DbStreamInputs::dataLoop(), tags::pipewire::data_loop::input,
+                                   DbStreamInputs::dataLoopCpus(), DbStreamInputs::dataLoopPriority(),
+                                   &input_data_loop}};
+
+  // Replacing the default list of loops. The first one keeps serving every node that does not ask for a loop.
+
+  std::string config = "[ { loop.name = data-loop.0 loop.class = [ data.rt ] thread.name = data-loop.0 }";
+
+  bool custom_loops = false;
+
+  for (const auto& loop : loops) {
+    if (!loop.enabled) {
+      continue;
+    }
+
+    config += std::format(" {{ loop.name = {0} loop.class = [ data.easyeffects ] thread.name = {0}", loop.name);
+
+    if (const auto affinity = cpu_list_to_json(loop.cpus); !affinity.empty()) {
+      config += std::format(" thread.affinity = {}", affinity);
+    }
+
+    if (loop.priority >= 0) {
+      config += std::format(" loop.rt-prio = {}", loop.priority);
+    }
+
+    config += " }";
+
+    *loop.loop_name = loop.name;
+
+    custom_loops = true;
+
+    util::info(std::format("Creating the data loop {} with cpus '{}' and priority {}", loop.name,
+                           loop.cpus.toStdString(), loop.priority));
+  }
+
+  return custom_loops ? config + " ]" : std::string{};
+}
+
 void Manager::lock() const {
   pw_thread_loop_lock(thread_loop);
 }
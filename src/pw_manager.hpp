@@ -30,6 +30,7 @@
 #include <spa/utils/hook.h>
 #include <sys/types.h>
 #include <cstdint>
+#include <string>
 #include <vector>
 #include "pw_client_manager.hpp"
 #include "pw_device_manager.hpp"
@@ -102,8 +103,14 @@ class Manager : public QObject {
 
   inline static bool exiting = false;
 
+  // Set before the first call to self() when only the plugins are needed. The virtual devices are not created.
+  inline static bool offline = false;
+
   spa_hook metadata_listener{};
 
+  // Data loop used by the filters of each pipeline. Empty when they use the default one.
+  std::string input_data_loop, output_data_loop;
+
   QString defaultInputDeviceName, defaultOutputDeviceName;
 
   NodeInfo ee_sink_node, ee_source_node;
@@ -194,6 +201,8 @@ class Manager : public QObject {
   std::vector<LinkInfo> list_links;
   std::vector<DeviceInfo> list_devices;
 
+  auto data_loops_config() -> std::string;
+
   void set_metadata_target_node(const uint& origin_id, const uint& target_id, const uint64_t& target_serial) const;
 };
 
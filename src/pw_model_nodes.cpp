@@ -208,8 +208,11 @@ QVariant Nodes::data(const QModelIndex& index, int role) const {
       return it->app_process_id;
     case Roles::AppProcessBinary:
       return it->app_process_binary;
-    case Roles::AppIconName:
-      return get_app_icon_name(&(*it));
+    case Roles::AppIconName: {
+      const auto cached = app_icon_names.constFind(it->serial);
+
+      return (cached != app_icon_names.cend()) ? *cached : get_app_icon_name(&(*it));
+    }
     case Roles::MediaIconName:
       return it->media_icon_name;
     case Roles::DeviceIconName:
@@ -330,18 +333,18 @@ bool Nodes::setData(const QModelIndex& index, const QVariant& value, int role) {
   return true;
 }
 
-auto Nodes::get_list() -> QList<NodeInfo> {
+auto Nodes::get_list() const -> const QList<NodeInfo>& {
   return list;
 }
 
 void Nodes::append(NodeInfo info) {
   beginInsertRows(QModelIndex(), list.size(), list.size());
 
+  cache_app_icon_name(info);
+
   list.append(info);
 
   endInsertRows();
-
-  Q_EMIT dataChanged(index(0), index(list.size() - 1));
 }
 
 void Nodes::remove_by_id(const uint& id) {
@@ -363,11 +366,11 @@ void Nodes::remove_by_id(const uint& id) {
 
   beginRemoveRows(QModelIndex(), rowIndex, rowIndex);
 
+  app_icon_names.remove(list[rowIndex].serial);
+
   list.remove(rowIndex);
 
   endRemoveRows();
-
-  Q_EMIT dataChanged(index(0), index(list.size() - 1));
 }
 
 void Nodes::remove_by_serial(const uint& serial) {
@@ -389,11 +392,11 @@ void Nodes::remove_by_serial(const uint& serial) {
 
   beginRemoveRows(QModelIndex(), rowIndex, rowIndex);
 
+  app_icon_names.remove(list[rowIndex].serial);
+
   list.remove(rowIndex);
 
   endRemoveRows();
-
-  Q_EMIT dataChanged(index(0), index(list.size() - 1));
 }
 
 auto Nodes::has_serial(const uint& serial) -> bool {
@@ -408,12 +411,17 @@ void Nodes::update_info(NodeInfo new_info) {
   }
 
   NodeInfo info = list[row];
-  bool anyChanged = false;
+  QList<int> changed_roles;
 
   auto updateIfDifferent = [&](auto role, const auto& oldVal, const auto& newVal) {
     if (oldVal != newVal) {
-      update_field(row, role, newVal);
-      anyChanged = true;
+      set_field(row, role, newVal);
+
+      for (const auto& r : affected_roles(role)) {
+        if (!changed_roles.contains(r)) {
+          changed_roles.append(r);
+        }
+      }
     }
   };
 
@@ -446,6 +454,14 @@ void Nodes::update_info(NodeInfo new_info) {
   updateIfDifferent(Roles::IsBlocklisted, info.is_blocklisted, new_info.is_blocklisted);
   updateIfDifferent(Roles::DeviceRouteName, info.device_route_name, new_info.device_route_name);
   updateIfDifferent(Roles::DeviceRouteDescription, info.device_route_description, new_info.device_route_description);
+
+  // A single notification for the row so the views and the proxy models re-evaluate it only once.
+
+  if (!changed_roles.empty()) {
+    const auto model_index = index(row);
+
+    Q_EMIT dataChanged(model_index, model_index, changed_roles);
+  }
 }
 
 auto Nodes::get_row_by_serial(const uint& serial) -> int {
@@ -473,6 +489,8 @@ void Nodes::reset() {
 
   list.clear();
 
+  app_icon_names.clear();
+
   endResetModel();
 }
 
@@ -535,6 +553,23 @@ auto Nodes::get_app_icon_name(const NodeInfo* node_info) -> QString {
   return icon_name;
 }
 
+auto Nodes::affected_roles(const Roles& role) -> QList<int> {
+  // Description falls back to the name and the application icon is derived from these fields
+
+  switch (role) {
+    case Roles::Name:
+      return {static_cast<int>(role), static_cast<int>(Roles::Description), static_cast<int>(Roles::AppIconName)};
+    case Roles::MediaIconName:
+      return {static_cast<int>(role), static_cast<int>(Roles::AppIconName)};
+    default:
+      return {static_cast<int>(role)};
+  }
+}
+
+void Nodes::cache_app_icon_name(const NodeInfo& node_info) {
+  app_icon_names.insert(node_info.serial, get_app_icon_name(&node_info));
+}
+
 QString Nodes::getNodeName(const uint& rowIndex) {
   if (rowIndex >= list.size()) {
     return "";
@@ -133,7 +133,7 @@ class Nodes : public QAbstractListModel {
 
   void end_reset();
 
-  auto get_list() -> QList<NodeInfo>;
+  [[nodiscard]] auto get_list() const -> const QList<NodeInfo>&;
 
   void append(NodeInfo info);
 
@@ -161,8 +161,51 @@ class Nodes : public QAbstractListModel {
 
   template <typename T>
   void update_field(const int& row, const Roles& role, const T& value) {
+    set_field(row, role, value);
+
     auto model_index = this->index(row);
 
+    Q_EMIT dataChanged(model_index, model_index, affected_roles(role));
+  }
+
+ private:
+  QList<NodeInfo> list;
+
+  /**
+   * Resolved application icon of each node, indexed by the node serial. It
+   * only changes when one of the fields it is derived from changes.
+   */
+  QHash<uint64_t, QString> app_icon_names;
+
+  QSortFilterProxyModel* proxy_input_streams = nullptr;
+  QSortFilterProxyModel* proxy_output_streams = nullptr;
+  QSortFilterProxyModel* proxy_sink_devices = nullptr;
+  QSortFilterProxyModel* proxy_source_devices = nullptr;
+
+  constexpr static auto icon_map =
+      std::to_array<std::pair<const char*, const char*>>({{"chromium-browser", "chromium"},
+                                                          {"firefox", "firefox"},
+                                                          {"nightly", "firefox-nightly"},
+                                                          {"obs", "com.obsproject.Studio"}});
+
+  static auto node_state_to_qstring(const pw_node_state& state) -> QString;
+
+  static auto get_app_icon_name(const NodeInfo* node_info) -> QString;
+
+  static auto affected_roles(const Roles& role) -> QList<int>;
+
+  void cache_app_icon_name(const NodeInfo& node_info);
+
+  void onOutputBlocklistChanged();
+
+  void onInputBlocklistChanged();
+
+  /**
+   * Writes the field without notifying the views. The caller is responsible
+   * for emitting dataChanged with the roles given by affected_roles.
+   */
+  template <typename T>
+  void set_field(const int& row, const Roles& role, const T& value) {
     auto it = std::next(list.begin(), row);
 
     switch (role) {
@@ -373,30 +416,10 @@ class Nodes : public QAbstractListModel {
         break;
     }
 
-    Q_EMIT dataChanged(model_index, model_index, {static_cast<int>(role)});
+    if (role == Roles::Name || role == Roles::AppIconName || role == Roles::MediaIconName) {
+      cache_app_icon_name(*it);
+    }
   }
-
- private:
-  QList<NodeInfo> list;
-
-  QSortFilterProxyModel* proxy_input_streams = nullptr;
-  QSortFilterProxyModel* proxy_output_streams = nullptr;
-  QSortFilterProxyModel* proxy_sink_devices = nullptr;
-  QSortFilterProxyModel* proxy_source_devices = nullptr;
-
-  constexpr static auto icon_map =
-      std::to_array<std::pair<const char*, const char*>>({{"chromium-browser", "chromium"},
-                                                          {"firefox", "firefox"},
-                                                          {"nightly", "firefox-nightly"},
-                                                          {"obs", "com.obsproject.Studio"}});
-
-  static auto node_state_to_qstring(const pw_node_state& state) -> QString;
-
-  static auto get_app_icon_name(const NodeInfo* node_info) -> QString;
-
-  void onOutputBlocklistChanged();
-
-  void onInputBlocklistChanged();
 };
 
 }  // namespace pw::models
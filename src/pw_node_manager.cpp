@@ -150,9 +150,10 @@ auto NodeManager::registerNode(pw_registry* registry, uint32_t id, const char* t
   util::spa_dict_get_string(props, PW_KEY_NODE_NAME, node_name);
 
   // At least for now I do not think there is a point in showing
-  // the spectrum and the output level filters in menus
+  // the spectrum, the output level, the chain fader and the latency capture filters in menus
 
-  if (node_name.contains("output_level") || node_name.contains("spectrum")) {
+  if (node_name.contains("output_level") || node_name.contains("spectrum") || node_name.contains("chain_fader") ||
+      node_name.contains("latency_capture")) {
     return false;
   }
 
@@ -0,0 +1,129 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "ramped_value.hpp"
+#include <sys/types.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include "dsp_kernels.hpp"
+
+RampedValue::RampedValue(const float& value) : target(value), current(value), ramp_target(value) {}
+
+void RampedValue::set(const float& value) {
+  target.store(value, std::memory_order_relaxed);
+}
+
+void RampedValue::reset(const float& value) {
+  target.store(value, std::memory_order_relaxed);
+
+  current = value;
+  ramp_target = value;
+  remaining = 0U;
+}
+
+void RampedValue::set_rate(const uint& rate) {
+  ramp_length = std::max(static_cast<uint>(static_cast<float>(rate) * ramp_time), 1U);
+
+  // A ramp started with the old rate is finished with the same slope
+  remaining = std::min(remaining, ramp_length);
+}
+
+auto RampedValue::value() const -> float {
+  return current;
+}
+
+auto RampedValue::is_ramping() -> bool {
+  update();
+
+  return remaining != 0U;
+}
+
+auto RampedValue::is_unity() -> bool {
+  update();
+
+  return remaining == 0U && current == 1.0F;
+}
+
+void RampedValue::update() {
+  const auto value = target.load(std::memory_order_relaxed);
+
+  if (value == ramp_target) {
+    return;
+  }
+
+  ramp_target = value;
+  remaining = ramp_length;
+  step = (ramp_target - current) / static_cast<float>(ramp_length);
+}
+
+void RampedValue::apply(std::span<float> left, std::span<float> right) {
+  update();
+
+  const auto count = std::min(left.size(), right.size());
+
+  if (remaining == 0U) {
+    if (current != 1.0F) {
+      dsp::apply_gain(left.first(count), current);
+      dsp::apply_gain(right.first(count), current);
+    }
+
+    return;
+  }
+
+  for (size_t n = 0U; n < count; n++) {
+    const auto g = tick();
+
+    left[n] *= g;
+    right[n] *= g;
+  }
+}
+
+void RampedValue::mix(std::span<float> left_out,
+                      std::span<float> right_out,
+                      std::span<const float> left_in,
+                      std::span<const float> right_in,
+                      RampedValue& wet,
+                      RampedValue& dry) {
+  wet.update();
+  dry.update();
+
+  const auto count = std::min({left_out.size(), right_out.size(), left_in.size(), right_in.size()});
+
+  if (wet.remaining == 0U && dry.remaining == 0U) {
+    const auto w = wet.current;
+    const auto d = dry.current;
+
+    for (size_t n = 0U; n < count; n++) {
+      left_out[n] = (w * left_out[n]) + (d * left_in[n]);
+      right_out[n] = (w * right_out[n]) + (d * right_in[n]);
+    }
+
+    return;
+  }
+
+  for (size_t n = 0U; n < count; n++) {
+    const auto w = wet.tick();
+    const auto d = dry.tick();
+
+    left_out[n] = (w * left_out[n]) + (d * left_in[n]);
+    right_out[n] = (w * right_out[n]) + (d * right_in[n]);
+  }
+}
@@ -0,0 +1,92 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+/**
+ * Gain or mix parameter that glides linearly to new values instead of jumping
+ * to them. Any thread may change the target. The realtime thread picks it up
+ * at the start of the next block and spreads the change over ramp_time, so
+ * automating the parameter does not cause zipper noise.
+ */
+class RampedValue {
+ public:
+  explicit RampedValue(const float& value = 1.0F);
+
+  static constexpr float ramp_time = 0.02F;  // seconds
+
+  // Sets the value the parameter will move to. Safe to call from any thread.
+  void set(const float& value);
+
+  // Sets the value without a ramp. Only call it while the realtime thread is not using the parameter.
+  void reset(const float& value);
+
+  // Realtime side. Called when the sampling rate changes.
+  void set_rate(const uint& rate);
+
+  // Value the realtime side is currently at.
+  [[nodiscard]] auto value() const -> float;
+
+  [[nodiscard]] auto is_ramping() -> bool;
+
+  // True when there is no ramp in progress and the value is 1.
+  [[nodiscard]] auto is_unity() -> bool;
+
+  // Multiplies both channels by the parameter. Both channels share the same ramp.
+  void apply(std::span<float> left, std::span<float> right);
+
+  // out = wet * out + dry * in
+  static void mix(std::span<float> left_out,
+                  std::span<float> right_out,
+                  std::span<const float> left_in,
+                  std::span<const float> right_in,
+                  RampedValue& wet,
+                  RampedValue& dry);
+
+ private:
+  std::atomic<float> target;
+
+  // Only touched by the realtime thread
+
+  float current = 1.0F;
+  float ramp_target = 1.0F;
+  float step = 0.0F;
+
+  uint ramp_length = 960U;
+  uint remaining = 0U;
+
+  void update();
+
+  auto tick() -> float {
+    if (remaining > 0U) {
+      current += step;
+
+      if (--remaining == 0U) {
+        current = ramp_target;
+      }
+    }
+
+    return current;
+  }
+};
@@ -36,6 +36,7 @@
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Reverb::Reverb(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -70,6 +71,16 @@ Reverb::Reverb(const std::string& tag, pw::Manager* pipe_manager, PipelineType p
 
   BIND_LV2_PORT_DB("amount", amount, setAmount, DbReverb::amountChanged, true);
   BIND_LV2_PORT_DB("dry", dry, setDry, DbReverb::dryChanged, true);
+
+  // After twice the decay time the reverberation is 120 dB below its initial level
+  const auto update_tail = [this] {
+    tail_seconds = static_cast<float>((settings->predelay() * 0.001) + (2.0 * settings->decayTime()));
+  };
+
+  update_tail();
+
+  connect(settings, &DbReverb::predelayChanged, this, update_tail);
+  connect(settings, &DbReverb::decayTimeChanged, this, update_tail);
 }
 
 Reverb::~Reverb() {
@@ -79,7 +90,7 @@ Reverb::~Reverb() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -120,20 +131,18 @@ void Reverb::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Reverb::process(std::span<float>& left_in,
@@ -153,27 +162,17 @@ void Reverb::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void Reverb::process([[maybe_unused]] std::span<float>& left_in,
@@ -26,6 +26,7 @@
 #include <format>
 #include "easyeffects_db_rnnoise.h"
 #include "pipeline_type.hpp"
+#include "rt_log.hpp"
 #include "tags_app.hpp"
 #ifdef ENABLE_RNNOISE
 #include <rnnoise.h>
@@ -36,12 +37,14 @@
 #include <mutex>
 #include <span>
 #include <string>
+#include "async_processor.hpp"
 #include "db_manager.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "resampler.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 RNNoise::RNNoise(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -84,16 +87,30 @@ RNNoise::RNNoise(const std::string& tag, pw::Manager* pipe_manager, PipelineType
   wet_ratio =
       (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
 
-  connect(settings, &DbRNNoise::useStandardModelChanged, [&]() { prepare_model(); });
+  connect(settings, &DbRNNoise::useStandardModelChanged, this, [&]() { prepare_model(); });
 
-  connect(settings, &DbRNNoise::modelNameChanged, [&]() { prepare_model(); });
+  connect(settings, &DbRNNoise::modelNameChanged, this, [&]() { prepare_model(); });
 
-  connect(settings, &DbRNNoise::wetChanged, [&]() {
+  connect(settings, &DbRNNoise::wetChanged, this, [&]() {
     wet_ratio =
         (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
   });
 
-  connect(settings, &DbRNNoise::releaseChanged, [&]() { init_release(); });
+  connect(settings, &DbRNNoise::releaseChanged, this, [&]() { init_release(); });
+
+  async_enabled = settings->asyncProcessing();
+  async_latency_blocks = static_cast<uint>(settings->asyncLatency());
+
+  auto restart_async = [&]() {
+    async_enabled = settings->asyncProcessing();
+    async_latency_blocks = static_cast<uint>(settings->asyncLatency());
+
+    WorkerPool::post(baseWorker, [this] { update_async(); });
+  };
+
+  connect(settings, &DbRNNoise::asyncProcessingChanged, this, restart_async);
+
+  connect(settings, &DbRNNoise::asyncLatencyChanged, this, restart_async);
 
   auto* m = get_model_from_name();
 
@@ -120,13 +137,15 @@ RNNoise::RNNoise(const std::string& tag, pw::Manager* pipe_manager, PipelineType
 }
 
 RNNoise::~RNNoise() {
+  async.stop();
+
   stop_worker();
 
   if (connected_to_pw) {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   std::scoped_lock<std::mutex> lock(data_mutex);
 
@@ -153,27 +172,47 @@ void RNNoise::setup() {
     return;
   }
 
-  std::scoped_lock<std::mutex> lock(data_mutex);
+  WorkerPool::post(
+      baseWorker,
+      [this] {
+        {
+          // The separate thread may still be running the model. The realtime thread does not wait for it.
+          const auto paused = async.pause();
 
-  resampler_ready = false;
+          resampler_ready = false;
 
-  latency_n_frames = 0U;
+          latency_n_frames = 0U;
 
-  resample = rate != rnnoise_rate;
+          resample = rate != rnnoise_rate;
 
-  data_L.clear();
-  data_R.clear();
+          data_L.clear();
+          data_R.clear();
 
-  buf_out_L.clear();
-  buf_out_R.clear();
+          buf_out_L.clear();
+          buf_out_R.clear();
 
-  resampler_inL = std::make_unique<Resampler>(rate, rnnoise_rate);
-  resampler_inR = std::make_unique<Resampler>(rate, rnnoise_rate);
+          resampler_inL = std::make_unique<Resampler>(rate, rnnoise_rate);
+          resampler_inR = std::make_unique<Resampler>(rate, rnnoise_rate);
 
-  resampler_outL = std::make_unique<Resampler>(rnnoise_rate, rate);
-  resampler_outR = std::make_unique<Resampler>(rnnoise_rate, rate);
+          resampler_outL = std::make_unique<Resampler>(rnnoise_rate, rate);
+          resampler_outR = std::make_unique<Resampler>(rnnoise_rate, rate);
 
-  resampler_ready = true;
+          resampler_ready = true;
+        }
+
+        // The separate thread has to be restarted with the new block size
+        if (async_enabled || async.running()) {
+          update_async();
+        }
+      },
+      WorkerPool::Priority::high);
+}
+
+void RNNoise::quantum_changed() {
+  // The resamplers and the model take any number of frames. Only the separate thread works on fixed blocks.
+  if (async_enabled || async.running()) {
+    WorkerPool::post(baseWorker, [this] { update_async(); });
+  }
 }
 
 void RNNoise::process(std::span<float>& left_in,
@@ -190,12 +229,7 @@ void RNNoise::process(std::span<float>& left_in,
   }
 
 #ifdef ENABLE_RNNOISE
-  constexpr auto eps = 1e-6F;
-
-  auto empty = std::ranges::all_of(left_in, [&](float v) { return std::fabs(v) <= eps; }) &&
-               std::ranges::all_of(right_in, [&](float v) { return std::fabs(v) <= eps; });
-
-  if (!rnnoise_ready || empty) {
+  if (!rnnoise_ready) {
     std::ranges::fill(left_out, 0.0F);
     std::ranges::fill(right_out, 0.0F);
 
@@ -208,8 +242,50 @@ void RNNoise::process(std::span<float>& left_in,
   return;
 #endif
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
+  apply_input_gain(left_in, right_in);
+
+  if (async_restarting) {
+    std::ranges::copy(left_in, left_out.begin());
+    std::ranges::copy(right_in, right_out.begin());
+  } else if (async.running()) {
+    async.process(left_in, right_in, left_out, right_out);
+  } else if (const auto paused = async.try_pause(); paused.owns_lock()) {
+    denoise(left_in, right_in, left_out, right_out);
+  } else {
+    // The model is being replaced. We do not wait for it in the realtime thread.
+    std::ranges::copy(left_in, left_out.begin());
+    std::ranges::copy(right_in, right_out.begin());
+  }
+
+  apply_gain(left_out, right_out, output_gain);
+
+  if (notify_latency.exchange(false)) {
+    latency_value = static_cast<float>(latency_n_frames + async.latency_frames()) / static_cast<float>(rate);
+
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
+
+    update_filter_params();
+  }
+
+  if (updateLevelMeters) {
+    get_peaks(left_in, right_in, left_out, right_out);
+  }
+}
+
+void RNNoise::denoise(std::span<float> left_in,
+                      std::span<float> right_in,
+                      std::span<float> left_out,
+                      std::span<float> right_out) {
+  constexpr auto eps = 1e-6F;
+
+  auto empty = std::ranges::all_of(left_in, [&](float v) { return std::fabs(v) <= eps; }) &&
+               std::ranges::all_of(right_in, [&](float v) { return std::fabs(v) <= eps; });
+
+  if (empty) {
+    std::ranges::fill(left_out, 0.0F);
+    std::ranges::fill(right_out, 0.0F);
+
+    return;
   }
 
   if (resample) {
@@ -239,7 +315,7 @@ void RNNoise::process(std::span<float>& left_in,
 #endif
   }
 
-  if (buf_out_L.size() >= n_samples) {
+  if (buf_out_L.size() >= left_out.size()) {
     util::copy_bulk(buf_out_L, left_out);
     util::copy_bulk(buf_out_R, right_out);
   } else {
@@ -261,24 +337,33 @@ void RNNoise::process(std::span<float>& left_in,
     buf_out_L.clear();
     buf_out_R.clear();
   }
+}
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
+void RNNoise::update_async() {
+  if (rate == 0 || n_samples == 0) {
+    return;
   }
 
-  if (notify_latency) {
-    latency_value = static_cast<float>(latency_n_frames) / static_cast<float>(rate);
+  // The realtime thread sees the flag in its next cycle. Locking data_mutex waits for the cycle being processed.
 
-    util::debug(std::format("{} latency: {} s", log_tag + name.toStdString(), latency_value));
+  async_restarting = true;
 
-    update_filter_params();
-
-    notify_latency = false;
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
   }
 
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
+  async.stop();
+
+  // The offline renderer calls process() faster than realtime. The backend would not keep up.
+  if (async_enabled && !pw::Manager::offline) {
+    async.start(n_samples, async_latency_blocks,
+                [this](std::span<float> left_in, std::span<float> right_in, std::span<float> left_out,
+                       std::span<float> right_out) { denoise(left_in, right_in, left_out, right_out); });
   }
+
+  async_restarting = false;
+
+  notify_latency = true;
 }
 
 void RNNoise::process([[maybe_unused]] std::span<float>& left_in,
@@ -397,6 +482,9 @@ void RNNoise::prepare_model() {
 
   data_mutex.unlock();
 
+  // The separate thread must not use the states while they are replaced
+  const auto paused = async.pause();
+
   free_rnnoise();
 
   auto* m = get_model_from_name();
@@ -440,6 +528,10 @@ auto RNNoise::get_latency_seconds() -> float {
   return latency_value;
 }
 
+auto RNNoise::get_tail_seconds() -> float {
+  return 0.0F;
+}
+
 void RNNoise::init_release() {
 #ifdef ENABLE_RNNOISE
 
@@ -24,6 +24,7 @@
 #include <sys/types.h>
 #include <QString>
 #include <algorithm>
+#include <atomic>
 #include <climits>
 #include <cstddef>
 #include <cstdio>
@@ -31,6 +32,8 @@
 #include <span>
 #include <string>
 #include <vector>
+#include "async_processor.hpp"
+#include "dsp_kernels.hpp"
 #include "easyeffects_db_rnnoise.h"
 #include "pipeline_type.hpp"
 #include "pw_manager.hpp"
@@ -62,6 +65,8 @@ class RNNoise : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
@@ -76,6 +81,8 @@ class RNNoise : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto get_tail_seconds() -> float override;
+
   void init_release();
 
   auto search_model_path(const std::string& name) -> std::string;
@@ -97,13 +104,15 @@ class RNNoise : public PluginBase {
   std::vector<std::string> system_data_dir_rnnoise;
 
   bool resample = false;
-  bool notify_latency = false;
   bool rnnoise_ready = false;
   bool resampler_ready = false;
 
+  std::atomic<bool> notify_latency = false;
+
   uint blocksize = 480U;
   uint rnnoise_rate = 48000U;
-  uint latency_n_frames = 0U;
+
+  std::atomic<uint> latency_n_frames = 0U;
 
   float wet_ratio = 1.0F;
   uint release = 2U;
@@ -118,6 +127,26 @@ class RNNoise : public PluginBase {
   std::unique_ptr<Resampler> resampler_inL, resampler_outL;
   std::unique_ptr<Resampler> resampler_inR, resampler_outR;
 
+  AsyncProcessor async{"rnnoise"};
+
+  // Copies of the settings for the worker and the realtime threads
+  std::atomic<bool> async_enabled = false;
+  std::atomic<uint> async_latency_blocks = 0U;
+
+  std::atomic<bool> async_restarting = false;
+
+  void denoise(std::span<float> left_in,
+               std::span<float> right_in,
+               std::span<float> left_out,
+               std::span<float> right_out);
+
+  /**
+   * Restarts the separate thread with the current block size. The realtime
+   * thread passes the audio through while it happens, so data_mutex is not
+   * held while the backend finishes its last block.
+   */
+  void update_async();
+
 #ifdef ENABLE_RNNOISE
 
   FILE* model_file = nullptr;
@@ -142,7 +171,7 @@ class RNNoise : public PluginBase {
 
       if (data_L.size() == blocksize) {
         if (state_left != nullptr) {
-          std::ranges::for_each(data_L, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
+          dsp::apply_gain(data_L, static_cast<float>(SHRT_MAX + 1));
 
           data_tmp = data_L;
 
@@ -184,7 +213,7 @@ class RNNoise : public PluginBase {
 
       if (data_R.size() == blocksize) {
         if (state_right != nullptr) {
-          std::ranges::for_each(data_R, [](auto& v) { v *= static_cast<float>(SHRT_MAX + 1); });
+          dsp::apply_gain(data_R, static_cast<float>(SHRT_MAX + 1));
 
           data_tmp = data_R;
 
@@ -0,0 +1,114 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "rt_log.hpp"
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "util.hpp"
+
+namespace util {
+
+RtLog::RtLog() {
+  for (uint64_t n = 0U; n < capacity; n++) {
+    records[n].sequence.store(n, std::memory_order_relaxed);
+  }
+
+  thread = std::thread([this]() {
+    while (!quit.load(std::memory_order_relaxed)) {
+      std::this_thread::sleep_for(drain_interval);
+
+      drain();
+    }
+  });
+}
+
+RtLog::~RtLog() {
+  quit.store(true);
+
+  if (thread.joinable()) {
+    thread.join();
+  }
+
+  drain();
+}
+
+auto RtLog::self() -> RtLog& {
+  static RtLog rt_log;
+
+  return rt_log;
+}
+
+auto RtLog::dropped_messages() const -> uint64_t {
+  return dropped.load(std::memory_order_relaxed);
+}
+
+void RtLog::flush() {
+  drain();
+}
+
+void RtLog::drain() {
+  std::scoped_lock<std::mutex> lock(drain_mutex);
+
+  while (true) {
+    auto& record = records[read_count & (capacity - 1U)];
+
+    if (record.sequence.load(std::memory_order_acquire) != read_count + 1U) {
+      break;
+    }
+
+    const std::string msg(record.message.data(), record.length);
+
+    const auto level = record.level;
+    const auto location = record.location;
+
+    // The slot can be reused by the producers once it was copied
+
+    record.sequence.store(read_count + capacity, std::memory_order_release);
+
+    read_count++;
+
+    switch (level) {
+      case Level::debug:
+        util::debug(msg, location);
+        break;
+      case Level::info:
+        util::info(msg, location);
+        break;
+      case Level::warning:
+        util::warning(msg, location);
+        break;
+      case Level::critical:
+        util::critical(msg, location);
+        break;
+    }
+  }
+
+  if (const auto n_dropped = dropped.load(std::memory_order_relaxed); n_dropped != reported_dropped) {
+    util::warning(std::format("{} realtime log messages were dropped because the queue was full",
+                              n_dropped - reported_dropped));
+
+    reported_dropped = n_dropped;
+  }
+}
+
+}  // namespace util
@@ -0,0 +1,173 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "util.hpp"
+
+namespace util {
+
+/**
+ * Logging that is safe to use in the realtime threads. The message is formatted
+ * into a fixed size record that is pushed to a bounded lock-free queue. A normal
+ * priority thread drains the queue and hands the messages to the regular
+ * logging functions. Nothing is allocated and no lock is taken by the
+ * producers. When the queue is full the message is dropped and counted.
+ */
+class RtLog {
+ public:
+  enum class Level { debug, info, warning, critical };
+
+  RtLog(const RtLog&) = delete;
+  auto operator=(const RtLog&) -> RtLog& = delete;
+  RtLog(const RtLog&&) = delete;
+  auto operator=(const RtLog&&) -> RtLog& = delete;
+  ~RtLog();
+
+  static auto self() -> RtLog&;
+
+  // Realtime safe
+  template <typename... Args>
+  void push(const Level& level,
+            const source_location& location,
+            std::format_string<Args...> fmt,
+            Args&&... args) {
+    auto pos = write_count.load(std::memory_order_relaxed);
+
+    Record* record = nullptr;
+
+    while (record == nullptr) {
+      auto& slot = records[pos & (capacity - 1U)];
+
+      const auto seq = slot.sequence.load(std::memory_order_acquire);
+
+      const auto diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+      if (diff == 0) {
+        if (write_count.compare_exchange_weak(pos, pos + 1U, std::memory_order_relaxed)) {
+          record = &slot;
+        }
+      } else if (diff < 0) {
+        dropped.fetch_add(1U, std::memory_order_relaxed);
+
+        return;
+      } else {
+        pos = write_count.load(std::memory_order_relaxed);
+      }
+    }
+
+    record->level = level;
+    record->location = location;
+
+    const auto result =
+        std::format_to_n(record->message.data(), record->message.size() - 1U, fmt, std::forward<Args>(args)...);
+
+    record->length = static_cast<uint>(std::min<std::ptrdiff_t>(result.size, record->message.size() - 1U));
+
+    record->sequence.store(pos + 1U, std::memory_order_release);
+  }
+
+  [[nodiscard]] auto dropped_messages() const -> uint64_t;
+
+  // Not realtime safe. Logs everything that is still queued.
+  void flush();
+
+ private:
+  RtLog();
+
+  struct Record {
+    std::atomic<uint64_t> sequence = 0U;
+
+    Level level = Level::debug;
+
+    source_location location;
+
+    uint length = 0U;
+
+    std::array<char, 256> message{};
+  };
+
+  static constexpr uint64_t capacity = 256U;  // it has to be a power of 2
+
+  static constexpr auto drain_interval = std::chrono::milliseconds(100);
+
+  std::array<Record, capacity> records;
+
+  std::atomic<uint64_t> write_count = 0U;
+  std::atomic<uint64_t> dropped = 0U;
+  std::atomic<bool> quit = false;
+
+  uint64_t read_count = 0U;
+  uint64_t reported_dropped = 0U;
+
+  std::mutex drain_mutex;
+
+  std::thread thread;
+
+  void drain();
+};
+
+/**
+ * Wraps the format string so the source location can be captured by the
+ * variadic logging functions below.
+ */
+template <typename... Args>
+struct rt_format_string {
+  std::format_string<Args...> fmt;
+
+  source_location location;
+
+  template <typename S>
+  consteval rt_format_string(const S& s, source_location loc = source_location::current())  // NOLINT
+      : fmt(s), location(loc) {}
+};
+
+template <typename... Args>
+void rt_debug(rt_format_string<std::type_identity_t<Args>...> fmt, Args&&... args) {
+  RtLog::self().push(RtLog::Level::debug, fmt.location, fmt.fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+void rt_info(rt_format_string<std::type_identity_t<Args>...> fmt, Args&&... args) {
+  RtLog::self().push(RtLog::Level::info, fmt.location, fmt.fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+void rt_warning(rt_format_string<std::type_identity_t<Args>...> fmt, Args&&... args) {
+  RtLog::self().push(RtLog::Level::warning, fmt.location, fmt.fmt, std::forward<Args>(args)...);
+}
+
+template <typename... Args>
+void rt_critical(rt_format_string<std::type_identity_t<Args>...> fmt, Args&&... args) {
+  RtLog::self().push(RtLog::Level::critical, fmt.location, fmt.fmt, std::forward<Args>(args)...);
+}
+
+}  // namespace util
@@ -0,0 +1,151 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "signal_generators.hpp"
+#include <sys/types.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include "dsp_kernels.hpp"
+
+namespace dsp {
+
+NoiseGenerator::NoiseGenerator(const uint32_t& initial_seed) : seed(initial_seed) {}
+
+void NoiseGenerator::reset() {
+  counter = 0U;
+
+  b0 = b1 = b2 = 0.0F;
+}
+
+void NoiseGenerator::uniform(std::span<float> output) {
+  uniform_noise(output, seed, counter);
+
+  counter += static_cast<uint32_t>(output.size());
+}
+
+void NoiseGenerator::gaussian(std::span<float> output, const float& sigma) {
+  gaussian_noise(output, seed, counter, sigma);
+
+  counter += static_cast<uint32_t>(output.size());
+}
+
+void NoiseGenerator::pink(std::span<float> output) {
+  gaussian(output, 0.3F);
+
+  // reference: https://www.firstpr.com.au/dsp/pink-noise/
+  // The filter is recursive. Only the white noise generation is vectorized.
+
+  for (auto& v : output) {
+    const auto white = v;
+
+    b0 = (0.99765F * b0) + (white * 0.0990460F);
+    b1 = (0.96300F * b1) + (white * 0.2965164F);
+    b2 = (0.57000F * b2) + (white * 1.0526913F);
+
+    const auto pink = b0 + b1 + b2 + (white * 0.1848F);
+
+    v = std::clamp(pink * 0.05F, -1.0F, 1.0F);
+  }
+}
+
+void SineOscillator::set_frequency(const double& frequency, const uint& rate) {
+  increment = (rate > 0U) ? frequency / static_cast<double>(rate) : 0.0;
+}
+
+void SineOscillator::reset() {
+  phase = 0.0;
+}
+
+void SineOscillator::process(std::span<float> output, const float& amplitude) {
+  std::array<float, oscillator_chunk> cycles{};
+
+  for (size_t offset = 0U; offset < output.size(); offset += oscillator_chunk) {
+    const auto count = std::min(oscillator_chunk, output.size() - offset);
+
+    for (size_t j = 0U; j < count; j++) {
+      const auto c = phase + (static_cast<double>(j) * increment);
+
+      cycles[j] = static_cast<float>(c - static_cast<double>(static_cast<int64_t>(c)));
+    }
+
+    sine(std::span(cycles).first(count), output.subspan(offset, count), amplitude);
+
+    phase += static_cast<double>(count) * increment;
+
+    phase -= std::floor(phase);
+  }
+}
+
+void SweepOscillator::setup(const uint& rate, const double& duration, const double& f_start, const double& f_end) {
+  const auto log_ratio = std::log(f_end / f_start);
+
+  n_frames = static_cast<size_t>(duration * static_cast<double>(rate));
+
+  k = f_start * duration / log_ratio;
+  l = duration * static_cast<double>(rate) / log_ratio;
+
+  for (size_t j = 0U; j < oscillator_chunk; j++) {
+    growth[j] = std::exp(static_cast<double>(j) / l);
+  }
+
+  position = 0U;
+}
+
+void SweepOscillator::reset() {
+  position = 0U;
+}
+
+auto SweepOscillator::length() const -> size_t {
+  return n_frames;
+}
+
+auto SweepOscillator::finished() const -> bool {
+  return position >= n_frames;
+}
+
+void SweepOscillator::process(std::span<float> output, const float& amplitude) {
+  std::array<float, oscillator_chunk> cycles{};
+
+  size_t offset = 0U;
+
+  while (offset < output.size() && position < n_frames) {
+    const auto count = std::min({oscillator_chunk, output.size() - offset, n_frames - position});
+
+    const auto chunk_start = std::exp(static_cast<double>(position) / l);
+
+    for (size_t j = 0U; j < count; j++) {
+      const auto c = k * ((chunk_start * growth[j]) - 1.0);
+
+      cycles[j] = static_cast<float>(c - static_cast<double>(static_cast<int64_t>(c)));
+    }
+
+    sine(std::span(cycles).first(count), output.subspan(offset, count), amplitude);
+
+    offset += count;
+    position += count;
+  }
+
+  std::fill(output.begin() + static_cast<std::ptrdiff_t>(offset), output.end(), 0.0F);
+}
+
+}  // namespace dsp
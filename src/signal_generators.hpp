@@ -0,0 +1,102 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * Block generators for test and measurement signals. They fill whole buffers
+ * with the vectorized kernels of dsp_kernels.hpp and are realtime safe.
+ */
+
+namespace dsp {
+
+// The oscillators compute their phases in chunks of this many samples
+inline constexpr size_t oscillator_chunk = 64U;
+
+class NoiseGenerator {
+ public:
+  explicit NoiseGenerator(const uint32_t& initial_seed = 0x9e3779b9U);
+
+  void reset();
+
+  // Uniform white noise in [-1, 1)
+  void uniform(std::span<float> output);
+
+  // Normal white noise with the given standard deviation, clipped to [-1, 1]
+  void gaussian(std::span<float> output, const float& sigma);
+
+  // Pink noise made by filtering normal white noise
+  void pink(std::span<float> output);
+
+ private:
+  uint32_t seed = 0U;
+  uint32_t counter = 0U;
+
+  float b0 = 0.0F, b1 = 0.0F, b2 = 0.0F;
+};
+
+class SineOscillator {
+ public:
+  void set_frequency(const double& frequency, const uint& rate);
+
+  void reset();
+
+  void process(std::span<float> output, const float& amplitude);
+
+ private:
+  double phase = 0.0;      // cycles in [0, 1)
+  double increment = 0.0;  // cycles per sample
+};
+
+/**
+ * Exponential sine sweep as described by Angelo Farina in "Simultaneous
+ * measurement of impulse response and distortion with a swept-sine technique".
+ * Silence is written once the sweep is over.
+ */
+class SweepOscillator {
+ public:
+  void setup(const uint& rate, const double& duration, const double& f_start, const double& f_end);
+
+  void reset();
+
+  [[nodiscard]] auto length() const -> size_t;
+
+  [[nodiscard]] auto finished() const -> bool;
+
+  void process(std::span<float> output, const float& amplitude);
+
+ private:
+  size_t n_frames = 0U;
+  size_t position = 0U;
+
+  // The phase at frame n is k * (exp(n / l) - 1) cycles
+  double k = 0.0;
+  double l = 1.0;
+
+  // exp(j / l) for each position j of a chunk
+  std::array<double, oscillator_chunk> growth{};
+};
+
+}  // namespace dsp
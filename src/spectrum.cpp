@@ -18,8 +18,6 @@
  */
 
 #include "spectrum.hpp"
-#include <fftw3.h>
-#include <qlist.h>
 #include <qnamespace.h>
 #include <qobjectdefs.h>
 #include <qtypes.h>
@@ -27,44 +25,30 @@
 #include <QString>
 #include <algorithm>
 #include <cassert>
-#include <cmath>
 #include <cstddef>
-#include <cstring>
 #include <format>
 #include <memory>
 #include <mutex>
-#include <numbers>
 #include <span>
 #include <string>
 #include <tuple>
+#include <vector>
+#include "dsp_kernels.hpp"
 #include "easyeffects_db_spectrum.h"
 #include "lv2_macros.hpp"
 #include "lv2_wrapper.hpp"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "spectrum_analyzer.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Spectrum::Spectrum(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag, "spectrum", tags::plugin_package::Package::ee, instance_id, pipe_manager, pipe_type),
       settings(DbSpectrum::self()) {
   bypass = !DbSpectrum::state();
-  // Precompute the Hann window, which is an expensive operation.
-  // https://en.wikipedia.org/wiki/Hann_function
-  for (size_t n = 0; n < n_bands; n++) {
-    hann_window[n] =
-        0.5F *
-        (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) / static_cast<float>(n_bands - 1)));
-  }
-
-  complex_output = fftwf_alloc_complex(output.size());
-
-  plan = fftwf_plan_dft_r2c_1d(static_cast<int>(n_bands), real_input.data(), complex_output, FFTW_ESTIMATE);
-
-  if (plan != nullptr && complex_output != nullptr) {
-    fftw_ready = true;
-  }
 
   const auto lv2_plugin_uri = "http://lsp-plug.in/plugins/lv2/comp_delay_x2_stereo";
 
@@ -89,7 +73,15 @@ Spectrum::Spectrum(const std::string& tag, pw::Manager* pipe_manager, PipelineTy
   BIND_LV2_PORT("time_l", avsyncDelay, setAvsyncDelay, DbSpectrum::avsyncDelayChanged);
   BIND_LV2_PORT("time_r", avsyncDelay, setAvsyncDelay, DbSpectrum::avsyncDelayChanged);
 
-  connect(DbSpectrum::self(), &DbSpectrum::stateChanged, [&]() { bypass = !DbSpectrum::state(); });
+  connect(DbSpectrum::self(), &DbSpectrum::stateChanged, this, [&]() { bypass = !DbSpectrum::state(); });
+
+  mono.resize(max_quantum, 0.0F);
+
+  left_delayed_vector.resize(max_quantum, 0.0F);
+  right_delayed_vector.resize(max_quantum, 0.0F);
+
+  left_delayed = std::span<float>(left_delayed_vector);
+  right_delayed = std::span<float>(right_delayed_vector);
 }
 
 Spectrum::~Spectrum() {
@@ -101,15 +93,7 @@ Spectrum::~Spectrum() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
-
-  fftw_ready = false;
-
-  if (complex_output != nullptr) {
-    fftwf_free(complex_output);
-  }
-
-  fftwf_destroy_plan(plan);
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -138,29 +122,17 @@ void Spectrum::setup() {
 
   std::scoped_lock<std::mutex> lock(data_mutex);
 
-  bin_hz = static_cast<float>(rate) / n_bands;
-
-  std::ranges::fill(real_input, 0.0F);
-  std::ranges::fill(latest_samples_mono, 0.0F);
-
   if (!lv2_wrapper->found_plugin) {
     ready = true;  // THe spectrum works without the delay compensation
 
     return;
   }
 
-  left_delayed_vector.resize(n_samples, 0.0F);
-  right_delayed_vector.resize(n_samples, 0.0F);
-
-  left_delayed = std::span<float>(left_delayed_vector);
-  right_delayed = std::span<float>(right_delayed_vector);
-
   lv2_wrapper->set_n_samples(n_samples);
 
   ready = false;
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
         util::debug(std::format("{} creating instance of comp delay x2 stereo for spectrum A/V sync", log_tag));
@@ -171,8 +143,12 @@ void Spectrum::setup() {
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
+}
+
+void Spectrum::quantum_changed() {
+  // The delay compensation instance takes any block size up to the maximum quantum
+  lv2_wrapper->set_n_samples(n_samples);
 }
 
 void Spectrum::process(std::span<float>& left_in,
@@ -182,10 +158,12 @@ void Spectrum::process(std::span<float>& left_in,
   std::ranges::copy(left_in, left_out.begin());
   std::ranges::copy(right_in, right_out.begin());
 
-  if (bypass || !fftw_ready || !ready) {
+  if (bypass || !ready) {
     return;
   }
 
+  auto mono_span = std::span(mono).first(n_samples);
+
   /**
    * delay the visualization of the spectrum by the reported latency of the
    * output device, so that the spectrum is visually in sync with the audio
@@ -195,145 +173,52 @@ void Spectrum::process(std::span<float>& left_in,
     lv2_wrapper->connect_data_ports(left_in, right_in, left_delayed, right_delayed);
     lv2_wrapper->run();
 
-    // Downmix the latest n_bands samples from the delayed signal.
-    if (n_samples < n_bands) {
-      // Drop the oldest quantum.
-      std::memmove(latest_samples_mono.data(), &latest_samples_mono[n_samples], (n_bands - n_samples) * sizeof(float));
-
-      // Copy the new quantum.
-      for (size_t n = 0; n < n_samples; n++) {
-        latest_samples_mono[n_bands - n_samples + n] = 0.5F * (left_delayed[n] + right_delayed[n]);
-      }
-    } else {
-      // Copy the latest n_bands samples.
-      for (size_t n = 0; n < n_bands; n++) {
-        latest_samples_mono[n] =
-            0.5F * (left_delayed[n_samples - n_bands + n] + right_delayed[n_samples - n_bands + n]);
-      }
-    }
+    dsp::downmix(left_delayed.first(n_samples), right_delayed.first(n_samples), mono_span);
   } else {
-    // Downmix the latest n_bands samples from the non-delayed signal.
-    if (n_samples < n_bands) {
-      // Drop the oldest quantum.
-      std::memmove(latest_samples_mono.data(), &latest_samples_mono[n_samples], (n_bands - n_samples) * sizeof(float));
-
-      // Copy the new quantum.
-      for (size_t n = 0; n < n_samples; n++) {
-        latest_samples_mono[n_bands - n_samples + n] = 0.5F * (left_in[n] + right_in[n]);
-      }
-    } else {
-      // Copy the latest n_bands samples.
-      for (size_t n = 0; n < n_bands; n++) {
-        latest_samples_mono[n] = 0.5F * (left_in[n_samples - n_bands + n] + right_in[n_samples - n_bands + n]);
-      }
-    }
+    dsp::downmix(left_in.first(n_samples), right_in.first(n_samples), mono_span);
   }
 
   /**
-   * OK, we have the latest_samples_mono array that contains n_bands samples. We
-   * want to export it to the GUI thread. We don't wakeup the GUI thread from
-   * realtime, we only want to update the buffer and let the GUI thread follow
-   * its scheduling and have access to our new buffer. We accept losing old
-   * data.
-   *
-   * For that, we want to synchronise both threads. Realtime shouldn't have to
-   * wait (ie loop or syscall). It is fine if GUI waits a little.
-   *
-   * The overall concept is to use two buffers. When realtime comes in, it
-   * writes into one. When GUI arrives, it waits for realtime to be done
-   * writing (if it is busy) and it switches the active buffer to become the
-   * other one. As GUI is the one doing the toggle, it knows it can read at its
-   * pace the inactive buffer. Realtime will always have a buffer to write
-   * into, and it is fine if it overwrites data.
-   *
-   * We use an atomic integer (db_control) that contains three bits:
-   *  - DB_BIT_IDX: the current buffer index.
-   *  - DB_BIT_NEWDATA: indicates if realtime wrote new data.
-   *  - DB_BIT_BUSY: indicates if realtime is currently busy writing data.
-   *
-   * Realtime does this:
-   *  - Grab db_control and enable its BUSY bit.
-   *  - Write data into the correct buffer based on the IDX bit.
-   *  - Write db_control with same index as before, BUSY bit disabled and
-   *    NEWDATA bit enabled.
-   *
-   * GUI does this:
-   *  - Early return if NEWDATA is not enabled. It means realtime hasn't ran
-   *    since the last time GUI ran.
-   *  - Then it tries toggling the IDX bit. "Tries" because the operation fails
-   *    as long as the BUSY bit is active.
-   *  - From now on it can read the previous buffer knowing realtime cannot be
-   *    writing into it.
-   *
-   * This is single-producer single-consumer double-buffering. The
-   * implementation is inspired from the "Real-time 101" ADC19 talk
-   * (David Rowland & Fabian Renn-Giles).
-   *
-   * Talk part 1 & 2, slides (page 74 onwards) and illustrating library:
-   * https://www.youtube.com/watch?v=Q0vrQFyAdWI
-   * https://www.youtube.com/watch?v=PoZAo2Vikbo
-   * https://github.com/drowaudio/presentations/blob/master/ADC%202019%20-%20Real-time%20101/Real-time%20101.pdf
-   * https://github.com/hogliux/farbot
+   * The analyzer only appends the quantum to its ring buffer here. The FFT
+   * frames are computed in the thread that reads the spectrum, at the pace
+   * the GUI asks for it. We never wake it up from realtime.
    */
 
-  // Grab the current index AND mark as busy at the same time.
-  int index = db_control.fetch_or(static_cast<int>(DB_BIT::BUSY)) & static_cast<int>(DB_BIT::IDX);
-
-  // Fill the buffer.
-  db_buffers[index] = latest_samples_mono;
-
-  // Mark new data available AND mark as not busy anymore.
-  db_control.store(index | static_cast<int>(DB_BIT::NEWDATA));
+  analyzer.write(mono_span);
 }
 
-auto Spectrum::compute_magnitudes() -> std::tuple<uint, float, QList<double>> {
-  std::scoped_lock<std::mutex> lock(data_mutex);
-
-  // Early return if no new data is available, ie if process() has not been
-  // called since our last compute_magnitudes() call.
-  int curr_control = db_control.load();
-  if (!fftw_ready || !(curr_control & static_cast<int>(DB_BIT::NEWDATA))) {
-    return {0, bin_hz, {}};
-  }
-
-  // CAS loop to toggle the buffer used and remove NEWDATA flag, waiting for !BUSY.
-  int next_control = 0;
-  do {
-    curr_control &= ~static_cast<int>(DB_BIT::BUSY);
-    next_control = (curr_control ^ static_cast<int>(DB_BIT::IDX)) & static_cast<int>(DB_BIT::IDX);
-  } while (!db_control.compare_exchange_weak(curr_control, next_control));
+auto Spectrum::compute_magnitudes(std::vector<float>& squared_magnitudes) -> std::tuple<uint, float> {
+  uint current_rate = 0U;
 
-  // Buffer with data is at the index which was found inside db_control.
-  int index = curr_control & static_cast<int>(DB_BIT::IDX);
-  float* buf = db_buffers[index].data();
+  {
+    std::scoped_lock<std::mutex> lock(data_mutex);
 
-  // https://en.wikipedia.org/wiki/Hann_function
-  for (size_t n = 0; n < n_bands; n++) {
-    real_input[n] = buf[n] * hann_window[n];
+    current_rate = rate;
   }
 
-  fftwf_execute(plan);
-
-  for (uint i = 0U; i < output.size(); i++) {
-    float real = complex_output[i][0];
-    float img = complex_output[i][1];
+  if (current_rate == 0) {
+    return {0, 0.0F};
+  }
 
-    float mag = std::sqrt((real * real) + (img * img));
+  /**
+   * The samples come from the lock-free ring buffer of the analyzer. The FFT
+   * planning and the transforms are done without holding data_mutex, so they
+   * never keep the realtime thread waiting in setup().
+   */
 
-    mag /= static_cast<float>(n_bands);
+  std::scoped_lock<std::mutex> lock(analyzer_mutex);
 
-    // Compensate Hann window
-    mag *= 2.0F;
+  analyzer.configure(static_cast<uint>(DbSpectrum::fftSize()), static_cast<float>(DbSpectrum::overlap()) * 0.01F,
+                     static_cast<SpectrumAnalyzer::Averaging>(DbSpectrum::averaging()),
+                     static_cast<float>(DbSpectrum::averagingTime()) * 0.001F, current_rate);
 
-    // Single-sided correction
-    if (i == 0 || i == n_bands / 2) {
-      mag *= 0.5F;
-    }
+  // Early return if no new frame is available since our last call.
 
-    output[i] = static_cast<double>(util::linear_to_db(mag));
+  if (!analyzer.read(squared_magnitudes)) {
+    return {0, analyzer.bin_hz()};
   }
 
-  return {rate, bin_hz, output};
+  return {current_rate, analyzer.bin_hz()};
 }
 
 void Spectrum::process([[maybe_unused]] std::span<float>& left_in,
@@ -19,12 +19,9 @@
 
 #pragma once
 
-#include <fftw3.h>
-#include <qlist.h>
 #include <sys/types.h>
 #include <QString>
-#include <array>
-#include <atomic>
+#include <mutex>
 #include <span>
 #include <string>
 #include <tuple>
@@ -33,6 +30,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "spectrum_analyzer.hpp"
 
 class Spectrum : public PluginBase {
  public:
@@ -49,6 +47,8 @@ class Spectrum : public PluginBase {
 
   void setup() override;
 
+  void quantum_changed() override;
+
   void process(std::span<float>& left_in,
                std::span<float>& right_in,
                std::span<float>& left_out,
@@ -63,43 +63,28 @@ class Spectrum : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
-  auto compute_magnitudes() -> std::tuple<uint, float, QList<double>>;  // rate, magnitudes
+  /**
+   * Fills the vector with the averaged squared magnitude of each bin. The
+   * square root and the dB conversion are left to whoever displays the data.
+   * Returns the rate and the bin width. The rate is zero when there is no new
+   * data.
+   */
+  auto compute_magnitudes(std::vector<float>& squared_magnitudes) -> std::tuple<uint, float>;  // rate, bin_hz
 
  private:
   DbSpectrum* settings = nullptr;
 
-  std::atomic<bool> fftw_ready = false;
-
-  fftwf_plan plan = nullptr;
-
-  fftwf_complex* complex_output = nullptr;
-
-  static constexpr uint n_bands = 8192U;
-
   bool ready = false;
 
-  float bin_hz = 0.0F;
-
-  std::array<float, n_bands> real_input;
-
-  QList<double> output = QList<double>(((n_bands / 2U) + 1U));
+  std::vector<float> mono;
 
   std::vector<float> left_delayed_vector;
   std::vector<float> right_delayed_vector;
   std::span<float> left_delayed;
   std::span<float> right_delayed;
 
-  std::array<float, n_bands> latest_samples_mono;
-
-  std::array<float, n_bands> hann_window;
-
-  enum class DB_BIT {
-    IDX = (1 << 0),      // To which db_buffers array process() should write.
-    NEWDATA = (1 << 1),  // If new data has been written by process().
-    BUSY = (1 << 2),     // If process() is currently writing data.
-  };
+  SpectrumAnalyzer analyzer;
 
-  std::array<std::array<float, n_bands>, 2> db_buffers;
-  std::atomic<int> db_control = {0};
-  static_assert(std::atomic<int>::is_always_lock_free);
+  // Serializes the readers of the analyzer. The realtime thread never takes it.
+  std::mutex analyzer_mutex;
 };
@@ -0,0 +1,247 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spectrum_analyzer.hpp"
+#include <fftw3.h>
+#include <sys/types.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <vector>
+#include "util.hpp"
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+  free_fft();
+}
+
+void SpectrumAnalyzer::free_fft() {
+  std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+  if (plan != nullptr) {
+    fftwf_destroy_plan(plan);
+
+    plan = nullptr;
+  }
+
+  if (real_input != nullptr) {
+    fftwf_free(real_input);
+
+    real_input = nullptr;
+  }
+
+  if (complex_output != nullptr) {
+    fftwf_free(complex_output);
+
+    complex_output = nullptr;
+  }
+}
+
+void SpectrumAnalyzer::write(std::span<const float> samples) {
+  if (samples.size() > ring_size) {
+    samples = samples.last(ring_size);
+  }
+
+  const auto position = write_position.load(std::memory_order_relaxed);
+
+  const auto offset = static_cast<size_t>(position & (ring_size - 1U));
+
+  const auto n_first = std::min(samples.size(), ring_size - offset);
+
+  std::copy_n(samples.begin(), n_first, ring.begin() + static_cast<std::ptrdiff_t>(offset));
+  std::copy(samples.begin() + static_cast<std::ptrdiff_t>(n_first), samples.end(), ring.begin());
+
+  write_position.store(position + samples.size(), std::memory_order_release);
+}
+
+void SpectrumAnalyzer::configure(const uint& fft_size,
+                                 const float& overlap,
+                                 const Averaging& averaging,
+                                 const float& averaging_time,
+                                 const uint& rate) {
+  const auto size = std::clamp(std::bit_floor(fft_size), min_fft_size, max_fft_size);
+
+  if (size == this->fft_size && overlap == this->overlap && averaging == this->averaging &&
+      averaging_time == this->averaging_time && rate == this->rate) {
+    return;
+  }
+
+  if (size != this->fft_size || plan == nullptr) {
+    free_fft();
+
+    std::scoped_lock<std::mutex> lock(util::fftw_lock());
+
+    real_input = fftwf_alloc_real(size);
+    complex_output = fftwf_alloc_complex((size / 2U) + 1U);
+
+    if (real_input != nullptr && complex_output != nullptr) {
+      plan = fftwf_plan_dft_r2c_1d(static_cast<int>(size), real_input, complex_output, FFTW_ESTIMATE);
+    }
+
+    // https://en.wikipedia.org/wiki/Hann_function
+
+    window.resize(size);
+
+    for (uint n = 0U; n < size; n++) {
+      window[n] = 0.5F * (1.0F - std::cos(2.0F * std::numbers::pi_v<float> * static_cast<float>(n) /
+                                          static_cast<float>(size - 1U)));
+    }
+  }
+
+  this->fft_size = size;
+  this->overlap = overlap;
+  this->averaging = averaging;
+  this->averaging_time = averaging_time;
+  this->rate = rate;
+
+  const auto hop_fraction = 1.0F - std::clamp(overlap, 0.0F, 0.95F);
+
+  hop = std::max(1U, static_cast<uint>(std::lround(static_cast<float>(size) * hop_fraction)));
+
+  decay = (averaging_time > 0.0F && rate > 0U)
+              ? std::exp(-static_cast<float>(hop) / (averaging_time * static_cast<float>(rate)))
+              : 0.0F;
+
+  average.assign((size / 2U) + 1U, 0.0F);
+
+  n_welch_frames = 0U;
+
+  const auto written = write_position.load(std::memory_order_acquire);
+
+  frame_position = (written > size) ? written - size : 0U;
+}
+
+auto SpectrumAnalyzer::read(std::vector<float>& squared_magnitudes) -> bool {
+  if (plan == nullptr) {
+    return false;
+  }
+
+  const auto written = write_position.load(std::memory_order_acquire);
+
+  // Frames too old to be worth computing are skipped. This also keeps us away from what is being overwritten.
+
+  const auto max_backlog =
+      std::min<uint64_t>((static_cast<uint64_t>(max_frames_per_read - 1U) * hop) + fft_size, ring_size / 2U);
+
+  if (written > frame_position + max_backlog) {
+    frame_position = written - max_backlog;
+  }
+
+  bool new_frame = false;
+
+  while (frame_position + fft_size <= written) {
+    const auto offset = static_cast<size_t>(frame_position & (ring_size - 1U));
+
+    const auto n_first = std::min<size_t>(fft_size, ring_size - offset);
+
+    for (size_t n = 0U; n < n_first; n++) {
+      real_input[n] = ring[offset + n] * window[n];
+    }
+
+    for (size_t n = n_first; n < fft_size; n++) {
+      real_input[n] = ring[n - n_first] * window[n];
+    }
+
+    // The writer may have lapped us while we were copying
+
+    if (write_position.load(std::memory_order_acquire) - frame_position > ring_size) {
+      frame_position += hop;
+
+      continue;
+    }
+
+    add_frame();
+
+    frame_position += hop;
+
+    new_frame = true;
+  }
+
+  if (!new_frame) {
+    return false;
+  }
+
+  squared_magnitudes.resize(average.size());
+
+  if (averaging == Averaging::welch) {
+    const auto inv_n = 1.0F / static_cast<float>(n_welch_frames);
+
+    for (size_t n = 0U; n < average.size(); n++) {
+      squared_magnitudes[n] = average[n] * inv_n;
+    }
+
+    std::ranges::fill(average, 0.0F);
+
+    n_welch_frames = 0U;
+  } else {
+    std::ranges::copy(average, squared_magnitudes.begin());
+  }
+
+  return true;
+}
+
+void SpectrumAnalyzer::add_frame() {
+  fftwf_execute(plan);
+
+  // Normalization and Hann window compensation. DC and Nyquist do not get the single-sided correction.
+
+  const float scale = 2.0F / static_cast<float>(fft_size);
+  const float scale_squared = scale * scale;
+
+  const auto n_bins = average.size();
+
+  for (size_t n = 0U; n < n_bins; n++) {
+    const float real = complex_output[n][0];
+    const float img = complex_output[n][1];
+
+    float power = ((real * real) + (img * img)) * scale_squared;
+
+    if (n == 0U || n == n_bins - 1U) {
+      power *= 0.25F;
+    }
+
+    switch (averaging) {
+      case Averaging::none:
+        average[n] = power;
+        break;
+      case Averaging::exponential:
+        average[n] = (decay * average[n]) + ((1.0F - decay) * power);
+        break;
+      case Averaging::peak_hold:
+        average[n] = std::max(power, decay * average[n]);
+        break;
+      case Averaging::welch:
+        average[n] += power;
+        break;
+    }
+  }
+
+  if (averaging == Averaging::welch) {
+    n_welch_frames++;
+  }
+}
+
+auto SpectrumAnalyzer::bin_hz() const -> float {
+  return (fft_size > 0U) ? static_cast<float>(rate) / static_cast<float>(fft_size) : 0.0F;
+}
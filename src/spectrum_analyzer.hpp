@@ -0,0 +1,102 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <fftw3.h>
+#include <sys/types.h>
+#include <atomic>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Incremental spectrum analyzer. The realtime thread only appends samples to a
+ * ring buffer. The FFT frames are computed by the reader, one for each hop that
+ * arrived since its last call. No frame is computed twice when the reader is
+ * faster than the hop rate and the frames are averaged instead of dropped when
+ * it is slower.
+ */
+class SpectrumAnalyzer {
+ public:
+  enum class Averaging { none, exponential, peak_hold, welch };
+
+  SpectrumAnalyzer() = default;
+  SpectrumAnalyzer(const SpectrumAnalyzer&) = delete;
+  auto operator=(const SpectrumAnalyzer&) -> SpectrumAnalyzer& = delete;
+  SpectrumAnalyzer(const SpectrumAnalyzer&&) = delete;
+  auto operator=(const SpectrumAnalyzer&&) -> SpectrumAnalyzer& = delete;
+  ~SpectrumAnalyzer();
+
+  static constexpr uint min_fft_size = 1024U;
+  static constexpr uint max_fft_size = 32768U;
+
+  // Realtime safe. There can be only one writer thread.
+  void write(std::span<const float> samples);
+
+  /**
+   * Has to be called from the reader thread. Nothing is done when the
+   * parameters did not change. Otherwise the averages are cleared. The overlap
+   * is a fraction of the FFT size and the averaging time is in seconds.
+   */
+  void configure(const uint& fft_size,
+                 const float& overlap,
+                 const Averaging& averaging,
+                 const float& averaging_time,
+                 const uint& rate);
+
+  /**
+   * Computes the frames that are ready and fills the vector with the averaged
+   * squared magnitudes of the bins. Returns false if there was no new frame.
+   */
+  auto read(std::vector<float>& squared_magnitudes) -> bool;
+
+  [[nodiscard]] auto bin_hz() const -> float;
+
+ private:
+  static constexpr uint ring_size = 4U * max_fft_size;  // it has to be a power of 2
+
+  static constexpr uint max_frames_per_read = 16U;
+
+  uint fft_size = 0U, hop = 0U, rate = 0U, n_welch_frames = 0U;
+
+  float overlap = -1.0F, averaging_time = -1.0F, decay = 0.0F;
+
+  Averaging averaging = Averaging::none;
+
+  std::vector<float> ring = std::vector<float>(ring_size, 0.0F);
+
+  std::atomic<uint64_t> write_position = 0U;
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  uint64_t frame_position = 0U;  // position in the stream of the first sample of the next frame
+
+  std::vector<float> window, average;
+
+  float* real_input = nullptr;
+
+  fftwf_complex* complex_output = nullptr;
+
+  fftwf_plan plan = nullptr;
+
+  void free_fft();
+
+  void add_frame();
+};
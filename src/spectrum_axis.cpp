@@ -0,0 +1,129 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "spectrum_axis.hpp"
+#include <sys/types.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "util.hpp"
+
+namespace {
+
+constexpr float minimum_squared_level = util::minimum_linear_level * util::minimum_linear_level;
+
+inline auto squared_to_db(const float& value) -> float {
+  if (value >= minimum_squared_level) {
+    return 10.0F * std::log10(value);
+  }
+
+  return util::minimum_db_level;
+}
+
+}  // namespace
+
+void SpectrumAxis::update(const size_t& n_bins,
+                          const float& bin_hz,
+                          const float& min_freq,
+                          const float& max_freq,
+                          const uint& n_points,
+                          const bool& log_axis) {
+  if (n_bins == this->n_bins && bin_hz == this->bin_hz && min_freq == this->min_freq && max_freq == this->max_freq &&
+      n_points == this->n_points && log_axis == this->log_axis) {
+    return;
+  }
+
+  this->n_bins = n_bins;
+  this->bin_hz = bin_hz;
+  this->min_freq = min_freq;
+  this->max_freq = max_freq;
+  this->n_points = n_points;
+  this->log_axis = log_axis;
+
+  axis.clear();
+  points.clear();
+
+  if (n_bins < 2U || bin_hz <= 0.0F) {
+    return;
+  }
+
+  axis = log_axis ? util::logspace(min_freq, max_freq, n_points) : util::linspace(min_freq, max_freq, n_points);
+
+  points.resize(axis.size());
+
+  const auto max_bin = static_cast<uint>(n_bins - 1U);
+
+  // Each point covers the frequencies up to halfway to its neighbours.
+
+  auto middle = [&](const float& a, const float& b) {
+    return (log_axis && a > 0.0F) ? std::sqrt(a * b) : 0.5F * (a + b);
+  };
+
+  for (size_t n = 0U; n < axis.size(); n++) {
+    const auto lower = (n == 0U) ? axis[n] : middle(axis[n - 1U], axis[n]);
+    const auto upper = (n == axis.size() - 1U) ? axis[n] : middle(axis[n], axis[n + 1U]);
+
+    const auto first_bin = std::min(static_cast<uint>(std::ceil(lower / bin_hz)), max_bin);
+    const auto last_bin = std::min(static_cast<uint>(std::floor(upper / bin_hz)), max_bin);
+
+    auto& p = points[n];
+
+    if (last_bin > first_bin) {
+      p = {.first_bin = first_bin, .last_bin = last_bin, .weight = 0.0F, .aggregate = true};
+
+      continue;
+    }
+
+    const auto position = axis[n] / bin_hz;
+
+    const auto bin = std::min(static_cast<uint>(std::floor(position)), max_bin - 1U);
+
+    p = {.first_bin = bin,
+         .last_bin = bin + 1U,
+         .weight = std::clamp(position - static_cast<float>(bin), 0.0F, 1.0F),
+         .aggregate = false};
+  }
+}
+
+auto SpectrumAxis::frequencies() const -> const std::vector<float>& {
+  return axis;
+}
+
+void SpectrumAxis::map(std::span<const float> squared_magnitudes, std::span<float> output) const {
+  if (squared_magnitudes.size() != n_bins) {
+    return;
+  }
+
+  const auto count = std::min(points.size(), output.size());
+
+  for (size_t n = 0U; n < count; n++) {
+    const auto& p = points[n];
+
+    if (p.aggregate) {
+      const auto bins = squared_magnitudes.subspan(p.first_bin, p.last_bin - p.first_bin + 1U);
+
+      output[n] = squared_to_db(*std::ranges::max_element(bins));
+    } else {
+      output[n] = ((1.0F - p.weight) * squared_to_db(squared_magnitudes[p.first_bin])) +
+                  (p.weight * squared_to_db(squared_magnitudes[p.last_bin]));
+    }
+  }
+}
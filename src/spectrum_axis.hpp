@@ -0,0 +1,80 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * Maps the bins of the spectrum FFT to the points of the chart horizontal axis.
+ * The mapping only depends on the axis settings. It is compiled once into a
+ * sparse table and each frame costs a single pass over the displayed bins.
+ *
+ * Where the chart has more points than bins the two nearest bins are linearly
+ * interpolated. Where one point covers many bins (the high frequencies on a
+ * logarithmic axis) the bins are aggregated and the point shows their maximum,
+ * so narrow peaks are not lost between the points.
+ */
+class SpectrumAxis {
+ public:
+  /**
+   * Rebuilds the table when any of the parameters is different from the ones
+   * used the last time. Otherwise it does nothing.
+   */
+  void update(const size_t& n_bins,
+              const float& bin_hz,
+              const float& min_freq,
+              const float& max_freq,
+              const uint& n_points,
+              const bool& log_axis);
+
+  [[nodiscard]] auto frequencies() const -> const std::vector<float>&;
+
+  /**
+   * The input has the squared magnitudes of all the bins. The output receives
+   * the level in dB of each axis point.
+   */
+  void map(std::span<const float> squared_magnitudes, std::span<float> output) const;
+
+ private:
+  struct Point {
+    uint first_bin = 0U;
+
+    uint last_bin = 0U;  // inclusive
+
+    float weight = 0.0F;  // weight of the last bin when interpolating
+
+    bool aggregate = false;
+  };
+
+  size_t n_bins = 0U;
+
+  float bin_hz = 0.0F, min_freq = 0.0F, max_freq = 0.0F;
+
+  uint n_points = 0U;
+
+  bool log_axis = false;
+
+  std::vector<float> axis;
+
+  std::vector<Point> points;
+};
@@ -31,12 +31,14 @@
 #include <span>
 #include <string>
 #include "db_manager.hpp"
+#include "dsp_kernels.hpp"
 #include "easyeffects_db_speex.h"
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -58,7 +60,7 @@ Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
 
   // specific plugin controls
 
-  connect(settings, &DbSpeex::enableDenoiseChanged, [&]() {
+  connect(settings, &DbSpeex::enableDenoiseChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
     enable_denoise = settings->enableDenoise();
@@ -72,7 +74,7 @@ Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
     }
   });
 
-  connect(settings, &DbSpeex::noiseSuppressionChanged, [&]() {
+  connect(settings, &DbSpeex::noiseSuppressionChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
     noise_suppression = settings->noiseSuppression();
@@ -86,7 +88,7 @@ Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
     }
   });
 
-  connect(settings, &DbSpeex::enableAgcChanged, [&]() {
+  connect(settings, &DbSpeex::enableAgcChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
     enable_agc = settings->enableAgc();
@@ -100,7 +102,7 @@ Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
     }
   });
 
-  connect(settings, &DbSpeex::enableVadChanged, [&]() {
+  connect(settings, &DbSpeex::enableVadChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
     enable_vad = settings->enableVad();
@@ -114,7 +116,7 @@ Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
     }
   });
 
-  connect(settings, &DbSpeex::vadProbabilityStartChanged, [&]() {
+  connect(settings, &DbSpeex::vadProbabilityStartChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
     vad_probability_start = settings->vadProbabilityStart();
@@ -128,7 +130,7 @@ Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
     }
   });
 
-  connect(settings, &DbSpeex::vadProbabilityContinueChanged, [&]() {
+  connect(settings, &DbSpeex::vadProbabilityContinueChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
     vad_probability_continue = settings->vadProbabilityContinue();
@@ -142,7 +144,7 @@ Speex::Speex(const std::string& tag, pw::Manager* pipe_manager, PipelineType pip
     }
   });
 
-  connect(settings, &DbSpeex::enableDereverbChanged, [&]() {
+  connect(settings, &DbSpeex::enableDereverbChanged, this, [&]() {
     std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
     enable_dereverb = settings->enableDereverb();
@@ -164,7 +166,7 @@ Speex::~Speex() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   std::scoped_lock<std::mutex> lock(util::fftw_lock());
 
@@ -196,8 +198,7 @@ void Speex::setup() {
   data_L.resize(n_samples);
   data_R.resize(n_samples);
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
         std::scoped_lock<std::mutex> lock(util::fftw_lock());
@@ -241,8 +242,7 @@ void Speex::setup() {
 
         speex_ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void Speex::process(std::span<float>& left_in,
@@ -258,39 +258,24 @@ void Speex::process(std::span<float>& left_in,
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
-
-  for (size_t i = 0; i < n_samples; i++) {
-    data_L[i] = static_cast<spx_int16_t>(left_in[i] * (SHRT_MAX + 1));
+  apply_input_gain(left_in, right_in);
 
-    data_R[i] = static_cast<spx_int16_t>(right_in[i] * (SHRT_MAX + 1));
-  }
+  dsp::float_to_int16(left_in.first(n_samples), data_L);
+  dsp::float_to_int16(right_in.first(n_samples), data_R);
 
   if (speex_preprocess_run(state_left, data_L.data()) == 1) {
-    for (size_t i = 0; i < n_samples; i++) {
-      left_out[i] = static_cast<float>(data_L[i]) * inv_short_max;
-    }
+    dsp::int16_to_float(std::span(data_L).first(n_samples), left_out);
   } else {
     std::ranges::fill(left_out, 0.0F);
   }
 
   if (speex_preprocess_run(state_right, data_R.data()) == 1) {
-    for (size_t i = 0; i < n_samples; i++) {
-      right_out[i] = static_cast<float>(data_R[i]) * inv_short_max;
-    }
+    dsp::int16_to_float(std::span(data_R).first(n_samples), right_out);
   } else {
     std::ranges::fill(right_out, 0.0F);
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void Speex::process([[maybe_unused]] std::span<float>& left_in,
@@ -77,8 +77,6 @@ class Speex : public PluginBase {
 
   uint latency_n_frames = 0U;
 
-  const float inv_short_max = 1.0F / (SHRT_MAX + 1);
-
   std::vector<spx_int16_t> data_L, data_R;
 
   SpeexPreprocessState *state_left = nullptr, *state_right = nullptr;
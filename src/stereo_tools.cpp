@@ -37,6 +37,7 @@
 #include "pw_manager.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 StereoTools::StereoTools(const std::string& tag, pw::Manager* pipe_manager, PipelineType pipe_type, QString instance_id)
     : PluginBase(tag,
@@ -79,18 +80,23 @@ StereoTools::StereoTools(const std::string& tag, pw::Manager* pipe_manager, Pipe
   BIND_LV2_PORT_DB("slev", slev, setSlev, DbStereoTools::slevChanged, false);
   BIND_LV2_PORT_DB("mlev", mlev, setMlev, DbStereoTools::mlevChanged, false);
 
-  dry = (settings->dry() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->dry()));
+  dry.reset((settings->dry() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->dry())));
 
-  wet = (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
+  wet.reset((settings->wet() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->wet())));
 
-  connect(settings, &DbStereoTools::dryChanged, [&]() {
-    dry =
-        (settings->dry() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->dry()));
+  ramped_values.push_back(&dry);
+  ramped_values.push_back(&wet);
+
+  connect(settings, &DbStereoTools::dryChanged, this, [&]() {
+    dry.set((settings->dry() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->dry())));
   });
 
-  connect(settings, &DbStereoTools::wetChanged, [&]() {
-    wet =
-        (settings->wet() <= util::minimum_db_d_level) ? 0.0F : static_cast<float>(util::db_to_linear(settings->wet()));
+  connect(settings, &DbStereoTools::wetChanged, this, [&]() {
+    wet.set((settings->wet() <= util::minimum_db_d_level) ? 0.0F
+                                                          : static_cast<float>(util::db_to_linear(settings->wet())));
   });
 }
 
@@ -101,7 +107,7 @@ StereoTools::~StereoTools() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   util::debug(std::format("{}{} destroyed", log_tag, name.toStdString()));
 }
@@ -142,20 +148,18 @@ void StereoTools::setup() {
     return;
   }
 
-  ready = false;
+  ready = lv2_wrapper->has_instance();
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
-        lv2_wrapper->create_instance(rate);
+        lv2_wrapper->replace_instance(rate, data_mutex);
 
         std::scoped_lock<std::mutex> lock(data_mutex);
 
         ready = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void StereoTools::process(std::span<float>& left_in,
@@ -175,33 +179,19 @@ void StereoTools::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   lv2_wrapper->connect_data_ports(left_in, right_in, left_out, right_out);
   lv2_wrapper->run();
 
-  for (size_t n = 0; n < left_out.size(); n++) {
-    left_out[n] = (wet * left_out[n]) + (dry * left_in[n]);
+  RampedValue::mix(left_out, right_out, left_in, right_in, wet, dry);
 
-    right_out[n] = (wet * right_out[n]) + (dry * right_in[n]);
-  }
-
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
-
-  if (updateLevelMeters) {
-    get_peaks(left_in, right_in, left_out, right_out);
-  }
+  apply_gain_and_get_peaks(left_in, right_in, left_out, right_out, output_gain);
 }
 
 void StereoTools::process([[maybe_unused]] std::span<float>& left_in,
@@ -214,3 +204,7 @@ void StereoTools::process([[maybe_unused]] std::span<float>& left_in,
 auto StereoTools::get_latency_seconds() -> float {
   return 0.0F;
 }
+
+auto StereoTools::get_tail_seconds() -> float {
+  return filter_tail_seconds;
+}
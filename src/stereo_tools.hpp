@@ -28,6 +28,7 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "ramped_value.hpp"
 
 class StereoTools : public PluginBase {
   Q_OBJECT
@@ -62,12 +63,14 @@ class StereoTools : public PluginBase {
 
   auto get_latency_seconds() -> float override;
 
+  auto get_tail_seconds() -> float override;
+
   double correlation_port_value = 0.0;
 
  private:
   bool ready = false;
 
-  float dry = 0.0F, wet = 1.0F;
+  RampedValue dry{0.0F}, wet{1.0F};
 
   DbStereoTools* settings = nullptr;
 };
@@ -30,6 +30,7 @@
 #include <chrono>
 #include <cstdlib>
 #include <format>
+#include <map>
 #include <ranges>
 #include <set>
 #include <string>
@@ -39,6 +40,7 @@
 #include "db_manager.hpp"
 #include "effects_base.hpp"
 #include "pipeline_type.hpp"
+#include "plugin_base.hpp"
 #include "presets_manager.hpp"
 #include "pw_manager.hpp"
 #include "pw_objects.hpp"
@@ -55,8 +57,6 @@ StreamInputEffects::StreamInputEffects(pw::Manager* pipe_manager) : EffectsBase(
         if (node.name == DbStreamInputs::inputDevice()) {
           if (DbMain::bypass()) {
             DbMain::setBypass(false);
-
-            return;  // filter connected through update_bypass_state
           }
 
           set_bypass(false);
@@ -78,8 +78,6 @@ StreamInputEffects::StreamInputEffects(pw::Manager* pipe_manager) : EffectsBase(
         if (auto node = pm->model_nodes.get_node_by_name(name); node.serial != SPA_ID_INVALID) {
           if (DbMain::bypass()) {
             DbMain::setBypass(false);
-
-            return;  // filter connected through update_bypass_state
           }
 
           set_bypass(false);
@@ -90,16 +88,7 @@ StreamInputEffects::StreamInputEffects(pw::Manager* pipe_manager) : EffectsBase(
       Qt::QueuedConnection);
 
   connect(
-      DbStreamInputs::self(), &DbStreamInputs::pluginsChanged, this,
-      [&]() {
-        if (DbMain::bypass()) {
-          DbMain::setBypass(false);
-
-          return;  // filter connected through update_bypass_state
-        }
-
-        set_bypass(false);
-      },
+      DbStreamInputs::self(), &DbStreamInputs::pluginsChanged, this, [&]() { on_plugins_changed(); },
       Qt::QueuedConnection);
 
   connect(pm, &pw::Manager::linkChanged, this, &StreamInputEffects::on_link_changed, Qt::QueuedConnection);
@@ -121,19 +110,19 @@ StreamInputEffects::StreamInputEffects(pw::Manager* pipe_manager) : EffectsBase(
 
   /**
    * We need to listen to output device changes because if the echo canceller is in the mic pipeline we have to change
-   * its probe links to the new output device.
+   * its probe links to the new output device. Only those links are replaced. The rest of the chain keeps running.
    */
 
   connect(
       DbStreamOutputs::self(), &DbStreamOutputs::outputDeviceChanged, this,
       [&]() {
-        if (DbMain::bypass()) {
-          DbMain::setBypass(false);
-
-          return;  // filter connected through update_bypass_state
+        if (!filtersLinked) {
+          return;
         }
 
-        set_bypass(false);
+        update_echo_canceller_probe_links();
+
+        set_listen_to_mic(DbStreamInputs::listenToMic());
       },
       Qt::QueuedConnection);
 
@@ -255,7 +244,7 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
 
   const auto list = bypass ? QStringList() : DbStreamInputs::plugins();
 
-  auto mic_linked = false;
+  update_analysis_taps(list, get_chain_instances(list), *chain_fader);
 
   // waiting for the input device ports information to be available.
 
@@ -278,74 +267,54 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
     }
   }
 
-  uint prev_node_id = input_device.id;
-  uint next_node_id = 0U;
+  // link the input device and the plugins to the chain fader
 
-  // link plugins
+  chain_proxies = link_chain(list, get_chain_instances(list), chain_fader->get_node_id());
 
-  if (!list.empty()) {
-    for (const auto& name : list) {
-      if (!plugins.contains(name) || plugins[name] == nullptr) {
-        continue;
-      }
+  list_proxies.insert(list_proxies.end(), chain_proxies.begin(), chain_proxies.end());
 
-      if (!plugins[name]->connected_to_pw ? plugins[name]->connect_to_pw() : true) {
-        next_node_id = plugins[name]->get_node_id();
+  linked_plugins = list;
 
-        const auto links = pm->link_nodes(prev_node_id, next_node_id);
+  for (const auto& name : list) {
+    if (plugins.contains(name) && plugins[name] != nullptr) {
+      plugins[name]->update_probe_links();
+    }
+  }
 
-        for (auto* link : links) {
-          list_proxies.push_back(link);
-        }
+  update_echo_canceller_probe_links();
 
-        if (mic_linked && (links.size() == 2U)) {
-          prev_node_id = next_node_id;
-        } else if (!mic_linked && (!links.empty())) {
-          prev_node_id = next_node_id;
-          mic_linked = true;
-        } else {
-          util::warning(std::format("Link from node {} to node {} failed", prev_node_id, next_node_id));
-        }
-      }
-    }
+  // link the unprocessed signal used by the global bypass
 
-    // checking if we have to link the echo_canceller probe to the output device
+  link_dry_fader(input_device.id);
 
-    for (const auto& name : list) {
-      if (!plugins.contains(name) || plugins[name] == nullptr) {
-        continue;
-      }
+  // link the faders to spectrum. The standby one is silent until the plugins list changes.
 
-      if (name.startsWith(tags::plugin_name::BaseName::echoCanceller)) {
-        if (plugins[name]->connected_to_pw) {
-          auto output_device = pm->model_nodes.get_node_by_name(DbStreamOutputs::outputDevice());
+  for (const auto& fader : {chain_fader, standby_fader, dry_fader}) {
+    const auto links = pm->link_nodes(fader->get_node_id(), spectrum->get_node_id());
 
-          for (const auto& link : pm->link_nodes(output_device.id, plugins[name]->get_node_id(), true)) {
-            list_proxies.push_back(link);
-          }
-        }
-      }
+    for (auto* link : links) {
+      list_proxies.push_back(link);
+    }
 
-      plugins[name]->update_probe_links();
+    if (links.size() < 2U) {
+      util::warning(
+          std::format("Link from fader {} to spectrum {} failed", fader->get_node_id(), spectrum->get_node_id()));
     }
   }
 
   // link spectrum, output level meter and source node
 
-  for (const auto node_id : {spectrum->get_node_id(), output_level->get_node_id(), pm->ee_source_node.id}) {
-    next_node_id = node_id;
+  uint prev_node_id = spectrum->get_node_id();
 
+  for (const auto next_node_id : {output_level->get_node_id(), pm->ee_source_node.id}) {
     const auto links = pm->link_nodes(prev_node_id, next_node_id);
 
     for (auto* link : links) {
       list_proxies.push_back(link);
     }
 
-    if (mic_linked && (links.size() == 2U)) {
-      prev_node_id = next_node_id;
-    } else if (!mic_linked && (!links.empty())) {
+    if (links.size() == 2U) {
       prev_node_id = next_node_id;
-      mic_linked = true;
     } else {
       util::warning(std::format("Link from node {} to node {} failed", prev_node_id, next_node_id));
     }
@@ -363,7 +332,70 @@ void StreamInputEffects::connect_filters(const bool& bypass) {
   Q_EMIT filtersLinkedChanged();
 }
 
+auto StreamInputEffects::link_chain(const QStringList& list,
+                                    const std::map<QString, PluginBase*>& instances,
+                                    const uint& tail_node_id) -> std::vector<pw_proxy*> {
+  std::vector<pw_proxy*> proxies;
+
+  auto input_device = pm->model_nodes.get_node_by_name(DbStreamInputs::inputDevice());
+
+  if (input_device.serial == SPA_ID_INVALID) {
+    return proxies;
+  }
+
+  auto mic_linked = false;
+
+  uint prev_node_id = input_device.id;
+
+  auto link_to = [&](const uint& next_node_id) {
+    const auto links = pm->link_nodes(prev_node_id, next_node_id);
+
+    proxies.insert(proxies.end(), links.begin(), links.end());
+
+    // A mono microphone has only one port to link
+
+    if (mic_linked && (links.size() == 2U)) {
+      prev_node_id = next_node_id;
+    } else if (!mic_linked && (!links.empty())) {
+      prev_node_id = next_node_id;
+      mic_linked = true;
+    } else {
+      util::warning(std::format("Link from node {} to node {} failed", prev_node_id, next_node_id));
+    }
+  };
+
+  for (const auto& name : list) {
+    if (!instances.contains(name)) {
+      continue;
+    }
+
+    auto* plugin = instances.at(name);
+
+    if (!plugin->connected_to_pw ? plugin->connect_to_pw() : true) {
+      link_to(plugin->get_node_id());
+    }
+  }
+
+  link_to(tail_node_id);
+
+  return proxies;
+}
+
+void StreamInputEffects::on_plugins_changed() {
+  if (DbMain::bypass()) {
+    DbMain::setBypass(false);
+  }
+
+  if (!bypass && !bypass_transition_active && crossfade_chain(DbStreamInputs::plugins())) {
+    return;
+  }
+
+  set_bypass(false);
+}
+
 void StreamInputEffects::disconnect_filters() {
+  abort_chain_crossfade();
+
   std::set<uint> link_id_list;
 
   const auto selected_plugins_list = (bypass) ? QStringList() : DbStreamInputs::plugins();
@@ -390,9 +422,12 @@ void StreamInputEffects::disconnect_filters() {
     plugin->clear_data();
   }
 
+  const auto fixed_nodes = {spectrum->get_node_id(), output_level->get_node_id(), chain_fader->get_node_id(),
+                            standby_fader->get_node_id(), dry_fader->get_node_id()};
+
   for (const auto& link : pm->get_links()) {
-    if (link.input_node_id == spectrum->get_node_id() || link.output_node_id == spectrum->get_node_id() ||
-        link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
+    if (std::ranges::any_of(fixed_nodes,
+                            [&](const auto& id) { return link.input_node_id == id || link.output_node_id == id; })) {
       link_id_list.insert(link.id);
     }
   }
@@ -402,8 +437,12 @@ void StreamInputEffects::disconnect_filters() {
   }
 
   pm->destroy_links(list_proxies);
+  pm->destroy_links(list_proxies_echo_probe);
 
   list_proxies.clear();
+  list_proxies_echo_probe.clear();
+  chain_proxies.clear();
+  linked_plugins.clear();
 
   set_listen_to_mic(false);
 
@@ -439,6 +478,31 @@ void StreamInputEffects::set_bypass(const bool& state) {
   Q_EMIT pipelineChanged();
 }
 
+void StreamInputEffects::update_echo_canceller_probe_links() {
+  if (!list_proxies_echo_probe.empty()) {
+    pm->destroy_links(list_proxies_echo_probe);
+
+    list_proxies_echo_probe.clear();
+  }
+
+  auto output_device = pm->model_nodes.get_node_by_name(DbStreamOutputs::outputDevice());
+
+  if (output_device.serial == SPA_ID_INVALID) {
+    return;
+  }
+
+  for (const auto& name : linked_plugins) {
+    if (!name.startsWith(tags::plugin_name::BaseName::echoCanceller) || !plugins.contains(name) ||
+        plugins[name] == nullptr || !plugins[name]->connected_to_pw) {
+      continue;
+    }
+
+    for (const auto& link : pm->link_nodes(output_device.id, plugins[name]->get_node_id(), true)) {
+      list_proxies_echo_probe.push_back(link);
+    }
+  }
+}
+
 void StreamInputEffects::set_listen_to_mic(const bool& state) {
   if (!list_proxies_listen_mic.empty()) {
     pm->destroy_links(list_proxies_listen_mic);
@@ -19,8 +19,13 @@
 
 #pragma once
 
+#include <pipewire/proxy.h>
 #include <QString>
+#include <QStringList>
+#include <map>
+#include <vector>
 #include "effects_base.hpp"
+#include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "pw_objects.hpp"
 
@@ -67,10 +72,21 @@ class StreamInputEffects : public EffectsBase {
   bool bypass_transition_pending = false;
   bool pending_bypass_state = false;
 
+  // Links from the output device to the probe of the echo canceller. They are replaced alone when the device changes.
+  std::vector<pw_proxy*> list_proxies_echo_probe;
+
   void connect_filters(const bool& bypass = false);
 
   void disconnect_filters();
 
+  auto link_chain(const QStringList& list,
+                  const std::map<QString, PluginBase*>& instances,
+                  const uint& tail_node_id) -> std::vector<pw_proxy*> override;
+
+  void on_plugins_changed() override;
+
+  void update_echo_canceller_probe_links();
+
   auto apps_want_to_play() -> bool;
 
   void update_pipeline();
@@ -27,10 +27,13 @@
 #include <qtmetamacros.h>
 #include <qtypes.h>
 #include <spa/utils/defs.h>
+#include <KLocalizedString>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdlib>
 #include <format>
+#include <map>
 #include <ranges>
 #include <set>
 #include <string>
@@ -39,12 +42,15 @@
 #include "config.h"
 #include "db_manager.hpp"
 #include "effects_base.hpp"
+#include "latency_measurement.hpp"
 #include "pipeline_type.hpp"
+#include "plugin_base.hpp"
 #include "presets_manager.hpp"
 #include "pw_manager.hpp"
 #include "pw_objects.hpp"
 #include "tags_pipewire.hpp"
 #include "tags_plugin_name.hpp"
+#include "test_signals.hpp"
 #include "util.hpp"
 
 StreamOutputEffects::StreamOutputEffects(pw::Manager* pipe_manager) : EffectsBase(pipe_manager, PipelineType::output) {
@@ -56,8 +62,6 @@ StreamOutputEffects::StreamOutputEffects(pw::Manager* pipe_manager) : EffectsBas
         if (node.name == DbStreamOutputs::outputDevice()) {
           if (DbMain::bypass()) {
             DbMain::setBypass(false);
-
-            return;  // filter connected through update_bypass_state
           }
 
           set_bypass(false);
@@ -88,8 +92,6 @@ StreamOutputEffects::StreamOutputEffects(pw::Manager* pipe_manager) : EffectsBas
         if (auto node = pm->model_nodes.get_node_by_name(name); node.serial != SPA_ID_INVALID) {
           if (DbMain::bypass()) {
             DbMain::setBypass(false);
-
-            return;  // filter connected through update_bypass_state
           }
 
           set_bypass(false);
@@ -100,16 +102,7 @@ StreamOutputEffects::StreamOutputEffects(pw::Manager* pipe_manager) : EffectsBas
       Qt::QueuedConnection);
 
   connect(
-      DbStreamOutputs::self(), &DbStreamOutputs::pluginsChanged, this,
-      [&]() {
-        if (DbMain::bypass()) {
-          DbMain::setBypass(false);
-
-          return;  // filter connected through update_bypass_state
-        }
-
-        set_bypass(false);
-      },
+      DbStreamOutputs::self(), &DbStreamOutputs::pluginsChanged, this, [&]() { on_plugins_changed(); },
       Qt::QueuedConnection);
 
   connect(
@@ -306,35 +299,41 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
     util::warning(std::format("Link from spectrum {} to global level meter {} failed", prev_node_id, next_node_id));
   }
 
-  // Link plugins in reverse order.
+  // Link the faders to spectrum. The standby one is silent until the plugins list changes.
 
   next_node_id = prev_node_id;
 
-  const auto list = bypass ? QStringList() : DbStreamOutputs::plugins();
+  for (const auto& fader : {chain_fader, standby_fader, dry_fader}) {
+    prev_node_id = fader->get_node_id();
 
-  if (!list.empty()) {
-    for (const auto& name : std::ranges::reverse_view(list)) {
-      if (!plugins.contains(name) || plugins[name] == nullptr) {
-        continue;
-      }
+    links = pm->link_nodes(prev_node_id, next_node_id);
 
-      if (!plugins[name]->connected_to_pw ? plugins[name]->connect_to_pw() : true) {
-        prev_node_id = plugins[name]->get_node_id();
+    for (auto* link : links) {
+      list_proxies.push_back(link);
+    }
 
-        links = pm->link_nodes(prev_node_id, next_node_id);
+    if (links.size() < 2U) {
+      util::warning(std::format("Link from fader {} to spectrum {} failed", prev_node_id, next_node_id));
+    }
+  }
 
-        for (auto* link : links) {
-          list_proxies.push_back(link);
-        }
+  // The unprocessed signal used by the global bypass.
 
-        if (links.size() == 2U) {
-          next_node_id = prev_node_id;
-        } else {
-          util::warning(std::format("Link from node {} to node {} failed", prev_node_id, next_node_id));
-        }
-      }
-    }
+  link_dry_fader(pm->ee_sink_node.id);
+
+  // Link plugins and easyeffects sink to the chain fader.
+
+  const auto list = bypass ? QStringList() : DbStreamOutputs::plugins();
+
+  update_analysis_taps(list, get_chain_instances(list), *chain_fader);
+
+  chain_proxies = link_chain(list, get_chain_instances(list), chain_fader->get_node_id());
+
+  list_proxies.insert(list_proxies.end(), chain_proxies.begin(), chain_proxies.end());
 
+  linked_plugins = list;
+
+  if (!list.empty()) {
     // Checking if we have to link the Echo Canceller probe to the output device.
     // Here we can loop the plugins in normal order,
 
@@ -355,18 +354,6 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
     }
   }
 
-  prev_node_id = pm->ee_sink_node.id;
-
-  links = pm->link_nodes(prev_node_id, next_node_id);
-
-  for (auto* link : links) {
-    list_proxies.push_back(link);
-  }
-
-  if (links.size() < 2U) {
-    util::warning(std::format("Link from easyeffecst sink {} to node {} failed", prev_node_id, next_node_id));
-  }
-
   // Also send audio to the virtual source if the user enabled that
 
   if (DbStreamOutputs::linkToVirtualSource()) {
@@ -391,7 +378,67 @@ void StreamOutputEffects::connect_filters(const bool& bypass) {
   Q_EMIT filtersLinkedChanged();
 }
 
+auto StreamOutputEffects::link_chain(const QStringList& list,
+                                     const std::map<QString, PluginBase*>& instances,
+                                     const uint& tail_node_id) -> std::vector<pw_proxy*> {
+  std::vector<pw_proxy*> proxies;
+
+  // Link plugins in reverse order.
+
+  uint next_node_id = tail_node_id;
+
+  for (const auto& name : std::ranges::reverse_view(list)) {
+    if (!instances.contains(name)) {
+      continue;
+    }
+
+    auto* plugin = instances.at(name);
+
+    if (!plugin->connected_to_pw ? plugin->connect_to_pw() : true) {
+      const auto prev_node_id = plugin->get_node_id();
+
+      const auto links = pm->link_nodes(prev_node_id, next_node_id);
+
+      proxies.insert(proxies.end(), links.begin(), links.end());
+
+      if (links.size() == 2U) {
+        next_node_id = prev_node_id;
+      } else {
+        util::warning(std::format("Link from node {} to node {} failed", prev_node_id, next_node_id));
+      }
+    }
+  }
+
+  const auto links = pm->link_nodes(pm->ee_sink_node.id, next_node_id);
+
+  proxies.insert(proxies.end(), links.begin(), links.end());
+
+  if (links.size() < 2U) {
+    util::warning(std::format("Link from easyeffecst sink {} to node {} failed", pm->ee_sink_node.id, next_node_id));
+  }
+
+  return proxies;
+}
+
+void StreamOutputEffects::on_plugins_changed() {
+  abort_latency_measurement();
+
+  if (DbMain::bypass()) {
+    DbMain::setBypass(false);
+  }
+
+  if (!bypass && !bypass_transition_active && crossfade_chain(DbStreamOutputs::plugins())) {
+    return;
+  }
+
+  set_bypass(false);
+}
+
 void StreamOutputEffects::disconnect_filters() {
+  abort_chain_crossfade();
+
+  abort_latency_measurement();
+
   std::set<uint> link_id_list;
 
   const auto selected_plugins_list = (bypass) ? QStringList() : DbStreamOutputs::plugins();
@@ -418,9 +465,12 @@ void StreamOutputEffects::disconnect_filters() {
     plugin->clear_data();
   }
 
+  const auto fixed_nodes = {spectrum->get_node_id(), output_level->get_node_id(), chain_fader->get_node_id(),
+                            standby_fader->get_node_id(), dry_fader->get_node_id()};
+
   for (const auto& link : pm->get_links()) {
-    if (link.input_node_id == spectrum->get_node_id() || link.output_node_id == spectrum->get_node_id() ||
-        link.input_node_id == output_level->get_node_id() || link.output_node_id == output_level->get_node_id()) {
+    if (std::ranges::any_of(fixed_nodes,
+                            [&](const auto& id) { return link.input_node_id == id || link.output_node_id == id; })) {
       link_id_list.insert(link.id);
     }
   }
@@ -432,6 +482,8 @@ void StreamOutputEffects::disconnect_filters() {
   pm->destroy_links(list_proxies);
 
   list_proxies.clear();
+  chain_proxies.clear();
+  linked_plugins.clear();
 
   remove_unused_filters();
 
@@ -464,3 +516,121 @@ void StreamOutputEffects::set_bypass(const bool& state) {
 
   Q_EMIT pipelineChanged();
 }
+
+void StreamOutputEffects::measureLatency() {
+  if (measuringLatency) {
+    return;
+  }
+
+  latencyReport.clear();
+  measuredMagnitude.clear();
+  measuredPhase.clear();
+
+  measuredLatency = -1.0;
+
+  if (!filtersLinked) {
+    latencyReport.append(i18n("The output pipeline is not linked. Enable the test signals or play something first."));
+
+    Q_EMIT latencyMeasured();
+
+    return;
+  }
+
+  if (!latency_measurement) {
+    latency_measurement = std::make_unique<LatencyMeasurement>(pm, &TestSignals::self(pm));
+
+    connect(latency_measurement.get(), &LatencyMeasurement::finished, this,
+            &StreamOutputEffects::on_latency_measured);
+  }
+
+  // One tap point after each plugin and a last one at the end of the chain
+
+  std::vector<LatencyMeasurement::TapPoint> taps;
+
+  auto& names_model = tags::plugin_name::Model::self();
+
+  for (const auto& name : linked_plugins) {
+    if (plugins.contains(name) && plugins[name] != nullptr) {
+      taps.push_back({.name = names_model.translate(names_model.getBaseName(name)),
+                      .node_id = plugins[name]->get_node_id(),
+                      .reported_latency = plugins[name]->get_latency_seconds()});
+    }
+  }
+
+  taps.push_back({.name = i18n("Output"), .node_id = output_level->get_node_id(), .reported_latency = 0.0F});
+
+  if (!latency_measurement->start(taps)) {
+    return;
+  }
+
+  measuringLatency = true;
+
+  Q_EMIT measuringLatencyChanged();
+}
+
+void StreamOutputEffects::abort_latency_measurement() {
+  if (latency_measurement != nullptr && latency_measurement->running()) {
+    util::debug("The pipeline changed. Aborting the latency measurement.");
+
+    latency_measurement->abort();
+  }
+}
+
+void StreamOutputEffects::on_latency_measured(const bool& completed) {
+  measuringLatency = false;
+
+  Q_EMIT measuringLatencyChanged();
+
+  latencyReport.clear();
+
+  if (!completed) {
+    latencyReport.append(i18n("The measurement was interrupted"));
+
+    Q_EMIT latencyMeasured();
+
+    return;
+  }
+
+  /**
+   * The results have the total latency up to each tap point. What each plugin
+   * adds is the difference to the previous tap point.
+   */
+
+  const auto& results = latency_measurement->get_results();
+
+  float previous_measured = 0.0F;
+  float previous_reported = 0.0F;
+  bool previous_valid = true;
+
+  for (const auto& result : results) {
+    if (!result.valid) {
+      latencyReport.append(i18n("%1: the test signal did not reach this point", result.name));
+    } else if (previous_valid) {
+      const auto added = result.measured_latency - previous_measured;
+      const auto reported = result.reported_latency - previous_reported;
+
+      if (std::fabs(added - reported) > latency_tolerance) {
+        latencyReport.append(i18n("%1 reports %2 ms of latency but adds %3 ms", result.name,
+                                  QString::number(reported * 1000.0F, 'f', 2),
+                                  QString::number(added * 1000.0F, 'f', 2)));
+      }
+    }
+
+    previous_valid = result.valid;
+    previous_measured = result.measured_latency;
+    previous_reported = result.reported_latency;
+  }
+
+  if (results.back().valid) {
+    measuredLatency = results.back().measured_latency * 1000.0;
+
+    if (latencyReport.empty()) {
+      latencyReport.append(i18n("The latency reported by every plugin is correct"));
+    }
+  }
+
+  measuredMagnitude = latency_measurement->get_magnitude();
+  measuredPhase = latency_measurement->get_phase();
+
+  Q_EMIT latencyMeasured();
+}
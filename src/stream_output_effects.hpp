@@ -19,8 +19,18 @@
 
 #pragma once
 
+#include <pipewire/proxy.h>
+#include <qlist.h>
+#include <qpoint.h>
+#include <qtmetamacros.h>
 #include <QString>
+#include <QStringList>
+#include <map>
+#include <memory>
+#include <vector>
 #include "effects_base.hpp"
+#include "latency_measurement.hpp"
+#include "plugin_base.hpp"
 #include "pw_manager.hpp"
 #include "pw_objects.hpp"
 
@@ -29,6 +39,12 @@ class StreamOutputEffects : public EffectsBase {
   QML_ELEMENT
   QML_SINGLETON
 
+  Q_PROPERTY(bool measuringLatency MEMBER measuringLatency NOTIFY measuringLatencyChanged)
+  Q_PROPERTY(double measuredLatency MEMBER measuredLatency NOTIFY latencyMeasured)
+  Q_PROPERTY(QStringList latencyReport MEMBER latencyReport NOTIFY latencyMeasured)
+  Q_PROPERTY(QList<QPointF> measuredMagnitude MEMBER measuredMagnitude NOTIFY latencyMeasured)
+  Q_PROPERTY(QList<QPointF> measuredPhase MEMBER measuredPhase NOTIFY latencyMeasured)
+
  public:
   StreamOutputEffects(pw::Manager* pipe_manager);
   StreamOutputEffects(const StreamOutputEffects&) = delete;
@@ -59,8 +75,31 @@ class StreamOutputEffects : public EffectsBase {
 
   void set_bypass(const bool& state);
 
+  /**
+   * Plays a sweep through the pipeline and captures it after each plugin. The
+   * measured latency, the plugins whose reported latency does not match what
+   * they add and the response of the whole chain are published when it ends.
+   */
+  Q_INVOKABLE void measureLatency();
+
+ Q_SIGNALS:
+  void measuringLatencyChanged();
+  void latencyMeasured();
+
  private:
   bool bypass = false;
+  bool measuringLatency = false;
+
+  double measuredLatency = -1.0;  // ms
+
+  QStringList latencyReport;
+
+  QList<QPointF> measuredMagnitude, measuredPhase;
+
+  std::unique_ptr<LatencyMeasurement> latency_measurement;
+
+  // Differences smaller than this are not reported
+  static constexpr float latency_tolerance = 0.0001F;  // seconds
   bool bypass_transition_active = false;
   bool bypass_transition_pending = false;
   bool pending_bypass_state = false;
@@ -69,6 +108,12 @@ class StreamOutputEffects : public EffectsBase {
 
   void disconnect_filters();
 
+  auto link_chain(const QStringList& list,
+                  const std::map<QString, PluginBase*>& instances,
+                  const uint& tail_node_id) -> std::vector<pw_proxy*> override;
+
+  void on_plugins_changed() override;
+
   auto apps_want_to_play() -> bool;
 
   void update_pipeline();
@@ -76,4 +121,8 @@ class StreamOutputEffects : public EffectsBase {
   void on_link_changed(pw::LinkInfo link_info);
 
   void on_link_removed();
+
+  void abort_latency_measurement();
+
+  void on_latency_measured(const bool& completed);
 };
@@ -43,4 +43,6 @@ inline constexpr auto get_property = "get_property";
 
 inline constexpr auto get_last_loaded_preset = "get_last_loaded_preset";
 
+inline constexpr auto render = "render";
+
 }  // namespace tags::local_server
@@ -54,3 +54,11 @@ namespace tags::pipewire::media_role {
 inline constexpr auto dsp = "DSP";
 
 }  // namespace tags::pipewire::media_role
+
+namespace tags::pipewire::data_loop {
+
+inline constexpr auto input = "easyeffects-input-loop";
+
+inline constexpr auto output = "easyeffects-output-loop";
+
+}  // namespace tags::pipewire::data_loop
@@ -28,10 +28,14 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <format>
 #include <numbers>
 #include <span>
 #include <thread>
+#include <utility>
+#include <vector>
 #include "db_manager.hpp"
 #include "pw_manager.hpp"
 #include "tags_app.hpp"
@@ -39,8 +43,6 @@
 
 namespace {
 
-constexpr auto pi_x_2 = 2.0F * std::numbers::pi_v<float>;
-
 void on_process(void* userdata, spa_io_position* position) {
   auto* d = static_cast<TestSignals::data*>(userdata);
 
@@ -55,7 +57,7 @@ void on_process(void* userdata, spa_io_position* position) {
     d->ts->rate = rate;
     d->ts->n_samples = n_samples;
 
-    d->ts->sine_phase = 0.0F;
+    d->ts->sine.reset();
   }
 
   // util::warning("Processing: " + util::to_string(n_samples));
@@ -70,47 +72,68 @@ void on_process(void* userdata, spa_io_position* position) {
   std::span left_out(out_left, n_samples);
   std::span right_out(out_right, n_samples);
 
-  const auto phase_delta = pi_x_2 * d->ts->sine_frequency / static_cast<float>(rate);
+  if (d->ts->sweep_requested.load(std::memory_order_acquire)) {
+    std::swap(d->ts->active_sweep, d->ts->pending_sweep);
+
+    d->ts->sweep_index = 0U;
 
-  for (uint n = 0U; n < n_samples; n++) {
-    float signal = 0.0F;
-    left_out[n] = 0.0F;
-    right_out[n] = 0.0F;
+    d->ts->sweep_start.store(position->clock.position, std::memory_order_relaxed);
 
-    switch (d->ts->signal_type) {
-      case TestSignalType::sine_wave: {
-        d->ts->sine_phase += phase_delta;
+    d->ts->sweep_requested.store(false, std::memory_order_release);
+  }
 
-        if (d->ts->sine_phase >= pi_x_2) {
-          d->ts->sine_phase -= pi_x_2;
-        }
+  if (d->ts->measurement_mode.load(std::memory_order_relaxed)) {
+    const auto& sweep = d->ts->active_sweep;
 
-        signal = 0.5F * std::sin(d->ts->sine_phase);
+    for (uint n = 0U; n < n_samples; n++) {
+      const auto signal = (d->ts->sweep_index < sweep.size()) ? sweep[d->ts->sweep_index++] : 0.0F;
 
-        break;
-      }
-      case TestSignalType::gaussian: {
-        signal = d->ts->white_noise();
+      left_out[n] = signal;
+      right_out[n] = signal;
+    }
 
-        break;
-      }
-      case TestSignalType::pink: {
-        signal = d->ts->pink_noise();
+    return;
+  }
 
-        break;
-      }
-      case TestSignalType::silence: {
-        break;
-      }
+  auto* ts = d->ts;
+
+  if (ts->reset_generators.exchange(false, std::memory_order_acquire)) {
+    ts->sine.reset();
+    ts->noise.reset();
+  }
+
+  switch (ts->signal_type) {
+    case TestSignalType::sine_wave: {
+      ts->sine.set_frequency(ts->sine_frequency, rate);
+      ts->sine.process(left_out, 0.5F);
+
+      break;
     }
+    case TestSignalType::gaussian: {
+      ts->noise.gaussian(left_out, 0.3F);
 
-    if (d->ts->create_left_channel) {
-      left_out[n] = signal;
+      break;
     }
+    case TestSignalType::pink: {
+      ts->noise.pink(left_out);
 
-    if (d->ts->create_right_channel) {
-      right_out[n] = signal;
+      break;
     }
+    case TestSignalType::silence: {
+      std::ranges::fill(left_out, 0.0F);
+
+      break;
+    }
+  }
+
+  if (ts->create_right_channel) {
+    std::ranges::copy(left_out, right_out.begin());
+  } else {
+    std::ranges::fill(right_out, 0.0F);
+  }
+
+  if (!ts->create_left_channel) {
+    std::ranges::fill(left_out, 0.0F);
   }
 }
 
@@ -156,7 +179,7 @@ const struct pw_filter_events filter_events = {.version = 0,
 
 }  // namespace
 
-TestSignals::TestSignals(pw::Manager* pipe_manager) : pm(pipe_manager), random_generator(rd()) {
+TestSignals::TestSignals(pw::Manager* pipe_manager) : pm(pipe_manager) {
   pf_data.ts = this;
 
   const auto* filter_name = "ee_test_signals";
@@ -260,8 +283,7 @@ TestSignals::~TestSignals() {
 }
 
 void TestSignals::set_state(const bool& state) {
-  sine_phase = 0.0F;
-  pink_b0 = pink_b1 = pink_b2 = 0.0F;
+  reset_generators.store(true, std::memory_order_release);
 
   if (state) {
     for (const auto& link : pm->link_nodes(node_id, pm->ee_sink_node.id, false)) {
@@ -277,13 +299,67 @@ void TestSignals::set_state(const bool& state) {
 void TestSignals::set_frequency(const float& value) {
   sine_frequency = value;
 
-  sine_phase = 0.0F;
+  reset_generators.store(true, std::memory_order_release);
 }
 
-auto TestSignals::white_noise() -> float {
-  const auto v = normal_distribution(random_generator);
+void TestSignals::set_measurement_mode(const bool& state) {
+  measurement_mode = state;
+
+  if (state) {
+    if (list_proxies.empty() && measurement_proxies.empty()) {
+      measurement_proxies = pm->link_nodes(node_id, pm->ee_sink_node.id, false);
+    }
+  } else {
+    pm->destroy_links(measurement_proxies);
 
-  return std::clamp(v, -1.0F, 1.0F);
+    measurement_proxies.clear();
+  }
+}
+
+auto TestSignals::start_sweep(const std::vector<float>& samples) -> bool {
+  if (sweep_requested.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  pending_sweep = samples;
+
+  sweep_start.store(invalid_position, std::memory_order_relaxed);
+
+  sweep_requested.store(true, std::memory_order_release);
+
+  return true;
+}
+
+auto TestSignals::get_sweep_start() const -> uint64_t {
+  return sweep_requested.load(std::memory_order_acquire) ? invalid_position
+                                                          : sweep_start.load(std::memory_order_relaxed);
+}
+
+auto TestSignals::log_sweep(const uint& rate, const float& duration, const float& f_start, const float& f_end)
+    -> std::vector<float> {
+  dsp::SweepOscillator oscillator;
+
+  oscillator.setup(rate, duration, f_start, f_end);
+
+  std::vector<float> samples(oscillator.length());
+
+  oscillator.process(samples, 0.5F);
+
+  // Short fades at both ends so the start and the end of the sweep do not add clicks
+
+  const auto n_frames = samples.size();
+
+  const auto n_fade = std::min(n_frames / 2U, static_cast<size_t>(0.01F * static_cast<float>(rate)));
+
+  for (size_t m = 0U; m < n_fade; m++) {
+    const auto gain = static_cast<float>(
+        0.5 * (1.0 - std::cos(std::numbers::pi * static_cast<double>(m) / static_cast<double>(n_fade))));
+
+    samples[m] *= gain;
+    samples[n_frames - 1U - m] *= gain;
+  }
+
+  return samples;
 }
 
 void TestSignals::set_channel(const int& value) {
@@ -307,17 +383,3 @@ void TestSignals::set_channel(const int& value) {
       break;
   }
 }
-
-auto TestSignals::pink_noise() -> float {
-  // reference: https://www.firstpr.com.au/dsp/pink-noise/
-
-  float white = white_noise();
-
-  pink_b0 = (0.99765F * pink_b0) + (white * 0.0990460F);
-  pink_b1 = (0.96300F * pink_b1) + (white * 0.2965164F);
-  pink_b2 = (0.57000F * pink_b2) + (white * 1.0526913F);
-
-  float pink = pink_b0 + pink_b1 + pink_b2 + (white * 0.1848F);
-
-  return std::clamp(pink * 0.05F, -1.0F, 1.0F);
-}
@@ -26,9 +26,13 @@
 #include <qtmetamacros.h>
 #include <spa/utils/hook.h>
 #include <sys/types.h>
-#include <random>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include "pw_manager.hpp"
+#include "signal_generators.hpp"
 
 enum class TestSignalType { sine_wave, gaussian, pink, silence };
 
@@ -75,13 +79,14 @@ class TestSignals : public QObject {
 
   bool can_get_node_id = false;
 
-  float sine_phase = 0.0F;
-
   float sine_frequency = 1000.0F;
 
-  float pink_b0 = 0.0F;
-  float pink_b1 = 0.0F;
-  float pink_b2 = 0.0F;
+  // Set by the main thread when the generators have to restart. Cleared by the realtime thread.
+  std::atomic<bool> reset_generators = false;
+
+  // Only used by the realtime thread
+  dsp::SineOscillator sine;
+  dsp::NoiseGenerator noise;
 
   TestSignalType signal_type = TestSignalType::sine_wave;
 
@@ -89,13 +94,40 @@ class TestSignals : public QObject {
 
   void set_frequency(const float& value);
 
-  [[nodiscard]] auto get_node_id() const -> uint;
+  /**
+   * While the measurement mode is on the regular signal is replaced by silence
+   * and the filter is linked to our sink even if the test signals are
+   * disabled. Only the sweeps given to start_sweep are played.
+   */
+  void set_measurement_mode(const bool& state);
 
-  void set_active(const bool& state) const;
+  // Returns false if the previous sweep was not started yet
+  auto start_sweep(const std::vector<float>& samples) -> bool;
+
+  // Clock position of the first sample of the last sweep
+  [[nodiscard]] auto get_sweep_start() const -> uint64_t;
+
+  static auto log_sweep(const uint& rate, const float& duration, const float& f_start, const float& f_end)
+      -> std::vector<float>;
+
+  static constexpr uint64_t invalid_position = std::numeric_limits<uint64_t>::max();
+
+  std::atomic<bool> measurement_mode = false;
+  std::atomic<bool> sweep_requested = false;
 
-  auto white_noise() -> float;
+  std::atomic<uint64_t> sweep_start = invalid_position;
 
-  auto pink_noise() -> float;
+  /**
+   * The main thread writes the next sweep to pending_sweep and sets
+   * sweep_requested. The realtime thread then swaps it with active_sweep.
+   */
+  std::vector<float> active_sweep, pending_sweep;
+
+  size_t sweep_index = 0U;
+
+  [[nodiscard]] auto get_node_id() const -> uint;
+
+  void set_active(const bool& state) const;
 
  private:
   pw::Manager* pm = nullptr;
@@ -106,13 +138,7 @@ class TestSignals : public QObject {
 
   uint node_id = 0U;
 
-  std::vector<pw_proxy*> list_proxies;
-
-  std::random_device rd;
-
-  std::mt19937 random_generator;
-
-  std::normal_distribution<float> normal_distribution{0.0F, 0.3F};
+  std::vector<pw_proxy*> list_proxies, measurement_proxies;
 
   void set_channel(const int& value);
 };
@@ -35,8 +35,10 @@
 #include "pipeline_type.hpp"
 #include "plugin_base.hpp"
 #include "pw_manager.hpp"
+#include "rt_log.hpp"
 #include "tags_plugin_name.hpp"
 #include "util.hpp"
+#include "worker_pool.hpp"
 
 VoiceSuppressor::VoiceSuppressor(const std::string& tag,
                                  pw::Manager* pipe_manager,
@@ -63,7 +65,7 @@ VoiceSuppressor::~VoiceSuppressor() {
     disconnect_from_pw();
   }
 
-  settings->disconnect();
+  settings->disconnect(this);
 
   free_fftw();
 
@@ -88,8 +90,7 @@ void VoiceSuppressor::setup() {
 
   ready = false;
 
-  // NOLINTBEGIN(clang-analyzer-cplusplus.NewDeleteLeaks)
-  QMetaObject::invokeMethod(
+  WorkerPool::post(
       baseWorker,
       [this] {
         if (ready) {
@@ -155,8 +156,7 @@ void VoiceSuppressor::setup() {
 
         notify_latency = true;
       },
-      Qt::QueuedConnection);
-  // NOLINTEND(clang-analyzer-cplusplus.NewDeleteLeaks)
+      WorkerPool::Priority::high);
 }
 
 void VoiceSuppressor::process(std::span<float>& left_in,
@@ -176,16 +176,12 @@ void VoiceSuppressor::process(std::span<float>& left_in,
     std::ranges::copy(left_in, left_out.begin());
     std::ranges::copy(right_in, right_out.begin());
 
-    if (output_gain != 1.0F) {
-      apply_gain(left_out, right_out, output_gain);
-    }
+    apply_gain(left_out, right_out, output_gain);
 
     return;
   }
 
-  if (input_gain != 1.0F) {
-    apply_gain(left_in, right_in, input_gain);
-  }
+  apply_input_gain(left_in, right_in);
 
   buf_in_L.insert(buf_in_L.end(), left_in.begin(), left_in.end());
   buf_in_R.insert(buf_in_R.end(), right_in.begin(), right_in.end());
@@ -321,14 +317,12 @@ void VoiceSuppressor::process(std::span<float>& left_in,
     util::copy_bulk(buf_out_R, right_out);
   }
 
-  if (output_gain != 1.0F) {
-    apply_gain(left_out, right_out, output_gain);
-  }
+  apply_gain(left_out, right_out, output_gain);
 
   if (notify_latency) {
     latency_value = static_cast<float>(hop) / static_cast<float>(rate);
 
-    util::debug(std::format("{}{} latency: {} s", log_tag, name.toStdString(), latency_value));
+    util::rt_debug("{}{} latency: {} s", log_tag, log_name, latency_value);
 
     update_filter_params();
 
@@ -0,0 +1,255 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "worker_pool.hpp"
+#include <qcoreapplication.h>
+#include <qcoreevent.h>
+#include <qnamespace.h>
+#include <qobject.h>
+#include <qobjectdefs.h>
+#include <qthread.h>
+#include <sys/types.h>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "util.hpp"
+
+namespace {
+
+const auto job_event_type = static_cast<QEvent::Type>(QEvent::registerEventType());
+
+class JobEvent : public QEvent {
+ public:
+  explicit JobEvent(std::function<void()> job) : QEvent(job_event_type), job(std::move(job)) {}
+
+  std::function<void()> job;
+};
+
+auto to_qt_priority(const WorkerPool::Priority& priority) -> int {
+  switch (priority) {
+    case WorkerPool::Priority::low:
+      return Qt::LowEventPriority;
+    case WorkerPool::Priority::normal:
+      return Qt::NormalEventPriority;
+    case WorkerPool::Priority::high:
+      return Qt::HighEventPriority;
+  }
+
+  return Qt::NormalEventPriority;
+}
+
+}  // namespace
+
+auto WorkerContext::event(QEvent* event) -> bool {
+  if (event->type() == job_event_type) {
+    if (auto& job = static_cast<JobEvent*>(event)->job; job) {
+      job();
+    }
+
+    pending_jobs--;
+
+    return true;
+  }
+
+  return QObject::event(event);
+}
+
+auto WorkerContext::has_pending_jobs() const -> bool {
+  return pending_jobs.load() != 0U;
+}
+
+WorkerPool::WorkerPool() {
+  /**
+   * Most of the work done in these threads is the occasional reinitialization
+   * of a plugin. A couple of threads is enough and having more than a few
+   * would just bring back the cost of one thread per plugin.
+   */
+
+  const auto n_short = std::clamp(std::thread::hardware_concurrency() / 2U, 2U, 4U);
+  const auto n_long = std::clamp(std::thread::hardware_concurrency() / 4U, 1U, 2U);
+
+  lanes.resize(n_short + n_long);
+
+  for (uint n = 0U; n < lanes.size(); n++) {
+    auto& lane = lanes[n];
+
+    lane.thread = std::make_unique<QThread>();
+    lane.dispatcher = new QObject;
+    lane.load = (n < n_short) ? Load::short_jobs : Load::long_jobs;
+
+    lane.thread->setObjectName(
+        QString::fromStdString(std::format("{}_{}", (n < n_short) ? "ee_worker" : "ee_loader", n)));
+
+    lane.dispatcher->moveToThread(lane.thread.get());
+
+    lane.thread->start();
+  }
+
+  util::debug(std::format("worker pool: started {} worker and {} loader threads", n_short, n_long));
+}
+
+WorkerPool::~WorkerPool() {
+  shutdown();
+}
+
+void WorkerPool::shutdown() {
+  std::scoped_lock<std::mutex> lock(lanes_mutex);
+
+  if (stopped) {
+    return;
+  }
+
+  stopped = true;
+
+  for (auto& lane : lanes) {
+    lane.thread->quit();
+    lane.thread->wait();
+
+    delete lane.dispatcher;
+
+    lane.dispatcher = nullptr;
+
+    lane.thread.reset();
+  }
+
+  lanes.clear();
+
+  util::debug("worker pool: stopped");
+}
+
+auto WorkerPool::find_lane(QThread* thread) -> Lane* {
+  auto it = std::ranges::find_if(lanes, [&](const auto& lane) { return lane.thread.get() == thread; });
+
+  return (it != lanes.end()) ? &(*it) : nullptr;
+}
+
+auto WorkerPool::acquire_thread(const Load& load) -> QThread* {
+  std::scoped_lock<std::mutex> lock(lanes_mutex);
+
+  if (stopped) {
+    return nullptr;
+  }
+
+  // Lanes of the requested kind are compared first so the least used one of that kind is chosen
+
+  auto it = std::ranges::min_element(lanes, [&](const auto& a, const auto& b) {
+    return std::pair(a.load != load, a.users) < std::pair(b.load != load, b.users);
+  });
+
+  it->users++;
+
+  return it->thread.get();
+}
+
+void WorkerPool::release_thread(QThread* thread) {
+  std::scoped_lock<std::mutex> lock(lanes_mutex);
+
+  if (auto* lane = find_lane(thread); lane != nullptr && lane->users > 0U) {
+    lane->users--;
+  }
+}
+
+void WorkerPool::post(WorkerContext* context, std::function<void()> job, const Priority& priority) {
+  if (context == nullptr) {
+    return;
+  }
+
+  context->pending_jobs++;
+
+  QCoreApplication::postEvent(context, new JobEvent(std::move(job)), to_qt_priority(priority));
+}
+
+void WorkerPool::destroy_context(WorkerContext* context) {
+  if (context == nullptr) {
+    return;
+  }
+
+  QCoreApplication::removePostedEvents(context);
+
+  {
+    std::scoped_lock<std::mutex> lock(self().lanes_mutex);
+
+    // After the shutdown no lane thread is left that could be running a job of this context
+
+    if (self().stopped) {
+      delete context;
+
+      return;
+    }
+  }
+
+  auto* thread = context->thread();
+
+  if (thread == QThread::currentThread() || !thread->isRunning()) {
+    delete context;
+
+    return;
+  }
+
+  QObject* dispatcher = nullptr;
+
+  {
+    std::scoped_lock<std::mutex> lock(self().lanes_mutex);
+
+    if (auto* lane = self().find_lane(thread); lane != nullptr) {
+      dispatcher = lane->dispatcher;
+    }
+  }
+
+  if (dispatcher == nullptr) {
+    context->deleteLater();
+
+    return;
+  }
+
+  // Waits for the job being executed by this context to finish before deleting it
+
+  QMetaObject::invokeMethod(dispatcher, [context] { delete context; }, Qt::BlockingQueuedConnection);
+}
+
+void WorkerPool::wait_for_pending_jobs(WorkerContext* context) {
+  if (context == nullptr || context->thread() == QThread::currentThread()) {
+    return;
+  }
+
+  {
+    std::scoped_lock<std::mutex> lock(self().lanes_mutex);
+
+    if (self().stopped) {
+      return;
+    }
+  }
+
+  std::promise<void> done;
+
+  auto future = done.get_future();
+
+  // Low priority jobs are dispatched after everything that was already queued
+
+  post(context, [&done] { done.set_value(); }, Priority::low);
+
+  future.wait();
+}
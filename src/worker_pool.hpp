@@ -0,0 +1,113 @@
+/**
+ * Copyright © 2017-2026 Wellington Wallace
+ *
+ * This file is part of Easy Effects.
+ *
+ * Easy Effects is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Easy Effects is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Easy Effects. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <qcoreevent.h>
+#include <qobject.h>
+#include <qthread.h>
+#include <qtmetamacros.h>
+#include <sys/types.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Base class for the worker objects that live in one of the WorkerPool
+ * threads. Jobs posted to them are executed in that thread. Jobs that are still
+ * pending when the object is destroyed through WorkerPool::destroy_context are
+ * discarded.
+ */
+class WorkerContext : public QObject {
+  Q_OBJECT
+
+ public:
+  auto event(QEvent* event) -> bool override;
+
+  // Whether jobs posted to this context are waiting or being executed.
+  [[nodiscard]] auto has_pending_jobs() const -> bool;
+
+ private:
+  friend class WorkerPool;
+
+  std::atomic<uint> pending_jobs = 0U;
+};
+
+/**
+ * A small and bounded set of threads shared by all plugins and pipelines. Each
+ * worker context stays in the thread it was assigned to for its whole life.
+ * This keeps the guarantee needed by fftw and zita: the thread that creates a
+ * plan is the one that destroys it. Contexts that read large files, like the
+ * convolver kernels and SOFA databases, use separate lanes so they can not
+ * delay the setup jobs of the other plugins.
+ */
+class WorkerPool {
+ public:
+  WorkerPool(const WorkerPool&) = delete;
+  auto operator=(const WorkerPool&) -> WorkerPool& = delete;
+  WorkerPool(const WorkerPool&&) = delete;
+  auto operator=(const WorkerPool&&) -> WorkerPool& = delete;
+  ~WorkerPool();
+
+  enum class Priority { low, normal, high };
+
+  enum class Load { short_jobs, long_jobs };
+
+  static auto self() -> WorkerPool& {
+    static WorkerPool wp;
+    return wp;
+  }
+
+  auto acquire_thread(const Load& load = Load::short_jobs) -> QThread*;
+
+  void release_thread(QThread* thread);
+
+  // Stops and joins the threads. It has to be called before the application object is destroyed.
+  void shutdown();
+
+  static void post(WorkerContext* context, std::function<void()> job, const Priority& priority = Priority::normal);
+
+  static void destroy_context(WorkerContext* context);
+
+  // Blocks until the jobs posted to the context so far were executed.
+  static void wait_for_pending_jobs(WorkerContext* context);
+
+ private:
+  WorkerPool();
+
+  struct Lane {
+    std::unique_ptr<QThread> thread;
+
+    QObject* dispatcher = nullptr;
+
+    Load load = Load::short_jobs;
+
+    uint users = 0U;
+  };
+
+  std::mutex lanes_mutex;
+
+  bool stopped = false;
+
+  std::vector<Lane> lanes;
+
+  auto find_lane(QThread* thread) -> Lane*;
+};